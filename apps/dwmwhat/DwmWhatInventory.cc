@@ -0,0 +1,186 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+
+//---------------------------------------------------------------------------
+//!  \file DwmWhatInventory.cc
+//!  \author Daniel W. McRobb
+//!  \brief DwmWhat::StringTable and DwmWhat::Inventory implementations
+//---------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstring>
+
+#include "DwmPkgInfo.hh"
+#include "DwmWhatInventory.hh"
+
+namespace DwmWhat {
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  StringTable::StringTable(uint32_t shardBits)
+      : _shardBits(shardBits), _shardMask((1U << shardBits) - 1),
+        _shards(new Shard[1U << shardBits])
+  {}
+  
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  std::string_view StringTable::Copy(Shard & shard, std::string_view s)
+  {
+    //  A new shard has no blocks yet, so there's nowhere to point an
+    //  empty string.
+    if (s.empty()) {
+      return std::string_view();
+    }
+    char  *p;
+    if (s.size() > (k_blockSize / 4)) {
+      //  Big strings get their own block so we don't waste the tail of
+      //  the current one.
+      shard.blocks.emplace_back(new char[s.size()]);
+      p = shard.blocks.back().get();
+      shard.arenaBytes += s.size();
+    }
+    else {
+      if ((k_blockSize - shard.blockUsed) < s.size()) {
+        shard.blocks.emplace_back(new char[k_blockSize]);
+        shard.blockUsed = 0;
+        shard.arenaBytes += k_blockSize;
+      }
+      p = shard.blocks.back().get() + shard.blockUsed;
+      shard.blockUsed += s.size();
+    }
+    memcpy(p, s.data(), s.size());
+    return std::string_view(p, s.size());
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  uint32_t StringTable::Intern(std::string_view s)
+  {
+    //  The index hashes with the low bits, so use the high bits here.
+    uint64_t  hash = Dwm::Pkg::InfoHash(s);
+    uint32_t  shardIdx = (hash >> 32) & _shardMask;
+    Shard   & shard = _shards[shardIdx];
+    std::lock_guard<std::mutex>  lck(shard.mtx);
+    auto  [it, end] = shard.index.equal_range(hash);
+    for ( ; it != end; ++it) {
+      if (shard.strings[it->second >> _shardBits] == s) {
+        return it->second;
+      }
+    }
+    uint32_t  id = (shard.strings.size() << _shardBits) | shardIdx;
+    shard.strings.push_back(Copy(shard, s));
+    shard.index.emplace(hash, id);
+    return id;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  std::string_view StringTable::Get(uint32_t id) const
+  {
+    const Shard & shard = _shards[id & _shardMask];
+    std::lock_guard<std::mutex>  lck(shard.mtx);
+    return shard.strings[id >> _shardBits];
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  size_t StringTable::Size() const
+  {
+    size_t  rc = 0;
+    for (uint32_t i = 0; i <= _shardMask; ++i) {
+      std::lock_guard<std::mutex>  lck(_shards[i].mtx);
+      rc += _shards[i].strings.size();
+    }
+    return rc;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  size_t StringTable::ArenaBytes() const
+  {
+    size_t  rc = 0;
+    for (uint32_t i = 0; i <= _shardMask; ++i) {
+      std::lock_guard<std::mutex>  lck(_shards[i].mtx);
+      rc += _shards[i].arenaBytes;
+    }
+    return rc;
+  }
+  
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  Inventory::Inventory(size_t numFiles)
+      : _strings(), _fileHits(numFiles)
+  {}
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  void Inventory::FinishFile(size_t fileIdx)
+  {
+    std::vector<uint32_t>  & ids = _fileHits[fileIdx];
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    ids.shrink_to_fit();
+    return;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  void Inventory::ForEachUnique(const std::function<void(std::string_view,
+                                                         const std::vector<uint32_t> &)> & fn) const
+  {
+    std::unordered_map<uint32_t,std::vector<uint32_t>>  inverted;
+    inverted.reserve(_strings.Size());
+    for (uint32_t fileIdx = 0; fileIdx < _fileHits.size(); ++fileIdx) {
+      for (auto id : _fileHits[fileIdx]) {
+        inverted[id].push_back(fileIdx);
+      }
+    }
+    for (const auto & entry : inverted) {
+      fn(_strings.Get(entry.first), entry.second);
+    }
+    return;
+  }
+  
+}  // namespace DwmWhat
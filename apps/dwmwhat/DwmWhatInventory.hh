@@ -0,0 +1,195 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+
+//---------------------------------------------------------------------------
+//!  \file DwmWhatInventory.hh
+//!  \author Daniel W. McRobb
+//!  \brief DwmWhat::StringTable and DwmWhat::Inventory class declarations
+//---------------------------------------------------------------------------
+
+#ifndef _DWMWHATINVENTORY_HH_
+#define _DWMWHATINVENTORY_HH_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace DwmWhat {
+
+  //--------------------------------------------------------------------------
+  //!  A sharded string interning table.  Each unique string is copied
+  //!  exactly once into an arena owned by the shard selected by the
+  //!  string's hash, so memory grows with the number of unique strings
+  //!  rather than the number of times we see them.  Each shard has its
+  //!  own mutex, so concurrent callers only contend when they land in
+  //!  the same shard.  The hash is Dwm::Pkg::InfoHash(), computed once
+  //!  per string for both the shard and the shard's index, and strings
+  //!  are only compared when their hashes match.
+  //!
+  //!  Ids are stable for the life of the table: the low bits hold the
+  //!  shard index and the high bits hold the index within the shard.
+  //--------------------------------------------------------------------------
+  class StringTable
+  {
+  public:
+    //------------------------------------------------------------------------
+    //!  Construct with 2^@c shardBits shards.
+    //------------------------------------------------------------------------
+    explicit StringTable(uint32_t shardBits = 6);
+
+    StringTable(const StringTable &) = delete;
+    StringTable & operator = (const StringTable &) = delete;
+    
+    //------------------------------------------------------------------------
+    //!  Interns @c s if it's not already present, and returns its id.
+    //!  Thread safe.
+    //------------------------------------------------------------------------
+    uint32_t Intern(std::string_view s);
+
+    //------------------------------------------------------------------------
+    //!  Returns the string with the given @c id.  The returned view
+    //!  remains valid for the life of the table.  Thread safe.
+    //------------------------------------------------------------------------
+    std::string_view Get(uint32_t id) const;
+
+    //------------------------------------------------------------------------
+    //!  Returns the number of unique strings in the table.
+    //------------------------------------------------------------------------
+    size_t Size() const;
+
+    //------------------------------------------------------------------------
+    //!  Returns the number of bytes held in the arenas.
+    //------------------------------------------------------------------------
+    size_t ArenaBytes() const;
+    
+  private:
+    static constexpr size_t  k_blockSize = 64 * 1024;
+    
+    struct Shard {
+      mutable std::mutex                              mtx;
+      std::unordered_multimap<uint64_t,uint32_t>     index;
+      std::vector<std::string_view>                   strings;
+      std::vector<std::unique_ptr<char[]>>            blocks;
+      size_t                                          blockUsed = k_blockSize;
+      size_t                                          arenaBytes = 0;
+    };
+
+    uint32_t                  _shardBits;
+    uint32_t                  _shardMask;
+    std::unique_ptr<Shard[]>  _shards;
+
+    static std::string_view Copy(Shard & shard, std::string_view s);
+  };
+  
+  //--------------------------------------------------------------------------
+  //!  Holds the found strings for a fixed list of files, with every
+  //!  string interned in a StringTable.  Each file is identified by its
+  //!  index in the list given to the constructor.  Add() may be called
+  //!  concurrently as long as no two callers use the same file index,
+  //!  which is the natural arrangement when worker threads pull file
+  //!  indices from a shared counter.
+  //--------------------------------------------------------------------------
+  class Inventory
+  {
+  public:
+    //------------------------------------------------------------------------
+    //!  Construct for @c numFiles files.
+    //------------------------------------------------------------------------
+    explicit Inventory(size_t numFiles);
+
+    //------------------------------------------------------------------------
+    //!  Records the found string @c hit for the file at index @c fileIdx.
+    //------------------------------------------------------------------------
+    void Add(size_t fileIdx, std::string_view hit)
+    { _fileHits[fileIdx].push_back(_strings.Intern(hit)); }
+
+    //------------------------------------------------------------------------
+    //!  Must be called when we're done adding strings for the file at
+    //!  index @c fileIdx.  Duplicate strings within a file are recorded
+    //!  once.
+    //------------------------------------------------------------------------
+    void FinishFile(size_t fileIdx);
+
+    //------------------------------------------------------------------------
+    //!  Gives the file at index @c toIdx the same strings as the file at
+    //!  index @c fromIdx, which must be finished.  For files we know to be
+    //!  identical without scanning them.
+    //------------------------------------------------------------------------
+    void CopyFile(size_t fromIdx, size_t toIdx)
+    { _fileHits[toIdx] = _fileHits[fromIdx]; }
+
+    //------------------------------------------------------------------------
+    //!  Returns the number of files.
+    //------------------------------------------------------------------------
+    size_t NumFiles() const
+    { return _fileHits.size(); }
+    
+    //------------------------------------------------------------------------
+    //!  Returns the ids of the strings found in the file at index
+    //!  @c fileIdx.
+    //------------------------------------------------------------------------
+    const std::vector<uint32_t> & FileHits(size_t fileIdx) const
+    { return _fileHits[fileIdx]; }
+
+    //------------------------------------------------------------------------
+    //!  Returns the interned strings.
+    //------------------------------------------------------------------------
+    const StringTable & Strings() const
+    { return _strings; }
+
+    //------------------------------------------------------------------------
+    //!  Builds the inverted index (unique string to list of file indices)
+    //!  and calls @c fn once for each unique string.  File indices are
+    //!  in ascending order.  Not thread safe with respect to Add().
+    //------------------------------------------------------------------------
+    void
+    ForEachUnique(const std::function<void(std::string_view,
+                                           const std::vector<uint32_t> &)>
+                  & fn) const;
+    
+  private:
+    StringTable                          _strings;
+    std::vector<std::vector<uint32_t>>   _fileHits;
+  };
+  
+}  // namespace DwmWhat
+
+#endif  // _DWMWHATINVENTORY_HH_
@@ -0,0 +1,337 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  \file DwmWhatJournal.cc
+//!  \author Daniel W. McRobb
+//!  \brief DwmWhat::Journal class implementation
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+}
+
+#include <cerrno>
+#include <cstring>
+#include <string_view>
+
+#include "DwmPkgInfo.hh"
+#include "DwmWhatJournal.hh"
+
+namespace DwmWhat {
+
+  static constexpr char      k_magic[8] = { 'D','W','M','W','J','R','N','L' };
+  static constexpr uint32_t  k_version = 1;
+  static constexpr uint32_t  k_byteOrder = 0x01020304;
+
+  //--------------------------------------------------------------------------
+  //!  Writes all @c len bytes at @c p to @c fd.  Returns false on error.
+  //--------------------------------------------------------------------------
+  static bool WriteAll(int fd, const char *p, size_t len)
+  {
+    while (len) {
+      ssize_t  rc = write(fd, p, len);
+      if (rc < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return false;
+      }
+      p += rc;
+      len -= rc;
+    }
+    return true;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  Appends the native bytes of @c val to @c buf.
+  //--------------------------------------------------------------------------
+  static void Append(std::string & buf, uint32_t val)
+  {
+    buf.append((const char *)&val, sizeof(val));
+    return;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  Reads a uint32_t from @c p if it's before @c end, and advances
+  //!  @c p.  Returns false if there's not enough room.
+  //--------------------------------------------------------------------------
+  static bool Read(const char * & p, const char *end, uint32_t & val)
+  {
+    if ((size_t)(end - p) < sizeof(val)) {
+      return false;
+    }
+    memcpy(&val, p, sizeof(val));
+    p += sizeof(val);
+    return true;
+  }
+  
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  Journal::Journal(Inventory & inventory, uint64_t key)
+      : _inventory(inventory), _key(key), _fd(-1), _ok(true),
+        _finished(inventory.NumFiles(), 0), _numFinished(0), _numResumed(0),
+        _cursor(0), _numRecords(0), _lastWrite(std::chrono::steady_clock::now())
+  {}
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  Journal::~Journal()
+  {
+    if (_fd >= 0) {
+      Flush();
+      close(_fd);
+    }
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  bool Journal::Open(const std::string & path, bool resume)
+  {
+    //  Resuming a journal that isn't there is an error (a mistyped
+    //  path, most likely), not a reason to quietly rescan everything.
+    int  fd = open(path.c_str(),
+                   O_RDWR|O_CLOEXEC|(resume ? 0 : (O_CREAT|O_TRUNC)), 0644);
+    if (fd < 0) {
+      return false;
+    }
+    struct stat  statbuf;
+    if (fstat(fd, &statbuf) != 0) {
+      close(fd);
+      return false;
+    }
+    bool  ok;
+    if (! resume) {
+      JournalHeader  hdr;
+      memcpy(hdr.magic, k_magic, sizeof(hdr.magic));
+      hdr.version = k_version;
+      hdr.byteOrder = k_byteOrder;
+      hdr.key = _key;
+      hdr.numFiles = _finished.size();
+      ok = WriteAll(fd, (const char *)&hdr, sizeof(hdr));
+    }
+    else {
+      ok = Load(fd, statbuf.st_size);
+    }
+    if (! ok) {
+      close(fd);
+      return false;
+    }
+    _fd = fd;
+    _lastWrite = std::chrono::steady_clock::now();
+    return true;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  Reads the journal of @c size bytes open on @c fd, adding the files
+  //!  in each intact chunk to our inventory.  Truncates anything after
+  //!  the last intact chunk and leaves @c fd positioned there.
+  //--------------------------------------------------------------------------
+  bool Journal::Load(int fd, size_t size)
+  {
+    if (size < sizeof(JournalHeader)) {
+      return false;
+    }
+    void  *map = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+      return false;
+    }
+    const char     *start = (const char *)map;
+    JournalHeader   hdr;
+    memcpy(&hdr, start, sizeof(hdr));
+    if ((memcmp(hdr.magic, k_magic, sizeof(k_magic)) != 0)
+        || (hdr.version != k_version) || (hdr.byteOrder != k_byteOrder)
+        || (hdr.key != _key) || (hdr.numFiles != _finished.size())) {
+      munmap(map, size);
+      return false;
+    }
+    
+    //  Check each chunk completely before using any of it.
+    auto  valid = [&] (const char *p, const char *end, uint32_t numRecords) {
+      uint32_t  fileIdx, numHits, len;
+      for (uint32_t r = 0; r < numRecords; ++r) {
+        if ((! Read(p, end, fileIdx)) || (fileIdx >= _finished.size())
+            || (! Read(p, end, numHits))) {
+          return false;
+        }
+        for (uint32_t h = 0; h < numHits; ++h) {
+          if ((! Read(p, end, len)) || ((size_t)(end - p) < len)) {
+            return false;
+          }
+          p += len;
+        }
+      }
+      return (p == end);
+    };
+    
+    size_t  offset = sizeof(hdr);
+    while ((size - offset) >= sizeof(JournalChunk)) {
+      JournalChunk  chunk;
+      memcpy(&chunk, start + offset, sizeof(chunk));
+      size_t  chunkSize = sizeof(chunk) + chunk.numBytes;
+      if ((size - offset) < chunkSize) {
+        break;
+      }
+      std::string_view  hashed(start + offset + sizeof(chunk.hash),
+                               chunkSize - sizeof(chunk.hash));
+      const char  *p = start + offset + sizeof(chunk);
+      const char  *end = p + chunk.numBytes;
+      if ((Dwm::Pkg::InfoHash(hashed) != chunk.hash)
+          || (! valid(p, end, chunk.numRecords))) {
+        break;
+      }
+      uint32_t  fileIdx = 0, numHits = 0, len = 0;
+      for (uint32_t r = 0; r < chunk.numRecords; ++r) {
+        Read(p, end, fileIdx);
+        Read(p, end, numHits);
+        bool  add = (! _finished[fileIdx]);
+        for (uint32_t h = 0; h < numHits; ++h) {
+          Read(p, end, len);
+          if (add) {
+            _inventory.Add(fileIdx, std::string_view(p, len));
+          }
+          p += len;
+        }
+        if (add) {
+          _inventory.FinishFile(fileIdx);
+          MarkFinished(fileIdx);
+          ++_numResumed;
+        }
+      }
+      offset += chunkSize;
+    }
+    munmap(map, size);
+
+    return ((offset == size) || (ftruncate(fd, offset) == 0))
+      && (lseek(fd, offset, SEEK_SET) == (off_t)offset);
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  void Journal::MarkFinished(uint32_t fileIdx)
+  {
+    if (! _finished[fileIdx]) {
+      _finished[fileIdx] = 1;
+      ++_numFinished;
+      while ((_cursor < _finished.size()) && _finished[_cursor]) {
+        ++_cursor;
+      }
+    }
+    return;
+  }
+  
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  void Journal::FinishFile(uint32_t fileIdx)
+  {
+    std::lock_guard<std::mutex>  lck(_mtx);
+    if (_finished[fileIdx]) {
+      return;
+    }
+    MarkFinished(fileIdx);
+    if (_fd >= 0) {
+      if (_buf.empty()) {
+        _buf.resize(sizeof(JournalChunk));
+      }
+      const auto  & hits = _inventory.FileHits(fileIdx);
+      Append(_buf, fileIdx);
+      Append(_buf, hits.size());
+      for (auto id : hits) {
+        std::string_view  hit = _inventory.Strings().Get(id);
+        Append(_buf, hit.size());
+        _buf.append(hit);
+      }
+      ++_numRecords;
+      if ((_buf.size() >= k_flushBytes)
+          || ((std::chrono::steady_clock::now() - _lastWrite)
+              >= k_flushInterval)) {
+        WriteChunk();
+      }
+    }
+    return;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  Appends our buffered records as a chunk.  If the write fails, we
+  //!  stop journaling and Flush() will return false.
+  //--------------------------------------------------------------------------
+  void Journal::WriteChunk()
+  {
+    JournalChunk  chunk;
+    chunk.hash = 0;
+    chunk.numBytes = _buf.size() - sizeof(chunk);
+    chunk.numRecords = _numRecords;
+    chunk.cursor = _cursor;
+    memcpy(_buf.data(), &chunk, sizeof(chunk));
+    chunk.hash =
+      Dwm::Pkg::InfoHash(std::string_view(_buf).substr(sizeof(chunk.hash)));
+    memcpy(_buf.data(), &chunk.hash, sizeof(chunk.hash));
+    if (! WriteAll(_fd, _buf.data(), _buf.size())) {
+      close(_fd);
+      _fd = -1;
+      _ok = false;
+    }
+    _buf.clear();
+    _numRecords = 0;
+    _lastWrite = std::chrono::steady_clock::now();
+    return;
+  }
+  
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  bool Journal::Flush()
+  {
+    std::lock_guard<std::mutex>  lck(_mtx);
+    if (_fd >= 0) {
+      if (_numRecords) {
+        WriteChunk();
+      }
+      if ((_fd >= 0) && (fdatasync(_fd) != 0)) {
+        _ok = false;
+      }
+    }
+    return _ok;
+  }
+  
+}  // namespace DwmWhat
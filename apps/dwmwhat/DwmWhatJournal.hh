@@ -0,0 +1,184 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  \file DwmWhatJournal.hh
+//!  \author Daniel W. McRobb
+//!  \brief DwmWhat::Journal class declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMWHATJOURNAL_HH_
+#define _DWMWHATJOURNAL_HH_
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "DwmWhatInventory.hh"
+
+namespace DwmWhat {
+
+  //--------------------------------------------------------------------------
+  //!  Layout of a checkpoint journal.  Everything is native byte order.
+  //!
+  //!    JournalHeader
+  //!    chunks, each a JournalChunk followed by numBytes of records:
+  //!      uint32_t fileIdx, uint32_t numHits, then numHits of
+  //!      (uint32_t length, char[length])
+  //!
+  //!  A chunk's hash is Dwm::Pkg::InfoHash() of everything in the chunk
+  //!  after the hash itself, so a chunk torn by a crash is recognized
+  //!  and dropped along with anything after it.
+  //--------------------------------------------------------------------------
+  struct JournalHeader {
+    char      magic[8];
+    uint32_t  version;
+    uint32_t  byteOrder;
+    uint64_t  key;
+    uint64_t  numFiles;
+  };
+
+  struct JournalChunk {
+    uint64_t  hash;
+    uint32_t  numBytes;
+    uint32_t  numRecords;
+    uint64_t  cursor;
+  };
+  
+  //--------------------------------------------------------------------------
+  //!  Tracks which files of an Inventory are finished and, if opened,
+  //!  appends them with their strings to a checkpoint journal so an
+  //!  interrupted scan can be resumed.  Records are buffered and
+  //!  appended as one chunk every second or so, along with the cursor
+  //!  (every file below it is finished).  Chunks are written with
+  //!  write(2) and not synced until Flush(), so a journal survives the
+  //!  process being killed but may lose its last chunks if the host
+  //!  crashes.  Losing a chunk only means rescanning its files.
+  //!
+  //!  The journal's key should identify the file list and anything else
+  //!  that changes what's found in a file (filters, for example), so a
+  //!  journal isn't resumed by a different scan.
+  //--------------------------------------------------------------------------
+  class Journal
+  {
+  public:
+    //------------------------------------------------------------------------
+    //!  Construct for @c inventory, with the given @c key.
+    //------------------------------------------------------------------------
+    Journal(Inventory & inventory, uint64_t key);
+
+    //------------------------------------------------------------------------
+    //!  Flushes and closes the journal.
+    //------------------------------------------------------------------------
+    ~Journal();
+
+    Journal(const Journal &) = delete;
+    Journal & operator = (const Journal &) = delete;
+    
+    //------------------------------------------------------------------------
+    //!  Opens the journal at @c path.  If @c resume is true, the files
+    //!  recorded in the journal are added to the inventory and marked
+    //!  finished, and new chunks are appended after its last intact
+    //!  chunk.  Otherwise a new journal is started.  Returns false on
+    //!  error, including resuming a journal that doesn't exist or has a
+    //!  different key or number of files.
+    //------------------------------------------------------------------------
+    bool Open(const std::string & path, bool resume);
+
+    //------------------------------------------------------------------------
+    //!  Marks the file at index @c fileIdx finished and, if we're open,
+    //!  records its strings (which must already be finished in the
+    //!  inventory).  Thread safe.
+    //------------------------------------------------------------------------
+    void FinishFile(uint32_t fileIdx);
+
+    //------------------------------------------------------------------------
+    //!  Appends any buffered records and syncs the journal.  Returns
+    //!  false on error.
+    //------------------------------------------------------------------------
+    bool Flush();
+
+    //------------------------------------------------------------------------
+    //!  Returns true if the file at index @c fileIdx is finished.
+    //------------------------------------------------------------------------
+    bool IsFinished(uint32_t fileIdx) const
+    { return _finished[fileIdx]; }
+
+    //------------------------------------------------------------------------
+    //!  Returns the number of finished files.
+    //------------------------------------------------------------------------
+    size_t NumFinished() const
+    { return _numFinished; }
+
+    //------------------------------------------------------------------------
+    //!  Returns the number of finished files read from the journal by
+    //!  Open().
+    //------------------------------------------------------------------------
+    size_t NumResumed() const
+    { return _numResumed; }
+
+    //------------------------------------------------------------------------
+    //!  Returns the index of the first file that isn't finished.
+    //------------------------------------------------------------------------
+    uint32_t Cursor() const
+    { return _cursor; }
+    
+  private:
+    static constexpr size_t  k_flushBytes = 1024 * 1024;
+    static constexpr std::chrono::seconds  k_flushInterval{1};
+    
+    Inventory                               & _inventory;
+    uint64_t                                  _key;
+    int                                       _fd;
+    bool                                      _ok;
+    std::mutex                                _mtx;
+    std::vector<uint8_t>                      _finished;
+    size_t                                    _numFinished;
+    size_t                                    _numResumed;
+    uint32_t                                  _cursor;
+    std::string                               _buf;
+    uint32_t                                  _numRecords;
+    std::chrono::steady_clock::time_point     _lastWrite;
+    
+    bool Load(int fd, size_t size);
+    void MarkFinished(uint32_t fileIdx);
+    void WriteChunk();
+  };
+  
+}  // namespace DwmWhat
+
+#endif  // _DWMWHATJOURNAL_HH_
@@ -0,0 +1,583 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+
+//---------------------------------------------------------------------------
+//!  \file DwmWhatServer.cc
+//!  \author Daniel W. McRobb
+//!  \brief DwmWhat::Server and DwmWhat::Client class implementations
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <sys/socket.h>
+  #include <sys/stat.h>
+  #include <sys/un.h>
+  #include <errno.h>
+  #include <fcntl.h>
+  #include <limits.h>
+  #include <poll.h>
+  #include <signal.h>
+  #include <unistd.h>
+}
+
+#include <algorithm>
+#include <cstring>
+#include <set>
+#include <thread>
+
+#include "DwmWhatServer.hh"
+
+namespace DwmWhat {
+
+  static volatile sig_atomic_t  g_stopServer = 0;
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  static void StopServer(int)
+  {
+    g_stopServer = 1;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  static bool WriteAll(int fd, const std::string & s)
+  {
+    size_t  written = 0;
+    while (written < s.size()) {
+      ssize_t  rc = send(fd, s.data() + written, s.size() - written,
+                         MSG_NOSIGNAL);
+      if (rc < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return false;
+      }
+      written += rc;
+    }
+    return true;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  Reads a line (without the newline) from @c fd into @c line, using
+  //!  @c buf to hold anything read past the end of the line.
+  //--------------------------------------------------------------------------
+  static bool ReadLine(int fd, std::string & buf, std::string & line)
+  {
+    for (;;) {
+      auto  nl = buf.find('\n');
+      if (nl != std::string::npos) {
+        line.assign(buf, 0, nl);
+        buf.erase(0, nl + 1);
+        return true;
+      }
+      char     chunk[4096];
+      ssize_t  rc = read(fd, chunk, sizeof(chunk));
+      if (rc < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return false;
+      }
+      if (rc == 0) {
+        return false;
+      }
+      buf.append(chunk, rc);
+    }
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  static bool SetSockAddr(const std::string & path, struct sockaddr_un & sun)
+  {
+    memset(&sun, 0, sizeof(sun));
+    sun.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(sun.sun_path)) {
+      return false;
+    }
+    memcpy(sun.sun_path, path.c_str(), path.size());
+    return true;
+  }
+  
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  size_t Server::FileIdHash::operator () (const FileId & id) const noexcept
+  {
+    size_t  h = std::hash<uint64_t>()(id.ino);
+    h ^= std::hash<uint64_t>()(id.dev) + 0x9e3779b97f4a7c15ULL
+      + (h << 6) + (h >> 2);
+    h ^= std::hash<int64_t>()(id.mtimeNsecs) + 0x9e3779b97f4a7c15ULL
+      + (h << 6) + (h >> 2);
+    h ^= std::hash<int64_t>()(id.size) + 0x9e3779b97f4a7c15ULL
+      + (h << 6) + (h >> 2);
+    return h;
+  }
+  
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  Server::Server(const std::string & socketPath, unsigned int numWorkers,
+                 size_t maxCacheEntries)
+      : _socketPath(socketPath), _numWorkers(std::max(1U, numWorkers)),
+        _maxCacheEntries(std::max<size_t>(1, maxCacheEntries)),
+        _listenFd(-1), _wakeFds{-1, -1}, _stop(false),
+        _scanner(Dwm::Pkg::ScanFilter(), false), _done(false)
+  {}
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  Server::~Server()
+  {
+    if (_listenFd >= 0) {
+      close(_listenFd);
+      unlink(_socketPath.c_str());
+    }
+    for (auto fd : _wakeFds) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  bool Server::Listen()
+  {
+    struct sockaddr_un  sun;
+    if (! SetSockAddr(_socketPath, sun)) {
+      return false;
+    }
+    if (pipe2(_wakeFds, O_NONBLOCK|O_CLOEXEC) != 0) {
+      return false;
+    }
+    _listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (_listenFd < 0) {
+      return false;
+    }
+    //  Remove a stale socket from a previous run.
+    struct stat  statbuf;
+    if ((lstat(_socketPath.c_str(), &statbuf) == 0)
+        && S_ISSOCK(statbuf.st_mode)) {
+      unlink(_socketPath.c_str());
+    }
+    if ((bind(_listenFd, (struct sockaddr *)&sun, sizeof(sun)) != 0)
+        || (listen(_listenFd, 128) != 0)) {
+      close(_listenFd);
+      _listenFd = -1;
+      return false;
+    }
+    return true;
+  }
+  
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  bool Server::Run()
+  {
+    if (! Listen()) {
+      return false;
+    }
+    struct sigaction  sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = StopServer;
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+    
+    std::vector<std::thread>  workers;
+    for (unsigned int i = 0; i < _numWorkers; ++i) {
+      workers.emplace_back(&Server::Worker, this);
+    }
+
+    std::vector<struct pollfd>  pfds;
+    while ((! g_stopServer) && (! _stop)) {
+      //  Connections with a request in flight aren't polled, so we
+      //  don't read their next request until the worker is done.
+      pfds.clear();
+      pfds.push_back({ _listenFd, POLLIN, 0 });
+      pfds.push_back({ _wakeFds[0], POLLIN, 0 });
+      for (const auto & conn : _conns) {
+        if (! conn.second.busy) {
+          pfds.push_back({ conn.first, POLLIN, 0 });
+        }
+      }
+      if (poll(pfds.data(), pfds.size(), 250) <= 0) {
+        continue;
+      }
+      //  Client reads first, then finished requests, then accept(), so
+      //  a descriptor we close can't be reused before we're done with
+      //  this poll's events.
+      for (size_t i = 2; i < pfds.size(); ++i) {
+        if (pfds[i].revents) {
+          ReadClient(pfds[i].fd);
+        }
+      }
+      if (pfds[1].revents) {
+        FinishRequests();
+      }
+      if (pfds[0].revents & POLLIN) {
+        AcceptClient();
+      }
+    }
+
+    {
+      std::lock_guard<std::mutex>  lck(_queueMtx);
+      _done = true;
+      _queueCv.notify_all();
+    }
+    for (auto & worker : workers) {
+      worker.join();
+    }
+    _queue.clear();
+    _finished.clear();
+    for (const auto & conn : _conns) {
+      close(conn.first);
+    }
+    _conns.clear();
+    return true;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  void Server::Stop()
+  {
+    _stop = true;
+    Wake();
+    return;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  Wakes the poll() in Run().
+  //--------------------------------------------------------------------------
+  void Server::Wake()
+  {
+    char  c = 0;
+    if (_wakeFds[1] >= 0) {
+      [[maybe_unused]] ssize_t  rc = write(_wakeFds[1], &c, 1);
+    }
+    return;
+  }
+  
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  void Server::AcceptClient()
+  {
+    int  fd = accept4(_listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd >= 0) {
+      //  Workers write replies with blocking sends.  Don't let a client
+      //  that stops reading hold a worker forever.
+      struct timeval  tv = { 5, 0 };
+      setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+      _conns[fd] = Connection();
+    }
+    return;
+  }
+  
+  //--------------------------------------------------------------------------
+  //!  Reads what's available from the (idle) client on @c fd and
+  //!  dispatches a request if we now have a complete line.
+  //--------------------------------------------------------------------------
+  void Server::ReadClient(int fd)
+  {
+    auto  it = _conns.find(fd);
+    if (it == _conns.end()) {
+      return;
+    }
+    char     chunk[4096];
+    ssize_t  rc = read(fd, chunk, sizeof(chunk));
+    if (rc < 0) {
+      if ((errno != EINTR) && (errno != EAGAIN)) {
+        CloseClient(fd);
+      }
+      return;
+    }
+    if (rc == 0) {
+      CloseClient(fd);
+      return;
+    }
+    it->second.buf.append(chunk, rc);
+    Dispatch(fd, it->second);
+    return;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  If @c conn is idle and has a complete line buffered, queues it for
+  //!  a worker.  If it has more than PATH_MAX bytes buffered without a
+  //!  newline, replies with an error and closes it.
+  //--------------------------------------------------------------------------
+  void Server::Dispatch(int fd, Connection & conn)
+  {
+    if (conn.busy) {
+      return;
+    }
+    auto  nl = conn.buf.find('\n');
+    if (nl != std::string::npos) {
+      conn.busy = true;
+      std::lock_guard<std::mutex>  lck(_queueMtx);
+      _queue.push_back({fd, conn.buf.substr(0, nl)});
+      conn.buf.erase(0, nl + 1);
+      _queueCv.notify_one();
+    }
+    else if (conn.buf.size() > PATH_MAX) {
+      WriteAll(fd, "ERR line too long\n");
+      CloseClient(fd);
+    }
+    return;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  Marks the connections whose requests the workers have answered as
+  //!  idle again, closing those we failed to write to.
+  //--------------------------------------------------------------------------
+  void Server::FinishRequests()
+  {
+    char  drain[64];
+    while (read(_wakeFds[0], drain, sizeof(drain)) > 0) ;
+    
+    std::vector<std::pair<int,bool>>  finished;
+    {
+      std::lock_guard<std::mutex>  lck(_queueMtx);
+      finished.swap(_finished);
+    }
+    for (const auto & fin : finished) {
+      auto  it = _conns.find(fin.first);
+      if (it == _conns.end()) {
+        continue;
+      }
+      it->second.busy = false;
+      if (! fin.second) {
+        CloseClient(fin.first);
+      }
+      else {
+        //  The client may have pipelined more requests.
+        Dispatch(fin.first, it->second);
+      }
+    }
+    return;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  void Server::CloseClient(int fd)
+  {
+    _conns.erase(fd);
+    close(fd);
+    return;
+  }
+  
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  void Server::Worker()
+  {
+    std::string  response;
+    for (;;) {
+      Request  req;
+      {
+        std::unique_lock<std::mutex>  lck(_queueMtx);
+        _queueCv.wait(lck, [&] { return (_done || (! _queue.empty())); });
+        if (_done) {
+          break;
+        }
+        req = std::move(_queue.front());
+        _queue.pop_front();
+      }
+      ResultPtr  result = GetResult(req.path);
+      if (result->ok) {
+        response = "OK " + std::to_string(result->hits.size()) + '\n';
+        for (const auto & hit : result->hits) {
+          response += hit;
+          response += '\n';
+        }
+      }
+      else {
+        response = "ERR " + result->error + '\n';
+      }
+      bool  ok = WriteAll(req.fd, response);
+      {
+        std::lock_guard<std::mutex>  lck(_queueMtx);
+        _finished.emplace_back(req.fd, ok);
+      }
+      Wake();
+    }
+    return;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  Server::ResultPtr Server::GetResult(const std::string & path)
+  {
+    struct stat  statbuf;
+    if (stat(path.c_str(), &statbuf) != 0) {
+      return std::make_shared<Result>(Result{false, strerror(errno), {}});
+    }
+    FileId  id = { statbuf.st_dev, statbuf.st_ino, statbuf.st_size,
+                   ((int64_t)statbuf.st_mtim.tv_sec * 1000000000LL)
+                   + statbuf.st_mtim.tv_nsec };
+    
+    std::promise<ResultPtr>          promise;
+    std::shared_future<ResultPtr>    future;
+    {
+      std::lock_guard<std::mutex>  lck(_cacheMtx);
+      auto  it = _cache.find(id);
+      if (it != _cache.end()) {
+        return it->second;
+      }
+      auto  fit = _inFlight.find(id);
+      if (fit != _inFlight.end()) {
+        future = fit->second;
+      }
+      else {
+        _inFlight.emplace(id, promise.get_future().share());
+      }
+    }
+    if (future.valid()) {
+      //  Someone else is already scanning this file.
+      return future.get();
+    }
+    
+    ResultPtr  result = Scan(path);
+    promise.set_value(result);
+    std::lock_guard<std::mutex>  lck(_cacheMtx);
+    _inFlight.erase(id);
+    if (result->ok) {
+      if (_cache.size() >= _maxCacheEntries) {
+        _cache.erase(_cache.begin());
+      }
+      _cache.emplace(id, result);
+    }
+    return result;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  Server::ResultPtr Server::Scan(const std::string & path)
+  {
+    auto  result = std::make_shared<Result>();
+    std::set<std::string>  hits;
+    result->ok = _scanner.ScanFile(path, [&] (const Dwm::Pkg::ScanHit & hit) {
+      hits.emplace(hit.raw);
+      return true;
+    });
+    if (result->ok) {
+      result->hits.assign(hits.begin(), hits.end());
+    }
+    else {
+      result->error = strerror(errno);
+    }
+    return result;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  Client::Client()
+      : _fd(-1), _buf()
+  {}
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  Client::~Client()
+  {
+    if (_fd >= 0) {
+      close(_fd);
+    }
+  }
+  
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  bool Client::Connect(const std::string & socketPath)
+  {
+    struct sockaddr_un  sun;
+    if (! SetSockAddr(socketPath, sun)) {
+      return false;
+    }
+    _fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (_fd < 0) {
+      return false;
+    }
+    if (connect(_fd, (struct sockaddr *)&sun, sizeof(sun)) != 0) {
+      close(_fd);
+      _fd = -1;
+      return false;
+    }
+    return true;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  bool Client::Query(const std::string & path,
+                     std::vector<std::string> & hits, std::string & error)
+  {
+    hits.clear();
+    error.clear();
+    if (path.find('\n') != std::string::npos) {
+      error = "path contains a newline";
+      return false;
+    }
+    std::string  line;
+    if ((! WriteAll(_fd, path + '\n')) || (! ReadLine(_fd, _buf, line))) {
+      error = "lost connection to server";
+      return false;
+    }
+    if (line.compare(0, 3, "OK ") == 0) {
+      size_t  numHits = strtoul(line.c_str() + 3, nullptr, 10);
+      hits.reserve(numHits);
+      for (size_t i = 0; i < numHits; ++i) {
+        if (! ReadLine(_fd, _buf, line)) {
+          error = "lost connection to server";
+          return false;
+        }
+        hits.push_back(line);
+      }
+      return true;
+    }
+    error = (line.compare(0, 4, "ERR ") == 0) ? line.substr(4) : line;
+    return false;
+  }
+  
+}  // namespace DwmWhat
@@ -0,0 +1,213 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+
+//---------------------------------------------------------------------------
+//!  \file DwmWhatServer.hh
+//!  \author Daniel W. McRobb
+//!  \brief DwmWhat::Server and DwmWhat::Client class declarations
+//---------------------------------------------------------------------------
+
+#ifndef _DWMWHATSERVER_HH_
+#define _DWMWHATSERVER_HH_
+
+extern "C" {
+  #include <sys/types.h>
+}
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "DwmPkgScanner.hh"
+
+namespace DwmWhat {
+
+  //--------------------------------------------------------------------------
+  //!  The protocol is line oriented over a local (Unix domain) stream
+  //!  socket.  A client sends one path per line, and may send any number
+  //!  of paths on one connection.  For each path, the server replies
+  //!  with either
+  //!
+  //!    OK <n>\n
+  //!    <found string 1>\n
+  //!    ...
+  //!    <found string n>\n
+  //!
+  //!  or
+  //!
+  //!    ERR <message>\n
+  //!
+  //!  Found strings are raw (they start with "@(#)"), unique and sorted.
+  //!  They can't contain newlines since the scanner stops at newlines.
+  //!
+  //!  A line longer than PATH_MAX gets "ERR line too long" and the
+  //!  connection is closed.
+  //!
+  //!  Connections are multiplexed with poll(2) in the thread that
+  //!  accepts them, and each complete request line (not each
+  //!  connection) is handed to the worker pool, so idle clients don't
+  //!  tie up workers.  A connection has at most one request in flight,
+  //!  so its replies come back in order.
+  //!
+  //!  Results are cached by file identity (device, inode, size and
+  //!  modification time), so a warm query costs a stat() and a hash
+  //!  lookup.  Concurrent requests for the same file identity that
+  //!  arrive while it's being scanned wait for that one scan instead of
+  //!  starting their own.
+  //--------------------------------------------------------------------------
+  class Server
+  {
+  public:
+    //------------------------------------------------------------------------
+    //!  Construct to listen on @c socketPath with @c numWorkers worker
+    //!  threads, caching results for at most @c maxCacheEntries file
+    //!  identities.
+    //------------------------------------------------------------------------
+    Server(const std::string & socketPath, unsigned int numWorkers,
+           size_t maxCacheEntries = 64 * 1024);
+
+    ~Server();
+
+    //------------------------------------------------------------------------
+    //!  Runs until SIGINT or SIGTERM.  Returns false if we failed to
+    //!  listen on our socket.
+    //------------------------------------------------------------------------
+    bool Run();
+
+    //------------------------------------------------------------------------
+    //!  Asks Run() to return, as SIGINT and SIGTERM do.  Safe to call
+    //!  from any thread.
+    //------------------------------------------------------------------------
+    void Stop();
+
+  private:
+    struct FileId {
+      dev_t     dev;
+      ino_t     ino;
+      off_t     size;
+      int64_t   mtimeNsecs;
+
+      bool operator == (const FileId &) const = default;
+    };
+
+    struct FileIdHash {
+      size_t operator () (const FileId & id) const noexcept;
+    };
+
+    struct Result {
+      bool                      ok;
+      std::string               error;
+      std::vector<std::string>  hits;
+    };
+    using ResultPtr = std::shared_ptr<const Result>;
+
+    struct Request {
+      int          fd;
+      std::string  path;
+    };
+
+    struct Connection {
+      std::string  buf;
+      bool         busy = false;
+    };
+    
+    std::string                   _socketPath;
+    unsigned int                  _numWorkers;
+    size_t                        _maxCacheEntries;
+    int                           _listenFd;
+    int                           _wakeFds[2];
+    std::atomic<bool>             _stop;
+    Dwm::Pkg::Scanner             _scanner;
+    std::mutex                    _cacheMtx;
+    std::unordered_map<FileId,ResultPtr,FileIdHash>  _cache;
+    std::unordered_map<FileId,std::shared_future<ResultPtr>,FileIdHash>
+                                  _inFlight;
+    std::mutex                    _queueMtx;
+    std::condition_variable       _queueCv;
+    std::deque<Request>           _queue;
+    std::vector<std::pair<int,bool>>  _finished;
+    bool                          _done;
+    std::unordered_map<int,Connection>  _conns;
+
+    bool Listen();
+    void Worker();
+    void Wake();
+    void AcceptClient();
+    void ReadClient(int fd);
+    void Dispatch(int fd, Connection & conn);
+    void FinishRequests();
+    void CloseClient(int fd);
+    ResultPtr GetResult(const std::string & path);
+    ResultPtr Scan(const std::string & path);
+  };
+
+  //--------------------------------------------------------------------------
+  //!  The client side of the Server protocol.
+  //--------------------------------------------------------------------------
+  class Client
+  {
+  public:
+    Client();
+    ~Client();
+    
+    //------------------------------------------------------------------------
+    //!  Connects to the server at @c socketPath.  Returns true on
+    //!  success.
+    //------------------------------------------------------------------------
+    bool Connect(const std::string & socketPath);
+
+    //------------------------------------------------------------------------
+    //!  Queries @c path.  On success, fills @c hits and returns true.  On
+    //!  failure, fills @c error and returns false.
+    //------------------------------------------------------------------------
+    bool Query(const std::string & path, std::vector<std::string> & hits,
+               std::string & error);
+
+  private:
+    int          _fd;
+    std::string  _buf;
+  };
+  
+}  // namespace DwmWhat
+
+#endif  // _DWMWHATSERVER_HH_
@@ -0,0 +1,594 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+
+//---------------------------------------------------------------------------
+//!  \file DwmWhatSnapshot.cc
+//!  \author Daniel W. McRobb
+//!  \brief Binary inventory snapshot implementation
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+}
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <tuple>
+#include <utility>
+
+#include "DwmWhatSnapshot.hh"
+
+namespace DwmWhat {
+
+  static constexpr char      k_magic[8] = { 'D','W','M','W','S','N','A','P' };
+  static constexpr uint32_t  k_version = 2;
+  static constexpr uint32_t  k_byteOrder = 0x01020304;
+
+  //--------------------------------------------------------------------------
+  //!  Sorts the package @c index by (name, Dwm::Pkg::Version), then by
+  //!  version string, path and raw string so the order is deterministic.
+  //!  @c str maps a string id to a std::string_view.
+  //--------------------------------------------------------------------------
+  template <typename Str>
+  static void SortPkgIndex(std::vector<SnapshotPkgRef> & index,
+                           std::span<const SnapshotFile> files,
+                           std::span<const SnapshotPkg> pkgs, const Str & str)
+  {
+    using Dwm::Pkg::Version;
+    using Key = std::tuple<std::string_view,std::string_view,
+                           std::string_view>;
+    std::sort(index.begin(), index.end(),
+              [&] (const SnapshotPkgRef & a, const SnapshotPkgRef & b) {
+      const SnapshotPkg  & ap = pkgs[a.pkg];
+      const SnapshotPkg  & bp = pkgs[b.pkg];
+      if (int cmp = str(ap.name).compare(str(bp.name))) {
+        return (cmp < 0);
+      }
+      if (int cmp = Version(str(ap.version))
+          .Compare(Version(str(bp.version)))) {
+        return (cmp < 0);
+      }
+      return (Key(str(ap.version), str(files[a.file].path), str(ap.raw))
+              < Key(str(bp.version), str(files[b.file].path), str(bp.raw)));
+    });
+    return;
+  }
+  
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  uint32_t SnapshotWriter::Intern(std::string_view s)
+  {
+    auto  it = _stringIds.find(s);
+    if (it != _stringIds.end()) {
+      return it->second;
+    }
+    uint32_t  id = _strings.size();
+    _strings.emplace_back(s);
+    _stringIds.emplace(_strings.back(), id);
+    return id;
+  }
+  
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  uint32_t SnapshotWriter::AddFile(std::string_view path)
+  {
+    _files.push_back({Intern(path), {}, {}});
+    return _files.size() - 1;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  void SnapshotWriter::AddPkg(uint32_t fileIdx,
+                              const Dwm::Pkg::InfoView & pkg,
+                              std::string_view raw)
+  {
+    _files[fileIdx].pkgs.push_back({Intern(pkg.type), Intern(pkg.status),
+                                    Intern(pkg.name), Intern(pkg.version),
+                                    Intern(pkg.copyright), Intern(pkg.date),
+                                    Intern(pkg.other), Intern(raw)});
+    return;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  void SnapshotWriter::AddOther(uint32_t fileIdx, std::string_view raw)
+  {
+    _files[fileIdx].others.push_back(Intern(raw));
+    return;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  bool SnapshotWriter::Write(const std::string & path)
+  {
+    auto  str = [&] (uint32_t id) -> const std::string & 
+    { return _strings[id]; };
+    auto  pkgLess = [&] (const SnapshotPkg & a, const SnapshotPkg & b)
+    {
+      return (std::tie(str(a.name), str(a.version), str(a.status), str(a.raw))
+              < std::tie(str(b.name), str(b.version), str(b.status),
+                         str(b.raw)));
+    };
+    
+    std::sort(_files.begin(), _files.end(),
+              [&] (const File & a, const File & b)
+              { return str(a.path) < str(b.path); });
+
+    SnapshotHeader  hdr;
+    memcpy(hdr.magic, k_magic, sizeof(hdr.magic));
+    hdr.version = k_version;
+    hdr.byteOrder = k_byteOrder;
+    hdr.numStrings = _strings.size();
+    hdr.numFiles = _files.size();
+    hdr.numPkgs = 0;
+    hdr.numOthers = 0;
+    hdr.blobSize = 0;
+
+    std::vector<SnapshotString>  strings;
+    strings.reserve(_strings.size());
+    for (const auto & s : _strings) {
+      strings.push_back({(uint32_t)hdr.blobSize, (uint32_t)s.size()});
+      hdr.blobSize += s.size();
+    }
+    if (hdr.blobSize > UINT32_MAX) {
+      return false;
+    }
+    
+    std::vector<SnapshotFile>  files;
+    std::vector<SnapshotPkg>   pkgs;
+    std::vector<uint32_t>      others;
+    files.reserve(_files.size());
+    for (auto & file : _files) {
+      std::sort(file.pkgs.begin(), file.pkgs.end(), pkgLess);
+      std::sort(file.others.begin(), file.others.end(),
+                [&] (uint32_t a, uint32_t b) { return str(a) < str(b); });
+      files.push_back({file.path, (uint32_t)pkgs.size(),
+                       (uint32_t)file.pkgs.size(), (uint32_t)others.size(),
+                       (uint32_t)file.others.size()});
+      pkgs.insert(pkgs.end(), file.pkgs.begin(), file.pkgs.end());
+      others.insert(others.end(), file.others.begin(), file.others.end());
+    }
+    hdr.numPkgs = pkgs.size();
+    hdr.numOthers = others.size();
+
+    std::vector<SnapshotPkgRef>  index;
+    index.reserve(pkgs.size());
+    for (uint32_t fileIdx = 0; fileIdx < files.size(); ++fileIdx) {
+      for (uint32_t i = 0; i < files[fileIdx].numPkgs; ++i) {
+        index.push_back({fileIdx, files[fileIdx].firstPkg + i});
+      }
+    }
+    SortPkgIndex(index, files, pkgs,
+                 [&] (uint32_t id) { return std::string_view(str(id)); });
+    
+    std::ofstream  os(path, std::ios::binary|std::ios::trunc);
+    if (! os) {
+      return false;
+    }
+    os.write((const char *)&hdr, sizeof(hdr));
+    os.write((const char *)strings.data(),
+             strings.size() * sizeof(SnapshotString));
+    os.write((const char *)files.data(), files.size() * sizeof(SnapshotFile));
+    os.write((const char *)pkgs.data(), pkgs.size() * sizeof(SnapshotPkg));
+    os.write((const char *)others.data(), others.size() * sizeof(uint32_t));
+    os.write((const char *)index.data(),
+             index.size() * sizeof(SnapshotPkgRef));
+    for (const auto & s : _strings) {
+      os.write(s.data(), s.size());
+    }
+    os.close();
+    return (! os.fail());
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  Snapshot::~Snapshot()
+  {
+    Close();
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  void Snapshot::Close()
+  {
+    if (_map) {
+      munmap(_map, _mapSize);
+      _map = nullptr;
+    }
+    _mapSize = 0;
+    _strings = {};
+    _files = {};
+    _pkgs = {};
+    _others = {};
+    _pkgIndex = {};
+    _builtIndex.clear();
+    _blob = nullptr;
+    return;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  bool Snapshot::Open(const std::string & path)
+  {
+    Close();
+    bool  rc = false;
+    int   fd = open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+      struct stat  statbuf;
+      if ((fstat(fd, &statbuf) == 0)
+          && (statbuf.st_size >= (off_t)sizeof(SnapshotHeader))) {
+        _mapSize = statbuf.st_size;
+        _map = mmap(0, _mapSize, PROT_READ, MAP_SHARED, fd, 0);
+        if (_map == MAP_FAILED) {
+          _map = nullptr;
+        }
+        else {
+          rc = Validate(*(const SnapshotHeader *)_map);
+        }
+      }
+      close(fd);
+    }
+    if (! rc) {
+      Close();
+    }
+    return rc;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  bool Snapshot::Validate(const SnapshotHeader & hdr)
+  {
+    if ((memcmp(hdr.magic, k_magic, sizeof(k_magic)) != 0)
+        || (hdr.version < 1) || (hdr.version > k_version)
+        || (hdr.byteOrder != k_byteOrder)) {
+      return false;
+    }
+    bool      haveIndex = (hdr.version >= 2);
+    uint64_t  need = sizeof(hdr)
+      + ((uint64_t)hdr.numStrings * sizeof(SnapshotString))
+      + ((uint64_t)hdr.numFiles * sizeof(SnapshotFile))
+      + ((uint64_t)hdr.numPkgs * sizeof(SnapshotPkg))
+      + ((uint64_t)hdr.numOthers * sizeof(uint32_t))
+      + (haveIndex ? ((uint64_t)hdr.numPkgs * sizeof(SnapshotPkgRef)) : 0)
+      + hdr.blobSize;
+    if (need != _mapSize) {
+      return false;
+    }
+    const char  *p = (const char *)_map + sizeof(hdr);
+    _strings = { (const SnapshotString *)p, hdr.numStrings };
+    p += hdr.numStrings * sizeof(SnapshotString);
+    _files = { (const SnapshotFile *)p, hdr.numFiles };
+    p += hdr.numFiles * sizeof(SnapshotFile);
+    _pkgs = { (const SnapshotPkg *)p, hdr.numPkgs };
+    p += hdr.numPkgs * sizeof(SnapshotPkg);
+    _others = { (const uint32_t *)p, hdr.numOthers };
+    p += hdr.numOthers * sizeof(uint32_t);
+    if (haveIndex) {
+      _pkgIndex = { (const SnapshotPkgRef *)p, hdr.numPkgs };
+      p += hdr.numPkgs * sizeof(SnapshotPkgRef);
+    }
+    _blob = p;
+
+    for (const auto & s : _strings) {
+      if (((uint64_t)s.offset + s.length) > hdr.blobSize) {
+        return false;
+      }
+    }
+    auto  badId = [&] (uint32_t id) { return (id >= hdr.numStrings); };
+    for (const auto & file : _files) {
+      if (badId(file.path)
+          || (((uint64_t)file.firstPkg + file.numPkgs) > hdr.numPkgs)
+          || (((uint64_t)file.firstOther + file.numOthers)
+              > hdr.numOthers)) {
+        return false;
+      }
+    }
+    for (const auto & pkg : _pkgs) {
+      if (badId(pkg.type) || badId(pkg.status) || badId(pkg.name)
+          || badId(pkg.version) || badId(pkg.copyright) || badId(pkg.date)
+          || badId(pkg.other) || badId(pkg.raw)) {
+        return false;
+      }
+    }
+    if (std::any_of(_others.begin(), _others.end(), badId)) {
+      return false;
+    }
+    //  DiffSnapshots() is a single merge pass, so it needs files sorted
+    //  by path and each file's packages sorted as SnapshotWriter sorts
+    //  them.
+    auto  pkgKey = [&] (const SnapshotPkg & pkg)
+    { return std::tuple(String(pkg.name), String(pkg.version),
+                        String(pkg.status)); };
+    for (size_t i = 1; i < _files.size(); ++i) {
+      if (String(_files[i].path) < String(_files[i-1].path)) {
+        return false;
+      }
+    }
+    for (const auto & file : _files) {
+      auto  pkgs = Pkgs(file);
+      for (size_t i = 1; i < pkgs.size(); ++i) {
+        if (pkgKey(pkgs[i]) < pkgKey(pkgs[i-1])) {
+          return false;
+        }
+      }
+    }
+    for (const auto & ref : _pkgIndex) {
+      if ((ref.file >= hdr.numFiles)
+          || (ref.pkg < _files[ref.file].firstPkg)
+          || ((ref.pkg - _files[ref.file].firstPkg)
+              >= _files[ref.file].numPkgs)) {
+        return false;
+      }
+    }
+    if (! haveIndex) {
+      _builtIndex.reserve(hdr.numPkgs);
+      for (uint32_t fileIdx = 0; fileIdx < hdr.numFiles; ++fileIdx) {
+        for (uint32_t i = 0; i < _files[fileIdx].numPkgs; ++i) {
+          _builtIndex.push_back({fileIdx, _files[fileIdx].firstPkg + i});
+        }
+      }
+      SortPkgIndex(_builtIndex, _files, _pkgs,
+                   [&] (uint32_t id) { return String(id); });
+      _pkgIndex = _builtIndex;
+    }
+    return true;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  std::span<const SnapshotPkgRef>
+  Snapshot::FindPkgs(std::string_view name,
+                     const std::vector<std::pair<std::string,std::string>>
+                     & versionRange) const
+  {
+    using Dwm::Pkg::Version;
+    if (name.empty()) {
+      return _pkgIndex;
+    }
+    auto  pkgName = [&] (const SnapshotPkgRef & ref)
+    { return String(_pkgs[ref.pkg].name); };
+    auto  pkgVersion = [&] (const SnapshotPkgRef & ref)
+    { return Version(String(_pkgs[ref.pkg].version)); };
+    
+    auto  first = std::partition_point(_pkgIndex.begin(), _pkgIndex.end(),
+                                       [&] (const SnapshotPkgRef & ref)
+                                       { return (pkgName(ref) < name); });
+    auto  last = std::partition_point(first, _pkgIndex.end(),
+                                      [&] (const SnapshotPkgRef & ref)
+                                      { return (pkgName(ref) == name); });
+    for (const auto & term : versionRange) {
+      Version  v(term.second);
+      auto  below = [&] (const SnapshotPkgRef & ref)
+      { return (pkgVersion(ref) < v); };
+      auto  notAbove = [&] (const SnapshotPkgRef & ref)
+      { return (pkgVersion(ref) <= v); };
+      if ((term.first == ">=") || (term.first == "==")) {
+        first = std::partition_point(first, last, below);
+      }
+      else if (term.first == ">") {
+        first = std::partition_point(first, last, notAbove);
+      }
+      if ((term.first == "<=") || (term.first == "==")) {
+        last = std::partition_point(first, last, notAbove);
+      }
+      else if (term.first == "<") {
+        last = std::partition_point(first, last, below);
+      }
+    }
+    return std::span<const SnapshotPkgRef>(first, last);
+  }
+
+  //--------------------------------------------------------------------------
+  //!  Returns the (version, status) of @c pkg, the key DiffPkgs() merges
+  //!  on within a name.
+  //--------------------------------------------------------------------------
+  static std::pair<std::string_view,std::string_view>
+  VersionKey(const Snapshot & snap, const SnapshotPkg & pkg)
+  {
+    return std::make_pair(snap.String(pkg.version), snap.String(pkg.status));
+  }
+  
+  //--------------------------------------------------------------------------
+  //!  Returns the iterator past @c it and every following record in
+  //!  @c pkgs with the same name, version and status.  A file can hold
+  //!  several copies of one package version (with different dates, for
+  //!  example) and they are one package as far as a diff is concerned.
+  //--------------------------------------------------------------------------
+  static std::span<const SnapshotPkg>::iterator
+  SkipSame(const Snapshot & snap, std::span<const SnapshotPkg> pkgs,
+           std::span<const SnapshotPkg>::iterator it)
+  {
+    auto  next = it + 1;
+    while ((next != pkgs.end())
+           && (snap.String(next->name) == snap.String(it->name))
+           && (VersionKey(snap, *next) == VersionKey(snap, *it))) {
+      ++next;
+    }
+    return next;
+  }
+  
+  //--------------------------------------------------------------------------
+  //!  Merges the package records of one file that appears in both
+  //!  snapshots, which are sorted by (name, version, status).  Packages
+  //!  with the same name, version and status are unchanged.  For each
+  //!  name, if exactly one version was removed and one added, we report
+  //!  a change.  Otherwise we report the individual removals and
+  //!  additions.
+  //--------------------------------------------------------------------------
+  static void DiffPkgs(const Snapshot & oldSnap, const SnapshotFile & oldFile,
+                       const Snapshot & newSnap, const SnapshotFile & newFile,
+                       const std::function<void(const SnapshotDiff &)> & fn)
+  {
+    auto  oldPkgs = oldSnap.Pkgs(oldFile);
+    auto  newPkgs = newSnap.Pkgs(newFile);
+    auto  oi = oldPkgs.begin();
+    auto  ni = newPkgs.begin();
+    std::string_view  path = newSnap.String(newFile.path);
+    std::vector<const SnapshotPkg *>  removed, added;
+    
+    while ((oi != oldPkgs.end()) || (ni != newPkgs.end())) {
+      //  Pick the next name in merge order, then consume every record
+      //  with that name from both sides.
+      std::string_view  name;
+      if (ni == newPkgs.end()) {
+        name = oldSnap.String(oi->name);
+      }
+      else if (oi == oldPkgs.end()) {
+        name = newSnap.String(ni->name);
+      }
+      else {
+        name = std::min(oldSnap.String(oi->name), newSnap.String(ni->name));
+      }
+      removed.clear();
+      added.clear();
+      while ((oi != oldPkgs.end()) || (ni != newPkgs.end())) {
+        bool  oldMatch = ((oi != oldPkgs.end())
+                          && (oldSnap.String(oi->name) == name));
+        bool  newMatch = ((ni != newPkgs.end())
+                          && (newSnap.String(ni->name) == name));
+        if (oldMatch && newMatch) {
+          auto  ov = VersionKey(oldSnap, *oi);
+          auto  nv = VersionKey(newSnap, *ni);
+          if (ov == nv) {
+            oi = SkipSame(oldSnap, oldPkgs, oi);
+            ni = SkipSame(newSnap, newPkgs, ni);
+          }
+          else if (ov < nv) {
+            removed.push_back(&*oi);
+            oi = SkipSame(oldSnap, oldPkgs, oi);
+          }
+          else {
+            added.push_back(&*ni);
+            ni = SkipSame(newSnap, newPkgs, ni);
+          }
+        }
+        else if (oldMatch) {
+          removed.push_back(&*oi);
+          oi = SkipSame(oldSnap, oldPkgs, oi);
+        }
+        else if (newMatch) {
+          added.push_back(&*ni);
+          ni = SkipSame(newSnap, newPkgs, ni);
+        }
+        else {
+          break;
+        }
+      }
+      if ((removed.size() == 1) && (added.size() == 1)) {
+        fn({path, name,
+            oldSnap.String(removed[0]->version),
+            oldSnap.String(removed[0]->status),
+            newSnap.String(added[0]->version),
+            newSnap.String(added[0]->status)});
+      }
+      else {
+        for (auto pkg : removed) {
+          fn({path, name, oldSnap.String(pkg->version),
+              oldSnap.String(pkg->status), {}, {}});
+        }
+        for (auto pkg : added) {
+          fn({path, name, {}, {}, newSnap.String(pkg->version),
+              newSnap.String(pkg->status)});
+        }
+      }
+    }
+    return;
+  }
+  
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  void DiffSnapshots(const Snapshot & oldSnap, const Snapshot & newSnap,
+                     const std::function<void(const SnapshotDiff &)> & fn)
+  {
+    size_t  oi = 0, ni = 0;
+    while ((oi < oldSnap.NumFiles()) || (ni < newSnap.NumFiles())) {
+      int  cmp;
+      if (oi == oldSnap.NumFiles()) {
+        cmp = 1;
+      }
+      else if (ni == newSnap.NumFiles()) {
+        cmp = -1;
+      }
+      else {
+        cmp = oldSnap.String(oldSnap.File(oi).path)
+          .compare(newSnap.String(newSnap.File(ni).path));
+      }
+      if (cmp < 0) {
+        //  File is gone.  Everything in it was removed.
+        const SnapshotFile & oldFile = oldSnap.File(oi++);
+        std::string_view  path = oldSnap.String(oldFile.path);
+        auto  pkgs = oldSnap.Pkgs(oldFile);
+        for (auto it = pkgs.begin(); it != pkgs.end();
+             it = SkipSame(oldSnap, pkgs, it)) {
+          fn({path, oldSnap.String(it->name), oldSnap.String(it->version),
+              oldSnap.String(it->status), {}, {}});
+        }
+      }
+      else if (cmp > 0) {
+        //  New file.  Everything in it was added.
+        const SnapshotFile & newFile = newSnap.File(ni++);
+        std::string_view  path = newSnap.String(newFile.path);
+        auto  pkgs = newSnap.Pkgs(newFile);
+        for (auto it = pkgs.begin(); it != pkgs.end();
+             it = SkipSame(newSnap, pkgs, it)) {
+          fn({path, newSnap.String(it->name), {}, {},
+              newSnap.String(it->version), newSnap.String(it->status)});
+        }
+      }
+      else {
+        DiffPkgs(oldSnap, oldSnap.File(oi++), newSnap, newSnap.File(ni++),
+                 fn);
+      }
+    }
+    return;
+  }
+  
+}  // namespace DwmWhat
@@ -0,0 +1,267 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+
+//---------------------------------------------------------------------------
+//!  \file DwmWhatSnapshot.hh
+//!  \author Daniel W. McRobb
+//!  \brief Binary inventory snapshots: DwmWhat::SnapshotWriter,
+//!    DwmWhat::Snapshot and DwmWhat::DiffSnapshots()
+//---------------------------------------------------------------------------
+
+#ifndef _DWMWHATSNAPSHOT_HH_
+#define _DWMWHATSNAPSHOT_HH_
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "DwmPkgInfoView.hh"
+#include "DwmPkgVersion.hh"
+
+namespace DwmWhat {
+
+  //--------------------------------------------------------------------------
+  //!  Layout of a snapshot file.  Everything is native byte order and
+  //!  4-byte aligned, so a mapped snapshot can be used in place.
+  //!
+  //!    SnapshotHeader
+  //!    SnapshotString[numStrings]    offset and length into the blob
+  //!    SnapshotFile[numFiles]        sorted by path
+  //!    SnapshotPkg[numPkgs]          grouped by file, sorted by
+  //!                                  (name, version, status) in each
+  //!    uint32_t[numOthers]           string ids of non-package strings,
+  //!                                  grouped by file, sorted
+  //!    SnapshotPkgRef[numPkgs]       package index, sorted by (name,
+  //!                                  Dwm::Pkg::Version) (version 2)
+  //!    char[blobSize]                string bytes
+  //!
+  //!  Version 1 snapshots have no package index; Snapshot builds one in
+  //!  memory when it opens them.
+  //--------------------------------------------------------------------------
+  struct SnapshotHeader {
+    char      magic[8];
+    uint32_t  version;
+    uint32_t  byteOrder;
+    uint32_t  numStrings;
+    uint32_t  numFiles;
+    uint32_t  numPkgs;
+    uint32_t  numOthers;
+    uint64_t  blobSize;
+  };
+
+  struct SnapshotString {
+    uint32_t  offset;
+    uint32_t  length;
+  };
+
+  struct SnapshotFile {
+    uint32_t  path;
+    uint32_t  firstPkg;
+    uint32_t  numPkgs;
+    uint32_t  firstOther;
+    uint32_t  numOthers;
+  };
+
+  struct SnapshotPkg {
+    uint32_t  type;
+    uint32_t  status;
+    uint32_t  name;
+    uint32_t  version;
+    uint32_t  copyright;
+    uint32_t  date;
+    uint32_t  other;
+    uint32_t  raw;
+  };
+
+  struct SnapshotPkgRef {
+    uint32_t  file;   // index of SnapshotFile
+    uint32_t  pkg;    // index of SnapshotPkg
+  };
+
+  //--------------------------------------------------------------------------
+  //!  Collects file records in any order and writes them as a snapshot.
+  //!  Strings are interned, so each unique path, field value and raw
+  //!  string is stored once.
+  //--------------------------------------------------------------------------
+  class SnapshotWriter
+  {
+  public:
+    //------------------------------------------------------------------------
+    //!  Adds a file with the given @c path and returns its index for
+    //!  use with AddPkg() and AddOther().
+    //------------------------------------------------------------------------
+    uint32_t AddFile(std::string_view path);
+
+    //------------------------------------------------------------------------
+    //!  Adds a package found in the file at index @c fileIdx, with
+    //!  parsed fields @c pkg and raw string @c raw.
+    //------------------------------------------------------------------------
+    void AddPkg(uint32_t fileIdx, const Dwm::Pkg::InfoView & pkg,
+                std::string_view raw);
+
+    //------------------------------------------------------------------------
+    //!  Adds a non-package string found in the file at index @c fileIdx.
+    //------------------------------------------------------------------------
+    void AddOther(uint32_t fileIdx, std::string_view raw);
+
+    //------------------------------------------------------------------------
+    //!  Writes the snapshot to @c path.  Returns true on success.
+    //------------------------------------------------------------------------
+    bool Write(const std::string & path);
+
+  private:
+    struct File {
+      uint32_t                  path;
+      std::vector<SnapshotPkg>  pkgs;
+      std::vector<uint32_t>     others;
+    };
+    
+    std::deque<std::string>                        _strings;
+    std::unordered_map<std::string_view,uint32_t>  _stringIds;
+    std::vector<File>                              _files;
+
+    uint32_t Intern(std::string_view s);
+  };
+
+  //--------------------------------------------------------------------------
+  //!  A read-only, memory-mapped snapshot.  Open() validates the
+  //!  header, every string id and record range and the sort order of
+  //!  files and packages once, so accessors and DiffSnapshots() don't
+  //!  need to.
+  //--------------------------------------------------------------------------
+  class Snapshot
+  {
+  public:
+    Snapshot() = default;
+    Snapshot(const Snapshot &) = delete;
+    Snapshot & operator = (const Snapshot &) = delete;
+    ~Snapshot();
+
+    //------------------------------------------------------------------------
+    //!  Maps and validates the snapshot at @c path, unmapping any
+    //!  snapshot previously opened.  Returns true on success.
+    //------------------------------------------------------------------------
+    bool Open(const std::string & path);
+
+    //------------------------------------------------------------------------
+    //!  Unmaps the snapshot, if any.
+    //------------------------------------------------------------------------
+    void Close();
+
+    size_t NumFiles() const
+    { return _files.size(); }
+    
+    const SnapshotFile & File(size_t fileIdx) const
+    { return _files[fileIdx]; }
+
+    std::span<const SnapshotPkg> Pkgs(const SnapshotFile & file) const
+    { return _pkgs.subspan(file.firstPkg, file.numPkgs); }
+
+    std::span<const uint32_t> Others(const SnapshotFile & file) const
+    { return _others.subspan(file.firstOther, file.numOthers); }
+    
+    std::string_view String(uint32_t id) const
+    {
+      return std::string_view(_blob + _strings[id].offset,
+                              _strings[id].length);
+    }
+
+    const SnapshotPkg & Pkg(const SnapshotPkgRef & ref) const
+    { return _pkgs[ref.pkg]; }
+    
+    //------------------------------------------------------------------------
+    //!  Returns the package index, sorted by (name, version).
+    //------------------------------------------------------------------------
+    std::span<const SnapshotPkgRef> PkgIndex() const
+    { return _pkgIndex; }
+
+    //------------------------------------------------------------------------
+    //!  Returns the part of the package index for packages named @c name
+    //!  whose versions satisfy the "<", "<=", ">", ">=" and "==" terms
+    //!  of @c versionRange (as in Dwm::Pkg::ScanFilter), using binary
+    //!  searches.  "!=" terms are not applied.  An empty @c name
+    //!  matches every package, in which case @c versionRange is not
+    //!  applied either.
+    //------------------------------------------------------------------------
+    std::span<const SnapshotPkgRef>
+    FindPkgs(std::string_view name,
+             const std::vector<std::pair<std::string,std::string>>
+             & versionRange) const;
+    
+  private:
+    void                             *_map = nullptr;
+    size_t                            _mapSize = 0;
+    std::span<const SnapshotString>   _strings;
+    std::span<const SnapshotFile>     _files;
+    std::span<const SnapshotPkg>      _pkgs;
+    std::span<const uint32_t>         _others;
+    std::span<const SnapshotPkgRef>   _pkgIndex;
+    std::vector<SnapshotPkgRef>       _builtIndex;
+    const char                       *_blob = nullptr;
+
+    bool Validate(const SnapshotHeader & hdr);
+  };
+
+  //--------------------------------------------------------------------------
+  //!  One difference between two snapshots.  For an added package,
+  //!  @c oldVersion is empty.  For a removed package, @c newVersion is
+  //!  empty.  For a changed package, both are set.
+  //--------------------------------------------------------------------------
+  struct SnapshotDiff {
+    std::string_view  path;
+    std::string_view  name;
+    std::string_view  oldVersion;
+    std::string_view  oldStatus;
+    std::string_view  newVersion;
+    std::string_view  newStatus;
+  };
+
+  //--------------------------------------------------------------------------
+  //!  Compares @c oldSnap and @c newSnap in a single linear merge pass
+  //!  over their sorted file records (and the sorted package records of
+  //!  each file present in both), calling @c fn for each difference.
+  //--------------------------------------------------------------------------
+  void DiffSnapshots(const Snapshot & oldSnap, const Snapshot & newSnap,
+                     const std::function<void(const SnapshotDiff &)> & fn);
+  
+}  // namespace DwmWhat
+
+#endif  // _DWMWHATSNAPSHOT_HH_
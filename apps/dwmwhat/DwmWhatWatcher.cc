@@ -0,0 +1,388 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+
+//---------------------------------------------------------------------------
+//!  \file DwmWhatWatcher.cc
+//!  \author Daniel W. McRobb
+//!  \brief DwmWhat::Watcher class implementation
+//---------------------------------------------------------------------------
+
+extern "C" {
+#ifdef __linux__
+  #include <sys/inotify.h>
+#endif
+  #include <sys/stat.h>
+  #include <errno.h>
+  #include <poll.h>
+  #include <signal.h>
+  #include <unistd.h>
+}
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+#include "DwmWhatWatcher.hh"
+
+namespace DwmWhat {
+
+  namespace fs = std::filesystem;
+  
+  static volatile sig_atomic_t  g_stopWatcher = 0;
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  static void StopWatcher(int)
+  {
+    g_stopWatcher = 1;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  Watcher::Watcher(const Dwm::Pkg::Scanner & scanner,
+                   std::chrono::milliseconds debounce,
+                   const DeltaCallback & cb)
+      : _scanner(scanner), _debounce(debounce), _cb(cb), _fd(-1),
+        _stop(false), _watches(), _state(), _pending()
+  {}
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  Watcher::~Watcher()
+  {
+    if (_fd >= 0) {
+      close(_fd);
+    }
+  }
+  
+#ifdef __linux__
+
+  static const uint32_t  k_watchMask =
+    IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE
+    | IN_DELETE_SELF | IN_ONLYDIR | IN_DONT_FOLLOW;
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  bool Watcher::Run(const std::vector<std::string> & dirs)
+  {
+    _fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (_fd < 0) {
+      std::cerr << "inotify_init1() failed: " << strerror(errno) << '\n';
+      return false;
+    }
+    struct sigaction  sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = StopWatcher;
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+
+    for (const auto & dir : dirs) {
+      AddTree(dir);
+    }
+    
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point  firstEvent, lastEvent;
+    while ((! g_stopWatcher) && (! _stop)) {
+      int  timeout = -1;
+      if (! _pending.empty()) {
+        auto  now = Clock::now();
+        auto  due = std::min(lastEvent + _debounce,
+                             firstEvent + 10 * _debounce);
+        if (due <= now) {
+          Flush();
+          continue;
+        }
+        timeout =
+          std::chrono::ceil<std::chrono::milliseconds>(due - now).count();
+      }
+      //  Wake periodically so we notice signals and Stop().
+      if (timeout < 0 || timeout > 250) {
+        timeout = 250;
+      }
+      struct pollfd  pfd = { _fd, POLLIN, 0 };
+      int  rc = poll(&pfd, 1, timeout);
+      if (rc < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        std::cerr << "poll() failed: " << strerror(errno) << '\n';
+        return false;
+      }
+      if (rc > 0) {
+        bool  hadPending = ! _pending.empty();
+        if (! ReadEvents()) {
+          return false;
+        }
+        if (! _pending.empty()) {
+          lastEvent = Clock::now();
+          if (! hadPending) {
+            firstEvent = lastEvent;
+          }
+        }
+      }
+    }
+    Flush();
+    return true;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  Adds watches for @c root and every directory below it, then scans
+  //!  every regular file.  Watches are added before a directory is listed
+  //!  so files created while we're listing aren't missed.
+  //--------------------------------------------------------------------------
+  void Watcher::AddTree(const std::string & root)
+  {
+    std::vector<std::string>  dirs(1, root);
+    while (! dirs.empty()) {
+      std::string  dir = std::move(dirs.back());
+      dirs.pop_back();
+      int  wd = inotify_add_watch(_fd, dir.c_str(), k_watchMask);
+      if (wd < 0) {
+        std::cerr << "inotify_add_watch(" << dir << ") failed: "
+                  << strerror(errno) << '\n';
+        continue;
+      }
+      _watches[wd] = dir;
+      std::error_code  ec;
+      for (const auto & entry : fs::directory_iterator(dir, ec)) {
+        std::error_code  ec2;
+        if (entry.is_symlink(ec2)) {
+          continue;
+        }
+        if (entry.is_directory(ec2)) {
+          dirs.push_back(entry.path().string());
+        }
+        else if (entry.is_regular_file(ec2)) {
+          Rescan(entry.path().string());
+        }
+      }
+    }
+    return;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  Drops the watches and state for everything at or below @c root.
+  //--------------------------------------------------------------------------
+  void Watcher::RemoveTree(const std::string & root)
+  {
+    std::string  prefix = root + '/';
+    for (auto it = _watches.begin(); it != _watches.end(); ) {
+      if ((it->second == root) || it->second.starts_with(prefix)) {
+        inotify_rm_watch(_fd, it->first);
+        it = _watches.erase(it);
+      }
+      else {
+        ++it;
+      }
+    }
+    std::vector<std::string>  gone;
+    for (const auto & st : _state) {
+      if (st.first.starts_with(prefix)) {
+        gone.push_back(st.first);
+      }
+    }
+    std::sort(gone.begin(), gone.end());
+    for (const auto & path : gone) {
+      Forget(path);
+    }
+    return;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  bool Watcher::ReadEvents()
+  {
+    alignas(struct inotify_event) char  buf[64 * 1024];
+    for (;;) {
+      ssize_t  len = read(_fd, buf, sizeof(buf));
+      if (len < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        if (errno == EAGAIN) {
+          break;
+        }
+        std::cerr << "read(inotify) failed: " << strerror(errno) << '\n';
+        return false;
+      }
+      for (ssize_t i = 0; i < len; ) {
+        const auto  *ev =
+          reinterpret_cast<const struct inotify_event *>(buf + i);
+        i += sizeof(struct inotify_event) + ev->len;
+        if (ev->mask & IN_Q_OVERFLOW) {
+          //  We lost events; resynchronize everything we know about.
+          std::cerr << "inotify queue overflow, rescanning\n";
+          for (const auto & st : _state) {
+            _pending.insert(st.first);
+          }
+          for (const auto & w : _watches) {
+            std::error_code  ec;
+            for (const auto & entry : fs::directory_iterator(w.second, ec)) {
+              std::error_code  ec2;
+              if (entry.is_regular_file(ec2) && ! entry.is_symlink(ec2)) {
+                _pending.insert(entry.path().string());
+              }
+            }
+          }
+          continue;
+        }
+        auto  wit = _watches.find(ev->wd);
+        if (wit == _watches.end()) {
+          continue;
+        }
+        if (ev->mask & (IN_IGNORED | IN_DELETE_SELF)) {
+          _watches.erase(wit);
+          continue;
+        }
+        if (! ev->len) {
+          continue;
+        }
+        std::string  path = wit->second + '/' + ev->name;
+        if (ev->mask & IN_ISDIR) {
+          if (ev->mask & (IN_CREATE | IN_MOVED_TO)) {
+            AddTree(path);
+          }
+          else if (ev->mask & (IN_MOVED_FROM | IN_DELETE)) {
+            RemoveTree(path);
+          }
+        }
+        else {
+          _pending.insert(path);
+        }
+      }
+    }
+    return true;
+  }
+
+#else
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  bool Watcher::Run(const std::vector<std::string> &)
+  {
+    std::cerr << "watch mode is only supported on Linux\n";
+    return false;
+  }
+
+  void Watcher::AddTree(const std::string &) {}
+  void Watcher::RemoveTree(const std::string &) {}
+  bool Watcher::ReadEvents() { return false; }
+  
+#endif  // __linux__
+  
+  //--------------------------------------------------------------------------
+  //!  Rescans every pending path.  Paths that are no longer regular files
+  //!  are forgotten.
+  //--------------------------------------------------------------------------
+  void Watcher::Flush()
+  {
+    for (const auto & path : _pending) {
+      struct stat  st;
+      if ((lstat(path.c_str(), &st) == 0) && S_ISREG(st.st_mode)) {
+        Rescan(path);
+      }
+      else {
+        Forget(path);
+      }
+    }
+    _pending.clear();
+    return;
+  }
+  
+  //--------------------------------------------------------------------------
+  //!  Scans @c path and reports the differences from what we saw last time.
+  //--------------------------------------------------------------------------
+  void Watcher::Rescan(const std::string & path)
+  {
+    std::vector<std::string>  hits;
+    _scanner.ScanFile(path, [&] (const Dwm::Pkg::ScanHit & hit)
+    { hits.emplace_back(hit.raw); return true; });
+    std::sort(hits.begin(), hits.end());
+    hits.erase(std::unique(hits.begin(), hits.end()), hits.end());
+
+    auto  it = _state.find(path);
+    if (it == _state.end()) {
+      if (hits.empty()) {
+        return;
+      }
+      it = _state.emplace(path, std::vector<std::string>()).first;
+    }
+    const auto & old = it->second;
+    auto  o = old.cbegin();
+    auto  n = hits.cbegin();
+    while ((o != old.end()) || (n != hits.end())) {
+      if ((n == hits.end()) || ((o != old.end()) && (*o < *n))) {
+        _cb(WatchDelta{'-', path, *o++});
+      }
+      else if ((o == old.end()) || (*n < *o)) {
+        _cb(WatchDelta{'+', path, *n++});
+      }
+      else {
+        ++o;  ++n;
+      }
+    }
+    if (hits.empty()) {
+      _state.erase(it);
+    }
+    else {
+      it->second = std::move(hits);
+    }
+    return;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  void Watcher::Forget(const std::string & path)
+  {
+    auto  it = _state.find(path);
+    if (it != _state.end()) {
+      for (const auto & hit : it->second) {
+        _cb(WatchDelta{'-', path, hit});
+      }
+      _state.erase(it);
+    }
+    return;
+  }
+  
+}  // namespace DwmWhat
@@ -0,0 +1,130 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+
+//---------------------------------------------------------------------------
+//!  \file DwmWhatWatcher.hh
+//!  \author Daniel W. McRobb
+//!  \brief DwmWhat::Watcher class declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMWHATWATCHER_HH_
+#define _DWMWHATWATCHER_HH_
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "DwmPkgScanner.hh"
+
+namespace DwmWhat {
+
+  //--------------------------------------------------------------------------
+  //!  A change in what's found in a watched file: @c op is '+' when
+  //!  @c hit appeared in the file at @c path and '-' when it went away.
+  //--------------------------------------------------------------------------
+  struct WatchDelta {
+    char              op;
+    std::string_view  path;
+    std::string_view  hit;
+  };
+  
+  //--------------------------------------------------------------------------
+  //!  Watches directory trees with inotify and reports changes in what's
+  //!  found in the files under them.  At startup every file is scanned
+  //!  once to establish a baseline (reported as additions).  After that,
+  //!  only files that are written, moved in, moved out or deleted are
+  //!  rescanned, so the cost tracks churn rather than tree size.
+  //!
+  //!  Events are coalesced: a file is rescanned once there have been no
+  //!  new events for the debounce window (or when events have kept
+  //!  arriving for 10 windows), no matter how many events it generated.
+  //!
+  //!  Only available on Linux.
+  //--------------------------------------------------------------------------
+  class Watcher
+  {
+  public:
+    using DeltaCallback = std::function<void(const WatchDelta &)>;
+    
+    //------------------------------------------------------------------------
+    //!  Construct.  @c scanner is used to scan files, @c debounce is the
+    //!  quiet period we wait for before rescanning and @c cb is called
+    //!  for each change.
+    //------------------------------------------------------------------------
+    Watcher(const Dwm::Pkg::Scanner & scanner,
+            std::chrono::milliseconds debounce, const DeltaCallback & cb);
+
+    ~Watcher();
+
+    //------------------------------------------------------------------------
+    //!  Watches the trees rooted at @c dirs until SIGINT or SIGTERM.
+    //!  Returns false if we couldn't set up inotify.
+    //------------------------------------------------------------------------
+    bool Run(const std::vector<std::string> & dirs);
+
+    //------------------------------------------------------------------------
+    //!  Asks Run() to return, as SIGINT and SIGTERM do.  Safe to call
+    //!  from any thread.
+    //------------------------------------------------------------------------
+    void Stop()
+    { _stop = true; }
+
+  private:
+    const Dwm::Pkg::Scanner                      & _scanner;
+    std::chrono::milliseconds                      _debounce;
+    DeltaCallback                                  _cb;
+    int                                            _fd;
+    std::atomic<bool>                              _stop;
+    std::unordered_map<int,std::string>            _watches;
+    std::unordered_map<std::string,std::vector<std::string>>  _state;
+    std::set<std::string>                          _pending;
+
+    void AddTree(const std::string & root);
+    void RemoveTree(const std::string & root);
+    void Rescan(const std::string & path);
+    void Forget(const std::string & path);
+    bool ReadEvents();
+    void Flush();
+  };
+  
+}  // namespace DwmWhat
+
+#endif  // _DWMWHATWATCHER_HH_
@@ -40,20 +40,52 @@
 //---------------------------------------------------------------------------
 
 extern "C" {
-  #include <sys/mman.h>  // for mmap()
-  #include <sys/stat.h>  // for stat()
-  #include <fcntl.h>     // for open()
+  #include <sys/mman.h>
+  #include <sys/resource.h>  // for setpriority(), setiopolicy_np()
+  #include <sys/stat.h>
+  #include <sys/uio.h>
+  #include <fcntl.h>
+  #include <getopt.h>    // for getopt_long()
   #include <libgen.h>    // for basename()
   #include <unistd.h>
+#if defined(__linux__)
+  #include <sys/syscall.h>   // for SYS_ioprio_set
+#endif
 }
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <map>
-#include <regex>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "DwmPkg.hh"
+#include "DwmPkgBatchScanner.hh"
+#include "DwmPkgCoreScanner.hh"
+#include "DwmPkgManifest.hh"
+#include "DwmPkgPolite.hh"
+#include "DwmPkgProbes.hh"
+#include "DwmPkgScanner.hh"
+#include "DwmPkgSymbolIndex.hh"
+#include "DwmPkgVersion.hh"
+#include "DwmWhatInventory.hh"
+#include "DwmWhatJournal.hh"
+#include "DwmWhatServer.hh"
+#include "DwmWhatSnapshot.hh"
+#include "DwmWhatWatcher.hh"
 
 using namespace std;
 
@@ -73,114 +105,93 @@ namespace Crap {
 //  The top level map just has two keys: "pkgs" and "others"
 using PkgMap = map<string,map<string,string>>;
 
-//----------------------------------------------------------------------------
-//!  
-//----------------------------------------------------------------------------
-static std::string MapToJson(std::map<std::string,std::string> & result)
-{
-  std::string  rc("{");
-  std::string  comma;
-  
-  for (const auto & field : result) {
-    rc += comma + " ";
-    rc += "\"" + field.first + "\": \"" + field.second + "\"";
-    comma = ",";
-  }
-  rc += " }";
-  return rc;
-}
-
-//----------------------------------------------------------------------------
-//!  
-//----------------------------------------------------------------------------
-static bool ParseAsDwmPkgInfo(const std::string & v,
-                              std::map<std::string,std::string> & result)
-{
-  bool  rc = false;
-  const static std::string  pkgTypes("(" DWM_PKG_TYPE_HDR
-                                     "|" DWM_PKG_TYPE_LIB
-                                     "|" DWM_PKG_TYPE_EXE
-                                     "|" DWM_PKG_TYPE_DOC ")");
-  static const std::string  pkgStatus("(" DWM_PKG_STATUS_DEV
-                                      "|" DWM_PKG_STATUS_RC
-                                      "|" DWM_PKG_STATUS_REL ")");
-  static const std::string  pkgDate("((Jan|Feb|Mar|Apr|May|Jun"
-                                    "|Jul|Aug|Sep|Oct|Nov|Dec)"
-                                    " [ 123][0-9] [0-9][0-9][0-9][0-9])");
-
-  static const std::string  rgxstr("\\@\\(#\\)[ ]+" + pkgTypes + " "
-                                   + pkgStatus
-                                   + " (.+)"                 // pkg name
-                                   + " (.+)"                 // pkg version
-                                   + " (" DWM_PKG_SYM_COPYRIGHT ")"
-                                   + " (.+) "                // copyright
-                                   + pkgDate + " "           // date
-                                   + DWM_PKG_SYM_OTHER
-                                   // + " (.*)\\0");            // other
-                                   + " (.*)");               // other
-  static const std::regex
-    rgx(rgxstr,std::regex::ECMAScript|std::regex::optimize);
-  std::smatch sm;
-  if (std::regex_match(v, sm, rgx)) {
-    if (sm.size() == 10) {
-      result.clear();
-      result["type"] = sm[1].str();
-      result["status"] = sm[2].str();
-      result["name"] = sm[3].str();
-      result["version"] = sm[4].str();
-      result["copyright"] = sm[6].str();
-      result["date"] = sm[7].str();
-      result["other"] = sm[9].str();
-      rc = true;
-    }
-  }
-  return rc;
-}
+//  The rate limit for --polite without --rate, in bytes per second.
+static constexpr uint64_t  k_defaultPoliteRate = 32 * 1024 * 1024;
 
 //----------------------------------------------------------------------------
 //!  
 //----------------------------------------------------------------------------
-static string OtherToJson(const string & other)
+static string OtherToJson(const string & other, bool truncated = false)
 {
+  if (truncated) {
+    return string("{ \"id\": \"" + other + "\", \"truncated\": true }");
+  }
   return string("{ \"id\": \"" + other + "\" }");
 }
 
 //----------------------------------------------------------------------------
-//!  
+//!  Fills @c pkgMap with the strings in @c hits that pass @c filter.
+//!  This is used for strings we got from a dwmwhat server instead of
+//!  from a Scanner.
 //----------------------------------------------------------------------------
-static void GetPkgMap(const vector<string> & vs, PkgMap & pkgMap)
+static void GetPkgMap(const Dwm::Pkg::ScanFilter & filter,
+                      const vector<string> & hits, PkgMap & pkgMap)
 {
   pkgMap.clear();
-  map<string,string>  infoMap;
-  for (const auto & s : vs) {
-    if (ParseAsDwmPkgInfo(s, infoMap)) {
-      pkgMap["pkgs"][s] = MapToJson(infoMap);
-    }
-    else {
-      pkgMap["others"][s] = OtherToJson(s);
+  Dwm::Pkg::InfoView  info;
+  size_t  numMatches = 0;
+  for (const auto & hit : hits) {
+    if (filter.Prefilter(hit)) {
+      if (info.Parse(hit)) {
+        if (! filter.Matches(info)) {
+          continue;
+        }
+        pkgMap["pkgs"][hit] = info.as_json();
+      }
+      else if (filter.PkgsOnly()) {
+        continue;
+      }
+      else {
+        pkgMap["others"][hit] = OtherToJson(hit);
+      }
+      if (++numMatches == filter.limit) {
+        break;
+      }
     }
   }
   return;
 }
 
 //----------------------------------------------------------------------------
-//!  
+//!  Returns @c line without its leading "@(#)" and the spaces after it,
+//!  or all of @c line if that would leave nothing.
 //----------------------------------------------------------------------------
 static string StripSccsPrefix(const string & line)
 {
-  static regex replregx("^\\@\\(#\\) *", regex::ECMAScript|regex::optimize);
-  string  s(regex_replace(line, replregx, ""));
-  if (! s.empty()) {
-    return s;
+  string_view  s(line);
+  if (s.starts_with("@(#)")) {
+    s.remove_prefix(4);
+    s.remove_prefix(std::min(s.find_first_not_of(' '), s.size()));
+    if (! s.empty()) {
+      return string(s);
+    }
   }
   return line;
 }
 
+//----------------------------------------------------------------------------
+//!  Flushes standard output.  @c numRecords (the number of lines or JSON
+//!  records written since the last flush) and the time taken go to the
+//!  output_flush probe.
+//----------------------------------------------------------------------------
+static void FlushOutput(size_t numRecords)
+{
+  DWM_PKG_PROBE_TIMER(start, output_flush);
+  cout.flush();
+  DWM_PKG_PROBE2(output_flush, numRecords, Dwm::Pkg::Probes::Since(start));
+  return;
+}
+
 //----------------------------------------------------------------------------
 //!  
 //----------------------------------------------------------------------------
 static void PrintPackages(const PkgMap & pkgMap, bool showJson)
 {
+  size_t  numRecords = 0;
+  for (const auto & entry : pkgMap) {
+    numRecords += entry.second.size();
+  }
+  
   if (! showJson) {
     auto it = pkgMap.find("pkgs");
     if (it != pkgMap.end()) {
@@ -194,6 +205,9 @@ static void PrintPackages(const PkgMap & pkgMap, bool showJson)
         std::cout << StripSccsPrefix(pkg.first) << '\n';
       }
     }
+    if (numRecords) {
+      FlushOutput(numRecords);
+    }
     return;
   }
 
@@ -210,9 +224,10 @@ static void PrintPackages(const PkgMap & pkgMap, bool showJson)
       }
       cout << "\n  ]";
     }
+    bool  havePkgs = (it != pkgMap.end());
     it = pkgMap.find("others");
     if (it != pkgMap.end()) {
-      cout << ",\n  \"others\": [";
+      cout << (havePkgs ? ",\n" : "") << "  \"others\": [";
       string comma;
       for (const auto other : it->second) {
         cout << comma << "\n    " << other.second;
@@ -221,163 +236,1080 @@ static void PrintPackages(const PkgMap & pkgMap, bool showJson)
       cout << "\n  ]";
     }
     cout << "\n}\n";
+    FlushOutput(numRecords);
   }
   
   return;
 }
 
 //----------------------------------------------------------------------------
-//!  
+//!  Scans the file at @c path and prints what we find.  Hits are gathered
+//!  (sorted and deduplicated) until they use about @c maxMemory bytes,
+//!  then printed, so memory use doesn't grow with the number of hits.
+//!  A @c maxMemory of 0 means no limit.  Truncated hits are printed with
+//!  a trailing "...".
+//----------------------------------------------------------------------------
+static bool ScanAndPrint(const Dwm::Pkg::Scanner & scanner,
+                         const string & path, bool showJson,
+                         size_t maxMemory)
+{
+  PkgMap  pkgMap;
+  size_t  memUsed = 0;
+  //  Views of the keys in pkgMap, so a repeated hit costs a hash (the
+  //  same one Dwm::Pkg::Info::hash() gives at compile time) and one
+  //  comparison instead of a string copy, a walk down pkgMap and
+  //  another JSON conversion.
+  unordered_set<string_view,Dwm::Pkg::InfoHasher>  seen;
+  bool  rc = scanner.ScanFile(path, [&] (const Dwm::Pkg::ScanHit & hit) {
+    if ((! hit.truncated) && seen.contains(hit.raw)) {
+      return true;
+    }
+    string  s(hit.raw);
+    if (hit.info) {
+      auto  it = pkgMap["pkgs"].try_emplace(s).first;
+      it->second = hit.info->as_json();
+      seen.insert(it->first);
+      memUsed += s.size() + it->second.size();
+    }
+    else {
+      auto  & others = pkgMap["others"];
+      auto    it = others.try_emplace(hit.truncated ? s + "..." : s).first;
+      it->second = OtherToJson(s, hit.truncated);
+      if (! hit.truncated) {
+        seen.insert(it->first);
+      }
+      memUsed += s.size() + it->second.size();
+    }
+    memUsed += 2 * sizeof(PkgMap::mapped_type::value_type);
+    if (maxMemory && (memUsed >= maxMemory)) {
+      PrintPackages(pkgMap, showJson);
+      pkgMap.clear();
+      seen.clear();
+      memUsed = 0;
+    }
+    return true;
+  });
+  PrintPackages(pkgMap, showJson);
+  return rc;
+}
+
+//----------------------------------------------------------------------------
+//!  Queries the dwmwhat server listening on @c socketPath about each of
+//!  the given @c files and prints the results.
 //----------------------------------------------------------------------------
-static string GetJson(const vector<string> & vs)
+static int QueryServer(const string & socketPath,
+                       const vector<string> & files,
+                       const Dwm::Pkg::ScanFilter & filter, bool showJson)
 {
-  vector<string>  pkgsJson, others;
-  map<string,string>  infoMap;
-  for (const auto & s : vs) {
-    if (ParseAsDwmPkgInfo(s, infoMap)) {
-      pkgsJson.push_back(MapToJson(infoMap));
+  DwmWhat::Client  client;
+  if (! client.Connect(socketPath)) {
+    cerr << "Failed to connect to " << socketPath << ": "
+         << strerror(errno) << '\n';
+    return 1;
+  }
+  int  rc = 0;
+  vector<string>  hits;
+  string          error;
+  for (const auto & file : files) {
+    //  The server may not share our working directory.
+    char  *absPath = realpath(file.c_str(), nullptr);
+    if (! absPath) {
+      continue;
+    }
+    bool  ok = client.Query(absPath, hits, error);
+    free(absPath);
+    if (ok) {
+      PkgMap  pkgMap;
+      GetPkgMap(filter, hits, pkgMap);
+      PrintPackages(pkgMap, showJson);
     }
     else {
-      others.push_back(s);
+      cerr << file << ": " << error << '\n';
+      rc = 1;
     }
   }
+  return rc;
+}
 
-  string  rc;
-  if (pkgsJson.empty() && others.empty()) {  return rc; }
-  rc += "{\n";
-  if (! pkgsJson.empty()) {
-    rc += "  \"pkgs\": [";
-    std::string  comma;
-    for (const auto & pkg : pkgsJson) {
-      rc += comma + "\n";
-      rc += "      " + pkg;
-      comma = ",";
+//----------------------------------------------------------------------------
+//!  Scans the given @c files using @c numThreads threads, adding what we
+//!  find to @c inventory.  Each thread keeps many files in flight with a
+//!  BatchScanner (io_uring unless @c useUring is false).
+//!
+//!  Unless @c dedup is false, only the first ELF file we see with a given
+//!  build ID is scanned.  The others (copies of the same library in
+//!  different containers, hard links, etc.) get its strings afterward.
+//!
+//!  Files that @c journal says are finished (because they were read
+//!  from a checkpoint) are skipped, and each file is handed to
+//!  @c journal when it's finished.  If we pass @c deadline, no new files
+//!  are started; files already in flight are finished.  Returns the
+//!  number of files left unscanned.
+//----------------------------------------------------------------------------
+static size_t ScanFiles(const vector<string> & files, unsigned int numThreads,
+                        const Dwm::Pkg::Scanner & scanner, bool useUring,
+                        bool dedup, DwmWhat::Inventory & inventory,
+                        DwmWhat::Journal & journal,
+                        optional<chrono::steady_clock::time_point> deadline)
+{
+  //  When resuming, scan only the unfinished files.  fileIdxs maps an
+  //  index into paths to an index into files.
+  bool             resumed = (journal.NumFinished() > 0);
+  vector<string>   todo;
+  vector<uint32_t> fileIdxs;
+  if (resumed) {
+    for (uint32_t fileIdx = journal.Cursor(); fileIdx < files.size();
+         ++fileIdx) {
+      if (! journal.IsFinished(fileIdx)) {
+        todo.push_back(files[fileIdx]);
+        fileIdxs.push_back(fileIdx);
+      }
     }
-    rc += "\n  ]";
   }
-  if (! others.empty()) {
-    rc += ",  \n  \"others\": [";
-    std::string  comma;
-    for (const auto & pkg : others) {
-      rc += comma + "\n";
-      rc += "      { \"id\": \"" + pkg + "\" }";
-      comma = ",";
+  const vector<string>  & paths = resumed ? todo : files;
+  auto  origIdx = [&] (size_t idx) -> uint32_t
+  { return resumed ? fileIdxs[idx] : idx; };
+
+  atomic<size_t>  nextFile = 0;
+  atomic<size_t>  numDone = 0;
+  mutex           buildIdsMtx;
+  unordered_map<string,size_t>  buildIds;   // build ID -> file scanned
+  vector<pair<size_t,size_t>>   copies;     // (file scanned, copy)
+  vector<uint8_t>               isCopy(files.size(), 0);
+  
+  auto  claim = [&] (size_t idx, string_view buildId) {
+    size_t  fileIdx = origIdx(idx);
+    lock_guard<mutex>  lck(buildIdsMtx);
+    auto  [it, added] = buildIds.emplace(buildId, fileIdx);
+    if (! added) {
+      copies.push_back({it->second, fileIdx});
+      isCopy[fileIdx] = 1;
+    }
+    return added;
+  };
+  
+  auto  worker = [&] () {
+    Dwm::Pkg::BatchScanner  batch(scanner, 32, 128 * 1024, useUring);
+    if (dedup) {
+      batch.SetBuildIdCallback(claim);
+    }
+    batch.Run(paths, nextFile,
+              [&] (size_t idx, const Dwm::Pkg::ScanHit & hit) {
+                inventory.Add(origIdx(idx), hit.raw);
+                return true;
+              },
+              [&] (size_t idx) {
+                uint32_t  fileIdx = origIdx(idx);
+                inventory.FinishFile(fileIdx);
+                //  A copy is journaled after it gets its strings.
+                if (! isCopy[fileIdx]) {
+                  journal.FinishFile(fileIdx);
+                }
+                ++numDone;
+                if (deadline && (chrono::steady_clock::now() >= *deadline)) {
+                  nextFile = paths.size();
+                }
+              });
+  };
+
+  numThreads = std::max(1U, std::min<unsigned int>(numThreads, paths.size()));
+  vector<thread>  threads;
+  for (unsigned int i = 1; i < numThreads; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto & t : threads) {
+    t.join();
+  }
+  for (const auto & copy : copies) {
+    inventory.CopyFile(copy.first, copy.second);
+    journal.FinishFile(copy.second);
+  }
+  return (paths.size() - numDone);
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static string JsonEscape(const string & s)
+{
+  string  rc;
+  for (char c : s) {
+    switch (c) {
+      case '"':   rc += "\\\""; break;
+      case '\\':  rc += "\\\\"; break;
+      case '\n':  rc += "\\n";  break;
+      case '\t':  rc += "\\t";  break;
+      default:    rc += c;      break;
     }
-    rc += "  \n  ]";
   }
-  rc += "\n}\n";
   return rc;
 }
 
 //----------------------------------------------------------------------------
 //!  
 //----------------------------------------------------------------------------
-static pair<char *,size_t> MapFile(const string & filename)
+static string FileListJson(const vector<uint32_t> & fileIdxs,
+                           const vector<string> & files)
+{
+  string  rc("[");
+  string  comma;
+  for (auto fileIdx : fileIdxs) {
+    rc += comma + " \"" + JsonEscape(files[fileIdx]) + "\"";
+    comma = ",";
+  }
+  rc += " ]";
+  return rc;
+}
+
+//----------------------------------------------------------------------------
+//!  Orders (name, version, status) keys by name, then by version (so
+//!  "0.0.9" comes before "0.0.10"), then lexically.
+//----------------------------------------------------------------------------
+using PkgKey = array<string,3>;   // name, version, status
+
+struct PkgKeyLess
+{
+  bool operator () (const PkgKey & a, const PkgKey & b) const
+  {
+    if (a[0] != b[0]) {
+      return (a[0] < b[0]);
+    }
+    if (int cmp = Dwm::Pkg::Version(a[1]).Compare(Dwm::Pkg::Version(b[1]))) {
+      return (cmp < 0);
+    }
+    return (a < b);
+  }
+};
+
+//----------------------------------------------------------------------------
+//!  Prints the inverted index held in @c inventory: each unique
+//!  (name, version, status) of a Dwm::Pkg::Info and each other unique
+//!  string, followed by the list of files in which it was found.
+//!  Each unique string is parsed once, no matter how many files
+//!  contained it.
+//----------------------------------------------------------------------------
+static void PrintInventory(const DwmWhat::Inventory & inventory,
+                           const vector<string> & files, bool showJson)
+{
+  map<PkgKey,vector<uint32_t>,PkgKeyLess>  pkgs;
+  map<string,vector<uint32_t>>  others;
+  Dwm::Pkg::InfoView            info;
+  
+  inventory.ForEachUnique([&] (string_view hit,
+                               const vector<uint32_t> & fileIdxs) {
+    vector<uint32_t>  *dst;
+    if (info.Parse(hit)) {
+      dst = &pkgs[{string(info.name), string(info.version),
+                   string(info.status)}];
+    }
+    else {
+      dst = &others[StripSccsPrefix(string(hit))];
+    }
+    dst->insert(dst->end(), fileIdxs.begin(), fileIdxs.end());
+  });
+  for (auto & pkg : pkgs) {
+    sort(pkg.second.begin(), pkg.second.end());
+    auto  u = unique(pkg.second.begin(), pkg.second.end());
+    pkg.second.erase(u, pkg.second.end());
+  }
+  for (auto & other : others) {
+    sort(other.second.begin(), other.second.end());
+    auto  u = unique(other.second.begin(), other.second.end());
+    other.second.erase(u, other.second.end());
+  }
+  
+  if (! showJson) {
+    for (const auto & pkg : pkgs) {
+      cout << pkg.first[0] << ' ' << pkg.first[1] << ' ' << pkg.first[2]
+           << " (" << pkg.second.size() << ")\n";
+      for (auto fileIdx : pkg.second) {
+        cout << "  " << files[fileIdx] << '\n';
+      }
+    }
+    for (const auto & other : others) {
+      cout << other.first << " (" << other.second.size() << ")\n";
+      for (auto fileIdx : other.second) {
+        cout << "  " << files[fileIdx] << '\n';
+      }
+    }
+    FlushOutput(pkgs.size() + others.size());
+    return;
+  }
+
+  cout << "{\n  \"pkgs\": [";
+  string  comma;
+  for (const auto & pkg : pkgs) {
+    cout << comma << "\n    { \"name\": \"" << pkg.first[0]
+         << "\", \"version\": \"" << pkg.first[1]
+         << "\", \"status\": \"" << pkg.first[2]
+         << "\",\n      \"files\": " << FileListJson(pkg.second, files)
+         << " }";
+    comma = ",";
+  }
+  cout << "\n  ],\n  \"others\": [";
+  comma.clear();
+  for (const auto & other : others) {
+    cout << comma << "\n    { \"id\": \"" << JsonEscape(other.first)
+         << "\",\n      \"files\": " << FileListJson(other.second, files)
+         << " }";
+    comma = ",";
+  }
+  cout << "\n  ]\n}\n";
+  FlushOutput(pkgs.size() + others.size());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  Writes the contents of @c inventory as a binary snapshot to @c path.
+//!  Each unique string is parsed once.  Files that @c journal says
+//!  aren't finished (because we stopped at a deadline) are left out.
+//----------------------------------------------------------------------------
+static bool WriteSnapshot(const DwmWhat::Inventory & inventory,
+                          const vector<string> & files,
+                          const DwmWhat::Journal & journal,
+                          const string & path)
 {
-  pair<char *,size_t> rc(nullptr,0);
-  int  fd = open(filename.c_str(), O_RDONLY);
-  if (fd >= 0) {
-    struct stat  statbuf;
-    if (stat(filename.c_str(), &statbuf) == 0) {
-      rc.second = statbuf.st_size;
-      rc.first = (char *)mmap(0, statbuf.st_size, PROT_READ, MAP_FILE|MAP_SHARED, fd, 0);
-      if (rc.first == MAP_FAILED) {
-        rc.first = 0;
-        rc.second = 0;
+  DwmWhat::SnapshotWriter  writer;
+  unordered_map<uint32_t,optional<Dwm::Pkg::InfoView>>  parsed;
+  
+  for (uint32_t fileIdx = 0; fileIdx < inventory.NumFiles(); ++fileIdx) {
+    if (! journal.IsFinished(fileIdx)) {
+      continue;
+    }
+    uint32_t  snapIdx = writer.AddFile(files[fileIdx]);
+    for (auto id : inventory.FileHits(fileIdx)) {
+      string_view  raw = inventory.Strings().Get(id);
+      auto  it = parsed.find(id);
+      if (it == parsed.end()) {
+        Dwm::Pkg::InfoView  info;
+        it = parsed.emplace(id, nullopt).first;
+        if (info.Parse(raw)) {
+          it->second = info;
+        }
+      }
+      if (it->second) {
+        writer.AddPkg(snapIdx, *(it->second), raw);
+      }
+      else {
+        writer.AddOther(snapIdx, raw);
       }
     }
+  }
+  return writer.Write(path);
+}
+
+//----------------------------------------------------------------------------
+//!  Prints the package differences between the snapshots at @c oldPath
+//!  and @c newPath.  Returns 0 if there are no differences, 1 if there
+//!  are differences and 2 on error (like diff(1)).
+//----------------------------------------------------------------------------
+static int PrintSnapshotDiff(const string & oldPath, const string & newPath,
+                             bool showJson)
+{
+  DwmWhat::Snapshot  oldSnap, newSnap;
+  if (! oldSnap.Open(oldPath)) {
+    cerr << "Invalid snapshot " << oldPath << '\n';
+    return 2;
+  }
+  if (! newSnap.Open(newPath)) {
+    cerr << "Invalid snapshot " << newPath << '\n';
+    return 2;
+  }
+
+  size_t  numDiffs = 0;
+  if (showJson) {
+    cout << "[";
+  }
+  DwmWhat::DiffSnapshots(oldSnap, newSnap,
+                         [&] (const DwmWhat::SnapshotDiff & d) {
+    if (showJson) {
+      cout << (numDiffs ? ",\n" : "\n")
+           << "  { \"path\": \"" << JsonEscape(string(d.path))
+           << "\", \"name\": \"" << d.name << '"';
+      if (! d.oldVersion.empty()) {
+        cout << ", \"old\": { \"version\": \"" << d.oldVersion
+             << "\", \"status\": \"" << d.oldStatus << "\" }";
+      }
+      if (! d.newVersion.empty()) {
+        cout << ", \"new\": { \"version\": \"" << d.newVersion
+             << "\", \"status\": \"" << d.newStatus << "\" }";
+      }
+      cout << " }";
+    }
+    else {
+      cout << d.path << ": ";
+      if (d.oldVersion.empty()) {
+        cout << "+ " << d.name << ' ' << d.newVersion << ' ' << d.newStatus;
+      }
+      else if (d.newVersion.empty()) {
+        cout << "- " << d.name << ' ' << d.oldVersion << ' ' << d.oldStatus;
+      }
+      else {
+        cout << d.name << ' ' << d.oldVersion << ' ' << d.oldStatus
+             << " -> " << d.newVersion << ' ' << d.newStatus;
+      }
+      cout << '\n';
+    }
+    ++numDiffs;
+  });
+  if (showJson) {
+    cout << "\n]\n";
+  }
+  return (numDiffs ? 1 : 0);
+}
+
+//----------------------------------------------------------------------------
+//!  Prints the packages in the snapshot at @c path that pass @c filter,
+//!  in (name, version) order.  The name and version range are looked up
+//!  with binary searches of the snapshot's package index, so nothing is
+//!  rescanned and only the matching part of the index is visited.
+//!  Returns 0 if something matched, 1 if nothing matched and 2 on error.
+//----------------------------------------------------------------------------
+static int SelectFromSnapshot(const string & path,
+                              const Dwm::Pkg::ScanFilter & filter,
+                              bool showJson)
+{
+  DwmWhat::Snapshot  snap;
+  if (! snap.Open(path)) {
+    cerr << "Invalid snapshot " << path << '\n';
+    return 2;
+  }
+  size_t  numMatches = 0;
+  if (showJson) {
+    cout << "[";
+  }
+  for (const auto & ref : snap.FindPkgs(filter.name, filter.versionRange)) {
+    const DwmWhat::SnapshotPkg & pkg = snap.Pkg(ref);
+    Dwm::Pkg::InfoView  info;
+    info.type = snap.String(pkg.type);
+    info.status = snap.String(pkg.status);
+    info.name = snap.String(pkg.name);
+    info.version = snap.String(pkg.version);
+    info.copyright = snap.String(pkg.copyright);
+    info.date = snap.String(pkg.date);
+    info.other = snap.String(pkg.other);
+    if (! filter.Matches(info)) {
+      continue;
+    }
+    string_view  filePath = snap.String(snap.File(ref.file).path);
+    if (showJson) {
+      cout << (numMatches ? ",\n" : "\n")
+           << "  { \"path\": \"" << JsonEscape(string(filePath))
+           << "\", \"name\": \"" << info.name
+           << "\", \"version\": \"" << info.version
+           << "\", \"status\": \"" << info.status << "\" }";
+    }
+    else {
+      cout << filePath << ": " << info.name << ' ' << info.version << ' '
+           << info.status << '\n';
+    }
+    ++numMatches;
+  }
+  if (showJson) {
+    cout << "\n]\n";
+  }
+  return (numMatches ? 0 : 1);
+}
+
+//----------------------------------------------------------------------------
+//!  Scans the file at @c path and prints every hit in file order, with
+//!  duplicates, each with its virtual address and the (demangled) name
+//!  of the symbol that holds it, from the file's .symtab and .dynsym.
+//!  This tells apart copies of the same package linked in twice.  Hits
+//!  outside any symbol get just an address; in files that aren't ELF
+//!  they get a file offset ("+0x...").
+//----------------------------------------------------------------------------
+static bool ScanAndPrintSymbols(const Dwm::Pkg::Scanner & scanner,
+                                const string & path, bool showJson)
+{
+  int  fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat  statbuf;
+  if ((fstat(fd, &statbuf) != 0) || (! S_ISREG(statbuf.st_mode))) {
     close(fd);
+    return false;
   }
-  return rc;
+  size_t  len = statbuf.st_size;
+  if (0 == len) {
+    close(fd);
+    return true;
+  }
+  if (scanner.GetPolite()) {
+    scanner.GetPolite()->Take(len);
+  }
+  void  *p = mmap(0, len, PROT_READ, MAP_FILE|MAP_SHARED, fd, 0);
+  if (p == MAP_FAILED) {
+    close(fd);
+    return false;
+  }
+  const char  *data = (const char *)p;
+  
+  struct SymbolHit
+  {
+    size_t       offset;
+    string       where;
+    string       symbol;
+    string       line;
+    string       json;
+  };
+  vector<SymbolHit>  hits;
+  {
+    Dwm::Pkg::PageCacheGuard  guard(scanner.GetPolite(), fd, p, len);
+    Dwm::Pkg::SymbolIndex     index;
+    bool  isElf = index.Build(data, len);
+    unordered_map<string_view,string>  demangled;
+    scanner.ScanImage(data, len, [&] (const Dwm::Pkg::ScanHit & hit) {
+      SymbolHit  symHit;
+      symHit.offset = hit.offset;
+      ostringstream  where;
+      uint64_t  addr;
+      if (isElf && index.OffsetToAddr(hit.offset, addr)) {
+        where << "0x" << hex << addr;
+        string_view  sym = index.Find(addr);
+        if (! sym.empty()) {
+          auto  it = demangled.find(sym);
+          if (it == demangled.end()) {
+            it = demangled.emplace(sym, Dwm::Pkg::Demangle(sym)).first;
+          }
+          symHit.symbol = it->second;
+        }
+      }
+      else {
+        where << "+0x" << hex << hit.offset;
+      }
+      symHit.where = where.str();
+      string  s(hit.raw);
+      if (hit.info) {
+        symHit.line = StripSccsPrefix(s);
+        symHit.json = "\"pkg\": " + hit.info->as_json();
+      }
+      else {
+        symHit.line = StripSccsPrefix(s) + (hit.truncated ? "..." : "");
+        symHit.json = "\"other\": " + OtherToJson(s, hit.truncated);
+      }
+      hits.push_back(std::move(symHit));
+      return true;
+    });
+  }
+  munmap(p, len);
+  close(fd);
+  
+  sort(hits.begin(), hits.end(),
+       [] (const SymbolHit & a, const SymbolHit & b)
+       { return (a.offset < b.offset); });
+  if (! showJson) {
+    for (const auto & hit : hits) {
+      cout << hit.where;
+      if (! hit.symbol.empty()) {
+        cout << ' ' << hit.symbol;
+      }
+      cout << ": " << hit.line << '\n';
+    }
+  }
+  else if (! hits.empty()) {
+    cout << "{\n  \"hits\": [";
+    string  comma;
+    for (const auto & hit : hits) {
+      cout << comma << "\n    { \"offset\": " << hit.offset;
+      if (hit.where[0] != '+') {
+        cout << ", \"address\": \"" << hit.where << '"';
+      }
+      if (! hit.symbol.empty()) {
+        cout << ", \"symbol\": \"" << JsonEscape(hit.symbol) << '"';
+      }
+      cout << ",\n      " << hit.json << " }";
+      comma = ",";
+    }
+    cout << "\n  ]\n}\n";
+  }
+  if (! hits.empty()) {
+    FlushOutput(hits.size());
+  }
+  return true;
 }
 
 //----------------------------------------------------------------------------
-//!  
+//!  Watches the trees rooted at @c dirs and prints a line for each string
+//!  that appears in or disappears from a file under them.  With
+//!  @c showJson, each line is a JSON object.
 //----------------------------------------------------------------------------
-static vector<string> FindSccsStrings(const char * map, size_t size)
+static int WatchTrees(const vector<string> & dirs,
+                      const Dwm::Pkg::ScanFilter & filter,
+                      unsigned int debounceMsecs, bool showJson)
 {
-  vector<string>     rc;
-  size_t             i = 0;
-  while (i < (size - 5)) {
-    if ((map[i] == '@') && (map[i+1] == '(') && (map[i+2] == '#')
-        && (map[i+3] == ')')) {
-      string::size_type  startidx = i;
-      i += 4;
-      while ((map[i] != '\0') && (map[i] != '\n') && (i < size)) {
-        ++i;
+  Dwm::Pkg::Scanner  scanner(filter);
+  DwmWhat::Watcher   watcher(scanner, chrono::milliseconds(debounceMsecs),
+                             [&] (const DwmWhat::WatchDelta & d) {
+    if (showJson) {
+      Dwm::Pkg::InfoView  info;
+      cout << "{ \"op\": \"" << d.op << "\", \"path\": \""
+           << JsonEscape(string(d.path)) << "\", ";
+      if (info.Parse(d.hit)) {
+        cout << "\"pkg\": " << info.as_json();
       }
-      if (i < size) {
-        rc.push_back(string(&map[startidx], &map[i]));
+      else {
+        cout << "\"other\": " << OtherToJson(string(d.hit));
       }
+      cout << " }";
     }
     else {
-      ++i;
+      cout << d.op << ' ' << d.path << ": "
+           << StripSccsPrefix(string(d.hit));
+    }
+    cout << endl;
+  });
+  return (watcher.Run(dirs) ? 0 : 1);
+}
+
+//----------------------------------------------------------------------------
+//!  Writes the @c num buffers of @c iov straight to standard output with
+//!  writev(2), resuming after short writes.  Used for -v and -V, which
+//!  should print and exit without touching iostreams or the heap.
+//----------------------------------------------------------------------------
+static void WriteOut(struct iovec *iov, int num)
+{
+  while (num > 0) {
+    ssize_t  n = writev(STDOUT_FILENO, iov, num);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+    while ((num > 0) && ((size_t)n >= iov->iov_len)) {
+      n -= iov->iov_len;
+      ++iov;
+      --num;
+    }
+    if (num > 0) {
+      iov->iov_base = (char *)iov->iov_base + n;
+      iov->iov_len -= n;
     }
   }
-  return rc;
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  Returns an iovec for the constant @c s.
+//----------------------------------------------------------------------------
+static struct iovec ConstIov(string_view s)
+{
+  return { (void *)s.data(), s.size() };
+}
+
+//----------------------------------------------------------------------------
+//!  The number of iovecs JsonIov() fills.
+//----------------------------------------------------------------------------
+static constexpr int  k_jsonIovs = 18;
+
+//----------------------------------------------------------------------------
+//!  Fills @c iov with the pieces of Info::as_json() for the package with
+//!  fields @c f and Info::data_view() @c data, all pointing at constant
+//!  storage.  The id's "@(#)" prefix is taken from Dwm::Pkg::info, so
+//!  there's no second copy of it in the binary for what(1) to find.
+//!  Returns k_jsonIovs.
+//----------------------------------------------------------------------------
+static int JsonIov(const Dwm::Pkg::InfoFields & f, string_view data,
+                   struct iovec *iov)
+{
+  static constexpr string_view  idPrefix =
+    Dwm::Pkg::info.view().substr(0, Dwm::Pkg::info.view().size()
+                                 - Dwm::Pkg::info.data_view().size());
+  int  n = 0;
+  iov[n++] = ConstIov("{\"type\": \"");
+  iov[n++] = ConstIov(f.type);
+  iov[n++] = ConstIov("\", \"name\": \"");
+  iov[n++] = ConstIov(f.name);
+  iov[n++] = ConstIov("\", \"status\": \"");
+  iov[n++] = ConstIov(f.status);
+  iov[n++] = ConstIov("\", \"version\": \"");
+  iov[n++] = ConstIov(f.version);
+  iov[n++] = ConstIov("\", \"copyright\": \"");
+  iov[n++] = ConstIov(f.copyright);
+  iov[n++] = ConstIov("\", \"date\": \"");
+  iov[n++] = ConstIov(f.date);
+  iov[n++] = ConstIov("\", \"other\": \"");
+  iov[n++] = ConstIov(f.other);
+  iov[n++] = ConstIov("\", \"id\": \"");
+  iov[n++] = ConstIov(idPrefix);
+  iov[n++] = ConstIov(data);
+  iov[n++] = ConstIov("\"}");
+  return n;
 }
 
 #if defined(DWM_PKG_CAN_USE_REFLECTION)
 
 //----------------------------------------------------------------------------
-//!  
+//!  Returns the packages visible here, sorted and deduplicated at compile
+//!  time.
 //----------------------------------------------------------------------------
-static auto GetPackages()
+static std::span<const Dwm::Pkg::PackageRecord> GetPackages()
 {
-  auto pkgs = Dwm::Pkg::get_packages<^^Dwm>();
-  std::ranges::sort(pkgs);
-  auto u = std::ranges::unique(pkgs);
-  pkgs.erase(u.begin(), u.end());
+  static constexpr auto  pkgs = Dwm::Pkg::get_static_packages<^^Dwm>();
   return pkgs;
 }
 
 //----------------------------------------------------------------------------
-//!  
+//!  Prints our packages as a JSON array (@c verbose) or one per line,
+//!  gathering up to 64 pieces per writev(2).
 //----------------------------------------------------------------------------
-static void DumpPackagesJson()
+static void PrintVersion(bool verbose)
 {
-  auto pkgs = GetPackages();
-  
-  if (! pkgs.empty()) {
-    cout << "[\n";
-    bool  first = true;
-    for (auto & pkg : pkgs) {
-      if (! first) {
-        cout << ",\n  " << pkg.second.second;
+  auto  pkgs = GetPackages();
+  if (pkgs.empty()) {
+    return;
+  }
+  struct iovec  iov[64];
+  int           num = 0;
+  auto  add = [&] (string_view s) {
+    if (num == 64) {
+      WriteOut(iov, num);
+      num = 0;
+    }
+    iov[num++] = ConstIov(s);
+  };
+  if (verbose) {
+    add("[\n  ");
+  }
+  for (size_t i = 0; i < pkgs.size(); ++i) {
+    if (verbose) {
+      if (i) {
+        add(",\n  ");
       }
-      else {
-        cout << "  " << pkg.second.second;
-        first = false;
+      if (num > (64 - k_jsonIovs)) {
+        WriteOut(iov, num);
+        num = 0;
       }
+      Dwm::Pkg::InfoFields  fields;
+      Dwm::Pkg::SplitInfoData(pkgs[i].data, fields);
+      num += JsonIov(fields, pkgs[i].data, iov + num);
     }
-    cout << "\n]\n";
+    else {
+      add(pkgs[i].data);
+      add("\n");
+    }
+  }
+  if (verbose) {
+    add("\n]\n");
   }
+  WriteOut(iov, num);
   return;
 }
 
+#else
+
 //----------------------------------------------------------------------------
-//!  
+//!  Prints Dwm::Pkg::info as JSON (@c verbose) or as plain text.
 //----------------------------------------------------------------------------
-static void DumpPackagesPlain()
+static void PrintVersion(bool verbose)
 {
-  auto pkgs = GetPackages();
-  
-  if (! pkgs.empty()) {
-    for (auto & pkg : pkgs) {
-      cout << pkg.second.first << '\n';
-    }
+  if (verbose) {
+    static constexpr Dwm::Pkg::InfoFields  fields = Dwm::Pkg::info.fields();
+    struct iovec  iov[k_jsonIovs + 2];
+    int           num = 0;
+    iov[num++] = ConstIov("[\n  ");
+    num += JsonIov(fields, Dwm::Pkg::info.data_view(), iov + num);
+    iov[num++] = ConstIov("\n]\n");
+    WriteOut(iov, num);
+  }
+  else {
+    struct iovec  iov[] = { ConstIov(Dwm::Pkg::info.data_view()),
+                            ConstIov("\n") };
+    WriteOut(iov, 2);
   }
   return;
 }
 
 #endif
 
+//----------------------------------------------------------------------------
+//!  Scans the ELF core file at @c path with @c numThreads threads and
+//!  prints what was found, grouped by the file that was mapped where it
+//!  was found (from the core's NT_FILE note).  Strings found in memory
+//!  that wasn't mapped from a file are grouped under "[anonymous]".
+//!  Returns 0 if anything was found, 1 if not, 2 on error.
+//----------------------------------------------------------------------------
+static int ScanCore(const string & path, const Dwm::Pkg::Scanner & scanner,
+                    unsigned int numThreads, bool showJson)
+{
+  Dwm::Pkg::CoreScanner  core(scanner, numThreads);
+  if (! core.Open(path)) {
+    cerr << "Not an ELF core file: " << path << '\n';
+    return 2;
+  }
+  mutex              mtx;
+  map<string,PkgMap>  byFile;
+  core.Scan([&] (const Dwm::Pkg::CoreHit & coreHit) {
+    const Dwm::Pkg::ScanHit  & hit = coreHit.hit;
+    string  file(coreHit.mapping ? coreHit.mapping->path : "[anonymous]");
+    string  s(hit.raw);
+    lock_guard<mutex>  lck(mtx);
+    PkgMap  & pkgMap = byFile[file];
+    if (hit.info) {
+      pkgMap["pkgs"][s] = hit.info->as_json();
+    }
+    else if (hit.truncated) {
+      pkgMap["others"][s + "..."] = OtherToJson(s, true);
+    }
+    else {
+      pkgMap["others"][s] = OtherToJson(s);
+    }
+    return true;
+  });
+
+  if (! showJson) {
+    for (const auto & file : byFile) {
+      cout << file.first << '\n';
+      for (const char *key : { "pkgs", "others" }) {
+        auto  it = file.second.find(key);
+        if (it != file.second.end()) {
+          for (const auto & hit : it->second) {
+            cout << "  " << StripSccsPrefix(hit.first) << '\n';
+          }
+        }
+      }
+    }
+  }
+  else {
+    cout << "{\n  \"core\": \"" << JsonEscape(path) << "\",\n  \"files\": [";
+    string  comma;
+    for (const auto & file : byFile) {
+      cout << comma << "\n    { \"path\": \"" << JsonEscape(file.first) << '"';
+      for (const char *key : { "pkgs", "others" }) {
+        auto  it = file.second.find(key);
+        if (it != file.second.end()) {
+          cout << ",\n      \"" << key << "\": [";
+          string  hitComma;
+          for (const auto & hit : it->second) {
+            cout << hitComma << "\n        " << hit.second;
+            hitComma = ",";
+          }
+          cout << "\n      ]";
+        }
+      }
+      cout << " }";
+      comma = ",";
+    }
+    cout << "\n  ]\n}\n";
+  }
+  FlushOutput(byFile.size());
+  return (byFile.empty() ? 1 : 0);
+}
+
+//----------------------------------------------------------------------------
+//!  Prints the packages published (see Dwm::Pkg::PublishManifest()) by
+//!  running processes, in pid order, keeping those that pass @c filter.
+//!  Each process costs one small read, so this is cheap enough to run
+//!  every minute on a busy host.  Returns 0 if anything was found, 1 if
+//!  not.
+//----------------------------------------------------------------------------
+static int CollectPackages(const Dwm::Pkg::ScanFilter & filter,
+                           bool showJson)
+{
+  map<pid_t,pair<string,PkgMap>>  byPid;
+  Dwm::Pkg::CollectManifests(Dwm::Pkg::ManifestDir(),
+                             [&] (const Dwm::Pkg::Manifest & manifest) {
+    vector<string>  hits(manifest.Packages().begin(),
+                         manifest.Packages().end());
+    PkgMap  pkgMap;
+    GetPkgMap(filter, hits, pkgMap);
+    if (pkgMap.count("pkgs")) {
+      byPid[manifest.Pid()] = { string(manifest.Program()),
+                                std::move(pkgMap) };
+    }
+    return true;
+  });
+
+  if (! showJson) {
+    for (const auto & proc : byPid) {
+      cout << proc.first << ' ' << proc.second.first << '\n';
+      for (const auto & pkg : proc.second.second.at("pkgs")) {
+        cout << "  " << StripSccsPrefix(pkg.first) << '\n';
+      }
+    }
+  }
+  else {
+    cout << "[";
+    string  comma;
+    for (const auto & proc : byPid) {
+      cout << comma << "\n  { \"pid\": " << proc.first
+           << ", \"program\": \"" << JsonEscape(proc.second.first)
+           << "\",\n    \"pkgs\": [";
+      string  pkgComma;
+      for (const auto & pkg : proc.second.second.at("pkgs")) {
+        cout << pkgComma << "\n      " << pkg.second;
+        pkgComma = ",";
+      }
+      cout << "\n    ] }";
+      comma = ",";
+    }
+    cout << "\n]\n";
+  }
+  FlushOutput(byPid.size());
+  return (byPid.empty() ? 1 : 0);
+}
+
+//----------------------------------------------------------------------------
+//!  Gives us (and threads we create later) the lowest CPU priority and
+//!  idle I/O priority, so we only use the disk when nobody else wants it.
+//----------------------------------------------------------------------------
+static void LowerPriority()
+{
+  if (setpriority(PRIO_PROCESS, 0, 19) != 0) {
+    cerr << "setpriority() failed: " << strerror(errno) << '\n';
+  }
+#if defined(__linux__) && defined(SYS_ioprio_set)
+  //  IOPRIO_WHO_PROCESS, IOPRIO_PRIO_VALUE(IOPRIO_CLASS_IDLE, 0)
+  if (syscall(SYS_ioprio_set, 1, 0, 3 << 13) != 0) {
+    cerr << "ioprio_set() failed: " << strerror(errno) << '\n';
+  }
+#elif defined(__APPLE__)
+  setiopolicy_np(IOPOL_TYPE_DISK, IOPOL_SCOPE_PROCESS, IOPOL_THROTTLE);
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  Parses a rate in bytes per second, with an optional K, M or G
+//!  (binary) suffix.  Returns false if @c s is invalid.
+//----------------------------------------------------------------------------
+static bool ParseRate(const char *s, uint64_t & rate)
+{
+  char  *end;
+  errno = 0;
+  rate = strtoull(s, &end, 10);
+  if ((end == s) || errno) {
+    return false;
+  }
+  switch (*end) {
+    case 'K': case 'k':  rate <<= 10; ++end;  break;
+    case 'M': case 'm':  rate <<= 20; ++end;  break;
+    case 'G': case 'g':  rate <<= 30; ++end;  break;
+    default:                                  break;
+  }
+  return (*end == '\0');
+}
+
+//----------------------------------------------------------------------------
+//!  Parses a duration in seconds, with an optional s, m or h suffix.
+//!  Returns false if @c s is invalid.
+//----------------------------------------------------------------------------
+static bool ParseDuration(const char *s, chrono::seconds & duration)
+{
+  char  *end;
+  errno = 0;
+  unsigned long long  n = strtoull(s, &end, 10);
+  if ((end == s) || errno) {
+    return false;
+  }
+  switch (*end) {
+    case 's':                 ++end;  break;
+    case 'm':  n *= 60;       ++end;  break;
+    case 'h':  n *= 60 * 60;  ++end;  break;
+    default:                          break;
+  }
+  duration = chrono::seconds(n);
+  return (*end == '\0');
+}
+
+//----------------------------------------------------------------------------
+//!  Appends the paths in the file at @c path (one per line; "-" for
+//!  standard input) to @c files.  For lists too long for the command
+//!  line.  Returns false if the file can't be read.
+//----------------------------------------------------------------------------
+static bool ReadFileList(const string & path, vector<string> & files)
+{
+  ifstream  ifs;
+  if (path != "-") {
+    ifs.open(path);
+    if (! ifs) {
+      return false;
+    }
+  }
+  istream  & is = (path == "-") ? cin : ifs;
+  string     line;
+  while (getline(is, line)) {
+    if (! line.empty()) {
+      files.push_back(line);
+    }
+  }
+  return (! is.bad());
+}
+
+//----------------------------------------------------------------------------
+//!  Returns the key for a checkpoint journal of a scan of @c files with
+//!  @c filter: a hash of the file list and of everything in the filter
+//!  that changes what we find.
+//----------------------------------------------------------------------------
+static uint64_t JournalKey(const vector<string> & files,
+                           const Dwm::Pkg::ScanFilter & filter)
+{
+  string  opts = filter.name + '\0' + filter.status + '\0' + filter.type;
+  for (const auto & range : filter.versionRange) {
+    opts += '\0' + range.first + range.second;
+  }
+  opts += '\0' + to_string(filter.limit) + '\0' + to_string(filter.maxLength)
+    + (filter.allBytes ? "A" : "");
+  uint64_t  key = Dwm::Pkg::InfoHash(opts);
+  for (const auto & file : files) {
+    key = (key ^ Dwm::Pkg::InfoHash(file)) * 0x9E3779B97F4A7C15ULL;
+  }
+  return key;
+}
+
+//----------------------------------------------------------------------------
+//!  Tells the user how polite we were.
+//----------------------------------------------------------------------------
+static void ReportPoliteness(const Dwm::Pkg::Polite & polite,
+                             chrono::steady_clock::duration elapsed)
+{
+  double  secs = chrono::duration<double>(elapsed).count();
+  double  mib = polite.BytesTaken() / (1024.0 * 1024.0);
+  cerr << "dwmwhat: polite: " << fixed << setprecision(1) << mib
+       << " MiB in " << setprecision(2) << secs << "s ("
+       << setprecision(1) << (secs > 0 ? (mib / secs) : 0.0) << " MiB/s";
+  if (polite.BytesPerSec()) {
+    cerr << ", limit " << (polite.BytesPerSec() / (1024.0 * 1024.0))
+         << " MiB/s";
+  }
+  cerr << "), throttled " << polite.NumThrottled() << " times for "
+       << setprecision(2) << (polite.ThrottledNsecs() / 1e9) << "s";
+  if (polite.DropCache()) {
+    cerr << ", dropped " << polite.PagesDropped()
+         << " pages from the page cache (" << polite.PagesKept()
+         << " already cached were kept)";
+  }
+  cerr << '\n';
+  return;
+}
+
 //----------------------------------------------------------------------------
 //!  
 //----------------------------------------------------------------------------
 static void Usage(const char *argv0)
 {
-  std::cerr << "Usage: " << argv0 << " [-v|-V] [-j] files...\n";
+  std::cerr << "Usage: " << argv0 << " [-v|-V] [-j] [-a] [-A] [-t threads]"
+            << " [-o snapshot]\n"
+            << "         [-n name] [-s dev|rc|rel] [-T hdr|lib|exe|doc]"
+            << " [-r versionrange]\n"
+            << "         [-1] [-m limit] [-L maxlength] [-M maxmemory]"
+            << " [--symbols] files...\n"
+            << "       " << argv0 << " -a|-o snapshot [options]"
+            << " [--checkpoint journal [--resume]]\n"
+            << "         [--deadline secs[s|m|h]] [--files-from list]"
+            << " [files...]\n"
+            << "       " << argv0 << " [-j] --diff oldsnapshot newsnapshot\n"
+            << "       " << argv0 << " [-j] [filters] --select snapshot\n"
+            << "       " << argv0 << " [-j] [-t threads] [filters]"
+            << " --core corefile\n"
+            << "       " << argv0 << " [-j] [filters] --collect\n"
+            << "       " << argv0 << " [-t threads] --serve socket\n"
+            << "       " << argv0 << " [-j] [filters] --query socket files...\n"
+            << "       " << argv0 << " [-j] [filters] [--debounce msecs]"
+            << " --watch dirs...\n";
   return;
 }
 
@@ -387,12 +1319,166 @@ static void Usage(const char *argv0)
 int main(int argc, char *argv[])
 {
   bool  showVersion = false, showVerbose = false, showAsJson = false;
+  bool  aggregate = false, diff = false, watch = false, useUring = true;
+  bool  dedup = true, polite = false, collect = false, symbols = false;
+  optional<uint64_t>  rate;
+  unsigned int  debounceMsecs = 200;
+  size_t        maxMemory = 64 * 1024 * 1024;
+  unsigned int  numThreads = 1;
+  string  snapshotPath, checkpointPath, filesFrom;
+  bool    resume = false;
+  optional<chrono::seconds>  deadline;
+  Dwm::Pkg::ScanFilter  filter;
+  
+  string  servePath, queryPath, selectPath, corePath;
+  
+  enum { k_optDiff = 256, k_optServe, k_optQuery,
+         k_optWatch, k_optDebounce, k_optNoUring, k_optSelect,
+         k_optNoBuildId, k_optPolite, k_optRate, k_optCore,
+         k_optCollect, k_optSymbols, k_optCheckpoint, k_optResume,
+         k_optDeadline, k_optFilesFrom };
+  static const struct option  longOpts[] = {
+    { "aggregate",  no_argument,       nullptr, 'a' },
+    { "all-bytes",  no_argument,       nullptr, 'A' },
+    { "first",      no_argument,       nullptr, '1' },
+    { "json",       no_argument,       nullptr, 'j' },
+    { "limit",      required_argument, nullptr, 'm' },
+    { "max-length", required_argument, nullptr, 'L' },
+    { "max-memory", required_argument, nullptr, 'M' },
+    { "name",       required_argument, nullptr, 'n' },
+    { "range",      required_argument, nullptr, 'r' },
+    { "snapshot",   required_argument, nullptr, 'o' },
+    { "status",     required_argument, nullptr, 's' },
+    { "threads",    required_argument, nullptr, 't' },
+    { "type",       required_argument, nullptr, 'T' },
+    { "diff",       no_argument,       nullptr, k_optDiff },
+    { "serve",      required_argument, nullptr, k_optServe },
+    { "query",      required_argument, nullptr, k_optQuery },
+    { "watch",      no_argument,       nullptr, k_optWatch },
+    { "debounce",   required_argument, nullptr, k_optDebounce },
+    { "no-uring",   no_argument,       nullptr, k_optNoUring },
+    { "select",     required_argument, nullptr, k_optSelect },
+    { "no-build-id", no_argument,      nullptr, k_optNoBuildId },
+    { "polite",     no_argument,       nullptr, k_optPolite },
+    { "rate",       required_argument, nullptr, k_optRate },
+    { "core",       required_argument, nullptr, k_optCore },
+    { "collect",    no_argument,       nullptr, k_optCollect },
+    { "symbols",    no_argument,       nullptr, k_optSymbols },
+    { "checkpoint", required_argument, nullptr, k_optCheckpoint },
+    { "resume",     no_argument,       nullptr, k_optResume },
+    { "deadline",   required_argument, nullptr, k_optDeadline },
+    { "files-from", required_argument, nullptr, k_optFilesFrom },
+    { nullptr,      0,                 nullptr, 0 }
+  };
+  
   int  optChar;
-  while ((optChar = getopt(argc, argv, "jvV")) != -1) {
+  while ((optChar = getopt_long(argc, argv, "1aAjL:m:M:n:o:r:s:t:T:vV",
+                                longOpts, nullptr)) != -1) {
     switch (optChar) {
+      case '1':
+        filter.limit = 1;
+        break;
+      case 'a':
+        aggregate = true;
+        break;
+      case 'A':
+        filter.allBytes = true;
+        break;
+      case 'L':
+        filter.maxLength = strtoul(optarg, nullptr, 10);
+        break;
+      case 'm':
+        filter.limit = strtoul(optarg, nullptr, 10);
+        break;
+      case 'M':
+        maxMemory = strtoull(optarg, nullptr, 10);
+        break;
+      case 'n':
+        filter.name = optarg;
+        break;
+      case 'r':
+        if (! filter.SetVersionRange(optarg)) {
+          cerr << "Invalid version range '" << optarg << "'\n";
+          return 1;
+        }
+        break;
+      case 's':
+        filter.SetStatus(optarg);
+        break;
+      case 'T':
+        filter.SetType(optarg);
+        break;
       case 'j':
         showAsJson = true;
         break;
+      case 'o':
+        snapshotPath = optarg;
+        break;
+      case k_optDiff:
+        diff = true;
+        break;
+      case k_optServe:
+        servePath = optarg;
+        break;
+      case k_optQuery:
+        queryPath = optarg;
+        break;
+      case k_optWatch:
+        watch = true;
+        break;
+      case k_optDebounce:
+        debounceMsecs = strtoul(optarg, nullptr, 10);
+        break;
+      case k_optNoUring:
+        useUring = false;
+        break;
+      case k_optNoBuildId:
+        dedup = false;
+        break;
+      case k_optPolite:
+        polite = true;
+        break;
+      case k_optCore:
+        corePath = optarg;
+        break;
+      case k_optCollect:
+        collect = true;
+        break;
+      case k_optSymbols:
+        symbols = true;
+        break;
+      case k_optCheckpoint:
+        checkpointPath = optarg;
+        break;
+      case k_optResume:
+        resume = true;
+        break;
+      case k_optFilesFrom:
+        filesFrom = optarg;
+        break;
+      case k_optDeadline:
+        deadline.emplace();
+        if (! ParseDuration(optarg, *deadline)) {
+          cerr << "Invalid deadline '" << optarg << "'\n";
+          return 1;
+        }
+        break;
+      case k_optRate:
+        rate.emplace();
+        if (! ParseRate(optarg, *rate)) {
+          cerr << "Invalid rate '" << optarg << "'\n";
+          return 1;
+        }
+        break;
+      case k_optSelect:
+        selectPath = optarg;
+        break;
+      case 't':
+        numThreads = strtoul(optarg, nullptr, 10);
+        if (0 == numThreads) {
+          numThreads = thread::hardware_concurrency();
+        }
+        break;
       case 'v':
         showVersion = true;
         break;
@@ -408,37 +1494,177 @@ int main(int argc, char *argv[])
   }
 
   if (showVersion) {
-#if defined(DWM_PKG_CAN_USE_REFLECTION)
-    if (showVerbose) {
-      DumpPackagesJson();
+    PrintVersion(showVerbose);
+    return 0;
+  }
+
+  //  Checkpoints, deadlines and file lists are for aggregate and
+  //  snapshot modes.
+  if ((resume && checkpointPath.empty())
+      || (((! checkpointPath.empty()) || deadline || (! filesFrom.empty()))
+          && (! (aggregate || (! snapshotPath.empty()))))) {
+    Usage(argv[0]);
+    return 2;
+  }
+
+  if (polite) {
+    LowerPriority();
+  }
+  
+  if (collect) {
+    if (optind != argc) {
+      Usage(argv[0]);
+      return 2;
     }
-    else {
-      DumpPackagesPlain();
+    return CollectPackages(filter, showAsJson);
+  }
+  
+  if (! servePath.empty()) {
+    Dwm::Pkg::ManifestPublisher  manifest;
+    DwmWhat::Server  server(servePath, numThreads);
+    if (! server.Run()) {
+      cerr << "Failed to listen on " << servePath << ": "
+           << strerror(errno) << '\n';
+      return 1;
     }
-#else
-    if (showVerbose) {
-      std::cout << "[\n"
-                << "  " << Dwm::Pkg::info.as_json() << '\n'
-                << "]\n";
+    return 0;
+  }
+  if (! queryPath.empty()) {
+    return QueryServer(queryPath, vector<string>(&argv[optind], &argv[argc]),
+                       filter, showAsJson);
+  }
+  
+  if (watch) {
+    if (optind >= argc) {
+      Usage(argv[0]);
+      return 1;
     }
-    else {
-      std::cout << Dwm::Pkg::info.data_view() << '\n';
+    Dwm::Pkg::ManifestPublisher  manifest;
+    return WatchTrees(vector<string>(&argv[optind], &argv[argc]), filter,
+                      debounceMsecs, showAsJson);
+  }
+  
+  if (! selectPath.empty()) {
+    if (optind != argc) {
+      Usage(argv[0]);
+      return 2;
     }
-#endif
-    return 0;
+    return SelectFromSnapshot(selectPath, filter, showAsJson);
+  }
+  
+  if (diff) {
+    if ((argc - optind) != 2) {
+      Usage(argv[0]);
+      return 2;
+    }
+    return PrintSnapshotDiff(argv[optind], argv[optind+1], showAsJson);
   }
+  
+  //  --polite without --rate gets a default rate limit.
+  optional<Dwm::Pkg::Polite>  politeness;
+  if (polite || rate) {
+    politeness.emplace(rate ? *rate : k_defaultPoliteRate, polite);
+  }
+  auto  start = chrono::steady_clock::now();
 
+  if (! corePath.empty()) {
+    if (optind != argc) {
+      Usage(argv[0]);
+      return 2;
+    }
+    Dwm::Pkg::Scanner  scanner(filter);
+    if (politeness) {
+      scanner.SetPolite(&*politeness);
+    }
+    int  rc = ScanCore(corePath, scanner, numThreads, showAsJson);
+    if (politeness) {
+      ReportPoliteness(*politeness, chrono::steady_clock::now() - start);
+    }
+    return rc;
+  }
+  
   int  rc = 0;
-  for (int arg = optind; arg < argc; ++arg) {
-    pair<char *,size_t>  mf = MapFile(argv[arg]);
-    if (mf.first) {
-      vector<string>  sccsStrings = FindSccsStrings(mf.first, mf.second);
-      PkgMap  pkgMap;
-      GetPkgMap(sccsStrings, pkgMap);
-      PrintPackages(pkgMap, showAsJson);
+  if (aggregate || (! snapshotPath.empty())) {
+    //  Unique strings are parsed once after scanning, so the scanner
+    //  doesn't need to parse unless the filter needs it.
+    Dwm::Pkg::Scanner   scanner(filter, false);
+    if (politeness) {
+      scanner.SetPolite(&*politeness);
+    }
+    vector<string>      files(&argv[optind], &argv[argc]);
+    if ((! filesFrom.empty()) && (! ReadFileList(filesFrom, files))) {
+      cerr << "Failed to read file list " << filesFrom << '\n';
+      return 1;
+    }
+    DwmWhat::Inventory  inventory(files.size());
+    DwmWhat::Journal    journal(inventory, JournalKey(files, filter));
+    if ((! checkpointPath.empty())
+        && (! journal.Open(checkpointPath, resume))) {
+      if (resume) {
+        cerr << "Can't resume from checkpoint " << checkpointPath
+             << " (missing, unreadable, or not from a scan of the same"
+             << " files with the same filters)\n";
+      }
+      else {
+        cerr << "Failed to create checkpoint " << checkpointPath << ": "
+             << strerror(errno) << '\n';
+      }
+      return 1;
+    }
+    if (journal.NumResumed()) {
+      cerr << "dwmwhat: resuming: " << journal.NumResumed() << " of "
+           << files.size() << " files already scanned\n";
+    }
+    optional<chrono::steady_clock::time_point>  stopAt;
+    if (deadline) {
+      stopAt = start + *deadline;
+    }
+    size_t  unscanned = ScanFiles(files, numThreads, scanner, useUring,
+                                  dedup, inventory, journal, stopAt);
+    if (politeness) {
+      ReportPoliteness(*politeness, chrono::steady_clock::now() - start);
+    }
+    if (! journal.Flush()) {
+      cerr << "Failed to write checkpoint " << checkpointPath << '\n';
+      rc = 1;
+    }
+    if (unscanned) {
+      cerr << "dwmwhat: deadline reached: " << unscanned << " of "
+           << files.size() << " files not scanned";
+      if (! checkpointPath.empty()) {
+        cerr << " (use --resume to continue)";
+      }
+      cerr << '\n';
+    }
+    if (! snapshotPath.empty()) {
+      if (! WriteSnapshot(inventory, files, journal, snapshotPath)) {
+        cerr << "Failed to write snapshot " << snapshotPath << '\n';
+        rc = 1;
+      }
+    }
+    if (aggregate) {
+      PrintInventory(inventory, files, showAsJson);
+    }
+    if (unscanned && (rc == 0)) {
+      rc = 3;
+    }
+    return rc;
+  }
 
-      munmap(mf.first, mf.second);
+  Dwm::Pkg::Scanner  scanner(filter);
+  if (politeness) {
+    scanner.SetPolite(&*politeness);
+  }
+  for (int arg = optind; arg < argc; ++arg) {
+    if (symbols) {
+      ScanAndPrintSymbols(scanner, argv[arg], showAsJson);
     }
+    else {
+      ScanAndPrint(scanner, argv[arg], showAsJson, maxMemory);
+    }
+  }
+  if (politeness) {
+    ReportPoliteness(*politeness, chrono::steady_clock::now() - start);
   }
   return rc;
 }
@@ -53,7 +53,9 @@
 #  endif
 #endif
 
+#include <algorithm>
 #include <cassert>
+#include <span>
 #include <string>
 #include <utility>
 #include <variant>
@@ -61,6 +63,7 @@
 
 #include "DwmPkgStringLiteral.hh"
 #include "DwmPkgInfo.hh"
+#include "DwmPkgPackageIndex.hh"
 
 namespace Dwm {
 
@@ -239,6 +242,61 @@ namespace Dwm {
     { return get_templates_of_in_nses<^^Dwm::Pkg::Info,NSes...>(); }
     // { return get_templates_of_in_nses_2<^^Dwm::Pkg::Info,NSes...>(); }
 
+    //------------------------------------------------------------------------
+    //!  One package in the table returned by get_static_packages().  All
+    //!  members point to null-terminated strings in static storage.
+    //!  There's no id (Info::view()) or JSON here: each would be another
+    //!  "@(#)" string in the binary, found by what(1) alongside the Info
+    //!  itself.  The id is "@(#)" DWM_PKG_DELIM followed by @c data, and
+    //!  SplitInfoData() recovers the fields of @c data.
+    //------------------------------------------------------------------------
+    struct PackageRecord
+    {
+      const char  *fqn;    // "fully qualified" name of the Info variable
+      const char  *data;   // Info::data_view()
+    };
+
+    //------------------------------------------------------------------------
+    //!  Like get_packages(), but everything is done at compile time: the
+    //!  packages are sorted and deduplicated (in the same order as sorting
+    //!  the result of get_packages()) and placed in a static array with
+    //!  define_static_array().  Enumerating the result at runtime is a
+    //!  walk over a constant array, with no allocation.
+    //!
+    //!  static constexpr auto  pkgs = get_static_packages<^^Dwm>();
+    //!  for (const auto & pkg : pkgs) { std::cout << pkg.data << '\n'; }
+    //------------------------------------------------------------------------
+    template <std::meta::info ...NSes>
+    consteval std::span<const PackageRecord> get_static_packages()
+    {
+      auto  pkgs = get_packages<NSes...>();
+      std::ranges::sort(pkgs);
+      auto  u = std::ranges::unique(pkgs);
+      pkgs.erase(u.begin(), u.end());
+
+      std::vector<PackageRecord>  recs;
+      for (const auto & pkg : pkgs) {
+        recs.push_back({std::define_static_string(pkg.first),
+                        std::define_static_string(pkg.second.first)});
+      }
+      return std::define_static_array(recs);
+    }
+
+    //------------------------------------------------------------------------
+    //!  Returns a PackageIndex of the packages found by
+    //!  get_static_packages<NSes...>().
+    //------------------------------------------------------------------------
+    template <std::meta::info ...NSes>
+    consteval auto make_package_index()
+    {
+      constexpr auto  recs = get_static_packages<NSes...>();
+      std::array<std::string_view,recs.size()>  data;
+      for (std::size_t i = 0; i < recs.size(); ++i) {
+        data[i] = recs[i].data;
+      }
+      return PackageIndex<recs.size()>(data);
+    }
+
 #if 0
     //------------------------------------------------------------------------
     //!  A structural class literal to hold a string literal so we can pass
@@ -332,6 +390,40 @@ namespace Dwm {
     }
 
 #endif  // defined(DWM_PKG_CAN_USE_REFLECTION)
+
+    //------------------------------------------------------------------------
+    //!  Returns the fields of the package named @c name, or nullptr if
+    //!  there is none.  O(1): one hash of @c name and one comparison,
+    //!  with no allocation (see PackageIndex).
+    //!
+    //!  if (auto pkg = Dwm::Pkg::find("libDwmPkg")) {
+    //!    std::cout << pkg->version << '\n';
+    //!  }
+    //!
+    //!  The packages known to find() are those visible in the calling
+    //!  translation unit.  With reflection, that's all of the Info objects
+    //!  under namespace Dwm.  Without reflection, it's the Info objects
+    //!  listed in DWM_PKG_FIND_LIST, which may be defined before including
+    //!  this file (after the headers that declare the objects), e.g.
+    //!
+    //!  #define DWM_PKG_FIND_LIST  ::Dwm::Pkg::info, ::MyPkg::info
+    //------------------------------------------------------------------------
+#if defined(DWM_PKG_CAN_USE_REFLECTION)
+    static constexpr const InfoFields * find(std::string_view name) noexcept
+    {
+      static constexpr auto  pkgIndex = make_package_index<^^Dwm>();
+      return pkgIndex.find(name);
+    }
+#else
+#  ifndef DWM_PKG_FIND_LIST
+#    define DWM_PKG_FIND_LIST  ::Dwm::Pkg::info
+#  endif
+    static constexpr auto  g_packageIndex =
+      make_package_index(DWM_PKG_FIND_LIST);
+    
+    static constexpr const InfoFields * find(std::string_view name) noexcept
+    { return g_packageIndex.find(name); }
+#endif
     
   }  // namespace Pkg
 
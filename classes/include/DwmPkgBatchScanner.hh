@@ -0,0 +1,170 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+
+//---------------------------------------------------------------------------
+//!  \file DwmPkgBatchScanner.hh
+//!  \author Daniel W. McRobb
+//!  \brief Dwm::Pkg::BatchScanner class declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMPKGBATCHSCANNER_HH_
+#define _DWMPKGBATCHSCANNER_HH_
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "DwmPkgScanner.hh"
+
+namespace Dwm {
+
+  namespace Pkg {
+
+    //------------------------------------------------------------------------
+    //!  Called once per hit with the index of the file it came from.
+    //!  Return false to stop scanning that file.
+    //------------------------------------------------------------------------
+    using BatchCallback = std::function<bool(std::size_t, const ScanHit &)>;
+
+    //------------------------------------------------------------------------
+    //!  Called once per file, after its last hit, with the file's index.
+    //------------------------------------------------------------------------
+    using BatchDoneCallback = std::function<void(std::size_t)>;
+
+    //------------------------------------------------------------------------
+    //!  Called with the index of a file and its ELF build ID (see
+    //!  FindBuildId()) before the file is scanned.  Return false to skip
+    //!  scanning it, e.g. because a file with the same build ID has
+    //!  already been (or is being) scanned.
+    //------------------------------------------------------------------------
+    using BuildIdCallback =
+      std::function<bool(std::size_t, std::string_view)>;
+    
+    //------------------------------------------------------------------------
+    //!  Scans many files with a Scanner, keeping many of them in flight at
+    //!  once.  This is for large sets of small files, where the open,
+    //!  stat, map, unmap and close system calls for each file cost more
+    //!  than scanning it.
+    //!
+    //!  On Linux, an io_uring is used when the kernel supports it: opens,
+    //!  statx calls and reads for up to @c depth files are queued at once
+    //!  into a fixed set of registered buffers, and files are scanned as
+    //!  their reads complete.  Otherwise each file is opened and read into
+    //!  a reused buffer with plain system calls.  Either way, files larger
+    //!  than the buffer size (and anything that isn't a regular file) are
+    //!  handed to Scanner::ScanFd().
+    //!
+    //!  If the Scanner has a Polite object (see Scanner::SetPolite()),
+    //!  io_uring isn't used: files are read one at a time, paced by its
+    //!  token bucket.
+    //!
+    //!  A BatchScanner is not thread safe.  Use one per thread; several
+    //!  can share the @c next counter passed to Run() to split the work.
+    //------------------------------------------------------------------------
+    class BatchScanner
+    {
+    public:
+      //----------------------------------------------------------------------
+      //!  Construct.  @c depth is the number of files kept in flight and
+      //!  @c bufSize the size of each file's buffer.  If @c useUring is
+      //!  false, or io_uring is unavailable, the read() loop is used.
+      //----------------------------------------------------------------------
+      BatchScanner(const Scanner & scanner, unsigned int depth = 32,
+                   std::size_t bufSize = 128 * 1024, bool useUring = true);
+
+      ~BatchScanner();
+
+      BatchScanner(const BatchScanner &) = delete;
+      BatchScanner & operator = (const BatchScanner &) = delete;
+      
+      //----------------------------------------------------------------------
+      //!  Returns true if we're using io_uring.
+      //----------------------------------------------------------------------
+      bool UsingUring() const
+      { return (_ring != nullptr); }
+
+      //----------------------------------------------------------------------
+      //!  Sets the callback that decides whether to scan an ELF file with
+      //!  a build ID.  The build ID is read from the start of the file,
+      //!  so a skipped file's contents are never scanned (or, if it's
+      //!  larger than our buffers, read).  Files without a build ID are
+      //!  always scanned.  If BatchScanners share a callback, it must be
+      //!  thread safe.
+      //----------------------------------------------------------------------
+      void SetBuildIdCallback(const BuildIdCallback & cb)
+      { _buildIdCb = cb; }
+      
+      //----------------------------------------------------------------------
+      //!  Scans @c paths[i] for each i taken from @c next (with
+      //!  @c next++) until @c next reaches @c paths.size().  Files are
+      //!  scanned in completion order, not necessarily the order of
+      //!  @c paths.  Files that can't be opened or read get no hits but
+      //!  are still handed to @c done.
+      //----------------------------------------------------------------------
+      void Run(const std::vector<std::string> & paths,
+               std::atomic<std::size_t> & next, const BatchCallback & cb,
+               const BatchDoneCallback & done);
+
+    private:
+      class Uring;
+      
+      const Scanner          & _scanner;
+      unsigned int             _depth;
+      std::size_t              _bufSize;
+      char                    *_bufs;
+      std::unique_ptr<Uring>   _ring;
+      BuildIdCallback          _buildIdCb;
+
+      bool WantScan(std::size_t fileIdx, const char *head, std::size_t len);
+      bool WantScanFd(std::size_t fileIdx, int fd, char *buf);
+
+      void RunRead(const std::vector<std::string> & paths,
+                   std::atomic<std::size_t> & next, const BatchCallback & cb,
+                   const BatchDoneCallback & done);
+      void RunUring(const std::vector<std::string> & paths,
+                    std::atomic<std::size_t> & next, const BatchCallback & cb,
+                    const BatchDoneCallback & done);
+    };
+    
+  }  // namespace Pkg
+
+}  // namespace Dwm
+
+#endif  // _DWMPKGBATCHSCANNER_HH_
@@ -0,0 +1,227 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  \file DwmPkgC.h
+//!  \author Daniel W. McRobb
+//!  \brief C interface to libDwmPkg, for use from other languages
+//!
+//!  A stable C ABI over the same scanner and parser that dwmwhat uses,
+//!  so tools written in Go, Python, Rust and so on can find package
+//!  information without spawning dwmwhat.  It covers enumerating the
+//!  Dwm::Pkg::Info strings linked into the current process, scanning a
+//!  file, descriptor or buffer, and parsing a single string.
+//!
+//!  Strings are handed over as pointer and length (dwm_pkg_str), never
+//!  null terminated, and point into the scanned data (or the loaded
+//!  image, or the string given to dwm_pkg_parse()).  In callbacks they
+//!  are only valid until the callback returns.  Nothing is allocated on
+//!  the caller's behalf except a dwm_pkg_scanner, so there's nothing
+//!  else to free.
+//!
+//!  Compatibility rules: functions are only added, and structures only
+//!  grow at the end.  Each structure starts with its size, so the
+//!  library knows which fields a caller allocated (dwm_pkg_filter,
+//!  dwm_pkg_info given to dwm_pkg_parse()) and a caller knows which
+//!  fields the library filled in (structures handed to callbacks).
+//!  No C++ exception ever crosses this interface.
+//---------------------------------------------------------------------------
+
+#ifndef _DWMPKGC_H_
+#define _DWMPKGC_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//----------------------------------------------------------------------------
+//!  Version of this interface, incremented when functions or fields
+//!  are added.
+//----------------------------------------------------------------------------
+#define DWM_PKG_C_API_VERSION  1
+
+//----------------------------------------------------------------------------
+//!  Returns the DWM_PKG_C_API_VERSION the library was built with, which
+//!  may be newer than the one a caller was compiled against.
+//----------------------------------------------------------------------------
+unsigned int dwm_pkg_api_version(void);
+
+//----------------------------------------------------------------------------
+//!  A string that is not null terminated.
+//----------------------------------------------------------------------------
+typedef struct dwm_pkg_str {
+  const char  *ptr;
+  size_t       len;
+} dwm_pkg_str;
+
+//----------------------------------------------------------------------------
+//!  The fields of a Dwm::Pkg::Info string.
+//----------------------------------------------------------------------------
+typedef struct dwm_pkg_info {
+  size_t       size;        //!< sizeof(dwm_pkg_info)
+  dwm_pkg_str  raw;         //!< the whole string, including "@(#)"
+  dwm_pkg_str  type;
+  dwm_pkg_str  status;
+  dwm_pkg_str  name;
+  dwm_pkg_str  version;
+  dwm_pkg_str  copyright;
+  dwm_pkg_str  date;
+  dwm_pkg_str  other;
+} dwm_pkg_info;
+
+//----------------------------------------------------------------------------
+//!  How a found string was stored.  UTF-16 strings are handed over
+//!  transcoded to UTF-8.
+//----------------------------------------------------------------------------
+enum {
+  DWM_PKG_ENCODING_UTF8    = 0,
+  DWM_PKG_ENCODING_UTF16LE = 1,
+  DWM_PKG_ENCODING_UTF16BE = 2
+};
+
+//----------------------------------------------------------------------------
+//!  A string found by a scan.
+//----------------------------------------------------------------------------
+typedef struct dwm_pkg_hit {
+  size_t               size;       //!< sizeof(dwm_pkg_hit)
+  dwm_pkg_str          raw;        //!< the whole string, including "@(#)"
+  uint64_t             offset;     //!< offset of "@(#)" in the data
+  const dwm_pkg_info  *info;       //!< parsed fields, or NULL
+  int                  truncated;  //!< nonzero if raw was cut short
+  int                  encoding;   //!< DWM_PKG_ENCODING_*
+} dwm_pkg_hit;
+
+//----------------------------------------------------------------------------
+//!  Called once per hit with the @c arg given to the scan function.
+//!  Return nonzero to continue, 0 to stop.
+//----------------------------------------------------------------------------
+typedef int (*dwm_pkg_hit_fn)(const dwm_pkg_hit *hit, void *arg);
+
+//----------------------------------------------------------------------------
+//!  Called once per Dwm::Pkg::Info string found in the current process,
+//!  with the path of the image it was found in (empty for the program
+//!  itself on Linux) and the @c arg given to dwm_pkg_loaded().  Return
+//!  nonzero to continue, 0 to stop.
+//----------------------------------------------------------------------------
+typedef int (*dwm_pkg_info_fn)(const dwm_pkg_info *info, dwm_pkg_str image,
+                               void *arg);
+
+//----------------------------------------------------------------------------
+//!  Selects which strings a dwm_pkg_scanner reports.  A zeroed filter
+//!  (with @c size set) accepts everything.  If any of @c name,
+//!  @c status, @c type or @c version_range is set, only Dwm::Pkg::Info
+//!  strings that match are reported.
+//----------------------------------------------------------------------------
+typedef struct dwm_pkg_filter {
+  size_t       size;           //!< sizeof(dwm_pkg_filter)
+  const char  *name;           //!< package name, or NULL
+  const char  *status;         //!< "dev", "rc", "rel" or a symbol, or NULL
+  const char  *type;           //!< "hdr", "lib", "exe", "doc" or a symbol,
+                               //!< or NULL
+  const char  *version_range;  //!< like ">=1.2,<1.4", or NULL
+  size_t       limit;          //!< hits per scan, 0 for no limit
+  size_t       max_length;     //!< truncate longer hits; 0 for the
+                               //!< default (4096), SIZE_MAX for no limit
+  int          all_bytes;      //!< nonzero to scan all of an image
+} dwm_pkg_filter;
+
+//----------------------------------------------------------------------------
+//!  A scanner with a fixed filter.  A scanner may be used by any number
+//!  of threads at once.
+//----------------------------------------------------------------------------
+typedef struct dwm_pkg_scanner dwm_pkg_scanner;
+
+//----------------------------------------------------------------------------
+//!  Returns a new scanner using @c filter (NULL to accept everything),
+//!  or NULL if the filter is invalid (a bad version range, say) or
+//!  memory is exhausted.  Free it with dwm_pkg_scanner_free().
+//----------------------------------------------------------------------------
+dwm_pkg_scanner *dwm_pkg_scanner_new(const dwm_pkg_filter *filter);
+
+//----------------------------------------------------------------------------
+//!  Frees a scanner returned by dwm_pkg_scanner_new().  NULL is ignored.
+//----------------------------------------------------------------------------
+void dwm_pkg_scanner_free(dwm_pkg_scanner *scanner);
+
+//----------------------------------------------------------------------------
+//!  Scans the file at @c path, calling @c fn for each hit.  ELF, Mach-O
+//!  and PE images are only scanned in the sections that can hold
+//!  strings, unless the filter's @c all_bytes is set.  A NULL
+//!  @c scanner accepts everything.  Returns the number of hits handed
+//!  to @c fn, or -1 (with errno set) if the file couldn't be read.
+//----------------------------------------------------------------------------
+long dwm_pkg_scan_file(const dwm_pkg_scanner *scanner, const char *path,
+                       dwm_pkg_hit_fn fn, void *arg);
+
+//----------------------------------------------------------------------------
+//!  Like dwm_pkg_scan_file(), for the contents of @c fd from its start.
+//!  @c fd is not closed.
+//----------------------------------------------------------------------------
+long dwm_pkg_scan_fd(const dwm_pkg_scanner *scanner, int fd,
+                     dwm_pkg_hit_fn fn, void *arg);
+
+//----------------------------------------------------------------------------
+//!  Like dwm_pkg_scan_file(), for the @c len bytes at @c data.  Hit
+//!  offsets are relative to @c data.
+//----------------------------------------------------------------------------
+long dwm_pkg_scan_buffer(const dwm_pkg_scanner *scanner, const void *data,
+                         size_t len, dwm_pkg_hit_fn fn, void *arg);
+
+//----------------------------------------------------------------------------
+//!  Calls @c fn for each Dwm::Pkg::Info string in the current program
+//!  and the shared libraries loaded in it, found in memory (nothing is
+//!  read from disk).  A string linked into several images is reported
+//!  once for each.  Returns the number of strings handed to @c fn, or
+//!  -1 if memory is exhausted.
+//----------------------------------------------------------------------------
+long dwm_pkg_loaded(dwm_pkg_info_fn fn, void *arg);
+
+//----------------------------------------------------------------------------
+//!  Parses the @c len bytes at @c s as a complete Dwm::Pkg::Info string
+//!  (starting with "@(#)").  @c info->size must be set by the caller;
+//!  only the fields within it are filled in.  Returns 1 on success,
+//!  with the fields of @c info pointing into @c s, and 0 if @c s isn't
+//!  a Dwm::Pkg::Info string or @c info->size doesn't cover @c raw.
+//----------------------------------------------------------------------------
+int dwm_pkg_parse(const char *s, size_t len, dwm_pkg_info *info);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // _DWMPKGC_H_
@@ -0,0 +1,155 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  \file DwmPkgCoreScanner.hh
+//!  \author Daniel W. McRobb
+//!  \brief Dwm::Pkg::CoreScanner class declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMPKGCORESCANNER_HH_
+#define _DWMPKGCORESCANNER_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "DwmPkgImage.hh"
+#include "DwmPkgScanner.hh"
+
+namespace Dwm {
+
+  namespace Pkg {
+
+    //------------------------------------------------------------------------
+    //!  A string found in a core file.  @c hit.offset is the offset in
+    //!  the core, @c vaddr the address the string was at in the process
+    //!  and @c mapping the file that was mapped there (from the NT_FILE
+    //!  note), or nullptr for anonymous memory (heap, stack, etc.).
+    //------------------------------------------------------------------------
+    struct CoreHit
+    {
+      ScanHit              hit;
+      uint64_t             vaddr;
+      const CoreMapping   *mapping;
+    };
+
+    //------------------------------------------------------------------------
+    //!  Called once per hit, possibly from several threads at once.
+    //!  Return false to stop scanning.
+    //------------------------------------------------------------------------
+    using CoreCallback = std::function<bool(const CoreHit &)>;
+    
+    //------------------------------------------------------------------------
+    //!  Scans the memory of a crashed process in its ELF core file, to
+    //!  find which versions of which packages were loaded when it
+    //!  crashed (which may not be what's on disk now).
+    //!
+    //!  Only readable PT_LOAD segments are scanned, and each hit is
+    //!  attributed to the file that was mapped at its address according
+    //!  to the NT_FILE note.  The core is mapped, not read, and scanned
+    //!  in windows of @c windowSize bytes spread over @c numThreads
+    //!  threads.  Each window's pages are released with
+    //!  madvise(MADV_DONTNEED) when it's done, so a multi-gigabyte core
+    //!  never has more than about @c numThreads windows resident.
+    //!
+    //!  The Scanner's filter is applied to hits, and its Polite object
+    //!  (if any) paces the windows and drops the core's pages from the
+    //!  page cache afterward.
+    //------------------------------------------------------------------------
+    class CoreScanner
+    {
+    public:
+      //----------------------------------------------------------------------
+      //!  Construct.  A @c numThreads of 0 means 1.
+      //----------------------------------------------------------------------
+      CoreScanner(const Scanner & scanner, unsigned int numThreads = 1,
+                  std::size_t windowSize = 64 * 1024 * 1024);
+
+      ~CoreScanner();
+
+      CoreScanner(const CoreScanner &) = delete;
+      CoreScanner & operator = (const CoreScanner &) = delete;
+      
+      //----------------------------------------------------------------------
+      //!  Opens and maps the core file at @c path and reads its layout.
+      //!  Returns false if it can't be opened or isn't an ELF core.
+      //----------------------------------------------------------------------
+      bool Open(const std::string & path);
+
+      //----------------------------------------------------------------------
+      //!  Returns the PT_LOAD segments of the open core.
+      //----------------------------------------------------------------------
+      const std::vector<CoreSegment> & Segments() const
+      { return _segments; }
+      
+      //----------------------------------------------------------------------
+      //!  Returns the mapped files of the open core, sorted by address.
+      //----------------------------------------------------------------------
+      const std::vector<CoreMapping> & Mappings() const
+      { return _mappings; }
+
+      //----------------------------------------------------------------------
+      //!  Returns the mapping that contains @c vaddr, or nullptr.
+      //----------------------------------------------------------------------
+      const CoreMapping *FindMapping(uint64_t vaddr) const;
+      
+      //----------------------------------------------------------------------
+      //!  Scans the open core, handing each hit to @c cb.  Returns false
+      //!  if no core is open.
+      //----------------------------------------------------------------------
+      bool Scan(const CoreCallback & cb);
+      
+    private:
+      const Scanner             & _scanner;
+      unsigned int                _numThreads;
+      std::size_t                 _windowSize;
+      std::string                 _path;
+      int                         _fd;
+      const char                 *_map;
+      std::size_t                 _len;
+      std::vector<CoreSegment>    _segments;
+      std::vector<CoreMapping>    _mappings;
+
+      void Close();
+    };
+    
+  }  // namespace Pkg
+
+}  // namespace Dwm
+
+#endif  // _DWMPKGCORESCANNER_HH_
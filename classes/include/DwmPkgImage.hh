@@ -0,0 +1,183 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+
+//---------------------------------------------------------------------------
+//!  \file DwmPkgImage.hh
+//!  \author Daniel W. McRobb
+//!  \brief Object file image parsing for section-aware scanning
+//---------------------------------------------------------------------------
+
+#ifndef _DWMPKGIMAGE_HH_
+#define _DWMPKGIMAGE_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace Dwm {
+
+  namespace Pkg {
+
+    //------------------------------------------------------------------------
+    //!  Object file formats we can find data sections in.
+    //------------------------------------------------------------------------
+    enum class ImageFormat : uint8_t {
+      k_unknown,
+      k_elf,
+      k_machO,
+      k_machOFat,
+      k_pe
+    };
+
+    //------------------------------------------------------------------------
+    //!  A range of bytes in an image, and the name of the section it came
+    //!  from (a view into the image, or a static string).  For fat Mach-O
+    //!  files, @c slice is the index of the architecture it came from.
+    //------------------------------------------------------------------------
+    struct ImageRange
+    {
+      std::size_t       offset;
+      std::size_t       length;
+      std::string_view  section;
+      uint32_t          slice;
+    };
+
+    //------------------------------------------------------------------------
+    //!  If the @c len bytes at @c data are an ELF, Mach-O (thin or fat) or
+    //!  PE image, fills @c ranges with the file ranges of the sections
+    //!  that can hold embedded strings and returns the format.  Code,
+    //!  symbol tables, debug information and zero-filled sections are
+    //!  left out.  The sections are:
+    //!
+    //!  - ELF: allocated, non-executable SHT_PROGBITS sections (.rodata,
+    //!    .data, .data.rel.ro and so on) and .comment
+    //!  - Mach-O: __TEXT,__cstring, __TEXT,__const, every __DATA_CONST
+    //!    section, __DATA,__data and __DATA,__const, for each
+    //!    architecture of a fat file
+    //!  - PE: .rdata, .data and .rsrc
+    //!
+    //!  Returns ImageFormat::k_unknown, with @c ranges empty, if the data
+    //!  isn't an image we understand or is malformed; the caller should
+    //!  scan all of it.
+    //------------------------------------------------------------------------
+    ImageFormat FindDataRanges(const char *data, std::size_t len,
+                               std::vector<ImageRange> & ranges);
+
+    //------------------------------------------------------------------------
+    //!  If the @c len bytes at @c data are (or start) an ELF image with an
+    //!  NT_GNU_BUILD_ID note, returns the build ID (a view into @c data).
+    //!  Otherwise returns an empty view.  The note is found through the
+    //!  program headers, so it's normally in the first page of the file
+    //!  and @c data need only hold the start of the file.
+    //------------------------------------------------------------------------
+    std::string_view FindBuildId(const char *data, std::size_t len);
+
+    //------------------------------------------------------------------------
+    //!  A PT_LOAD segment of an ELF core file (or other ELF image):
+    //!  @c fileSize bytes at @c offset in the file hold the memory at
+    //!  @c vaddr.  @c flags are the segment's PF_R, PF_W and PF_X bits.
+    //------------------------------------------------------------------------
+    struct CoreSegment
+    {
+      uint64_t  vaddr;
+      uint64_t  offset;
+      uint64_t  fileSize;
+      uint64_t  memSize;
+      uint32_t  flags;
+    };
+
+    //------------------------------------------------------------------------
+    //!  A file that was mapped into a process, from the NT_FILE note of
+    //!  its core: [@c start, @c end) was mapped from @c fileOffset in
+    //!  @c path (a view into the core).
+    //------------------------------------------------------------------------
+    struct CoreMapping
+    {
+      uint64_t          start;
+      uint64_t          end;
+      uint64_t          fileOffset;
+      std::string_view  path;
+    };
+
+    //------------------------------------------------------------------------
+    //!  If the @c len bytes at @c data are an ELF core file, fills
+    //!  @c segments with its PT_LOAD segments (in file order) and
+    //!  @c mappings with the entries of its NT_FILE note (sorted by
+    //!  address; empty if there's no NT_FILE note) and returns true.
+    //!  Only the ELF header, program headers and notes are read, so
+    //!  @c data can be a mapping of a core too big to read.
+    //------------------------------------------------------------------------
+    bool FindCoreLayout(const char *data, std::size_t len,
+                        std::vector<CoreSegment> & segments,
+                        std::vector<CoreMapping> & mappings);
+
+    //------------------------------------------------------------------------
+    //!  If the @c len bytes at @c data are an ELF image, fills
+    //!  @c segments with its PT_LOAD segments (in file order) and returns
+    //!  true.
+    //------------------------------------------------------------------------
+    bool FindLoadSegments(const char *data, std::size_t len,
+                          std::vector<CoreSegment> & segments);
+    
+    //------------------------------------------------------------------------
+    //!  A defined data or function symbol from an ELF image.  @c name is
+    //!  a view into the image.  @c addr is a virtual address, except in
+    //!  relocatable objects (.o files), where it's a file offset.
+    //------------------------------------------------------------------------
+    struct ElfSymbol
+    {
+      uint64_t          addr;
+      uint64_t          size;
+      std::string_view  name;
+      bool              local;
+    };
+
+    //------------------------------------------------------------------------
+    //!  If the @c len bytes at @c data are an ELF image, appends the
+    //!  symbols of its .symtab and .dynsym sections that define objects
+    //!  or functions of nonzero size to @c symbols and returns true.
+    //!  Symbols are in table order; a symbol in both tables appears
+    //!  twice.
+    //------------------------------------------------------------------------
+    bool FindElfSymbols(const char *data, std::size_t len,
+                        std::vector<ElfSymbol> & symbols);
+    
+  }  // namespace Pkg
+
+}  // namespace Dwm
+
+#endif  // _DWMPKGIMAGE_HH_
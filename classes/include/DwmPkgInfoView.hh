@@ -0,0 +1,115 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+
+//---------------------------------------------------------------------------
+//!  \file DwmPkgInfoView.hh
+//!  \author Daniel W. McRobb
+//!  \brief Dwm::Pkg::InfoView class declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMPKGINFOVIEW_HH_
+#define _DWMPKGINFOVIEW_HH_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace Dwm {
+
+  namespace Pkg {
+
+    //------------------------------------------------------------------------
+    //!  The fields of a Dwm::Pkg::Info string found at runtime (in a file
+    //!  or in memory), as views into the original string.  This is the
+    //!  runtime counterpart of Dwm::Pkg::Info: Info builds the string at
+    //!  compile time, InfoView takes it apart.  An InfoView never owns
+    //!  any memory; it's only valid as long as the string it was parsed
+    //!  from.
+    //------------------------------------------------------------------------
+    struct InfoView
+    {
+      std::string_view  type;
+      std::string_view  status;
+      std::string_view  name;
+      std::string_view  version;
+      std::string_view  copyright;
+      std::string_view  date;
+      std::string_view  other;
+      std::string_view  id;         //!< the whole string
+
+      //----------------------------------------------------------------------
+      //!  Parses @c s, which must be a complete Dwm::Pkg::Info string
+      //!  (starting with "@(#)").  Returns true on success, in which
+      //!  case our members are views into @c s.  On failure, our members
+      //!  are cleared.  Thread safe.
+      //----------------------------------------------------------------------
+      bool Parse(std::string_view s);
+
+      //----------------------------------------------------------------------
+      //!  Returns the fields as a JSON object, with keys in alphabetical
+      //!  order.
+      //----------------------------------------------------------------------
+      std::string as_json() const;
+
+      //----------------------------------------------------------------------
+      //!  Returns InfoHash() of the whole string, which is the same as
+      //!  Info::hash() for the Info that built it.
+      //----------------------------------------------------------------------
+      std::uint64_t hash() const noexcept;
+      
+      //----------------------------------------------------------------------
+      //!  Two InfoViews are equal if they were parsed from equal strings.
+      //----------------------------------------------------------------------
+      bool operator == (const InfoView & iv) const noexcept
+      { return (id == iv.id); }
+    };
+    
+  }  // namespace Pkg
+
+}  // namespace Dwm
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+template <>
+struct std::hash<Dwm::Pkg::InfoView>
+{
+  std::size_t operator () (const Dwm::Pkg::InfoView & iv) const noexcept
+  { return iv.hash(); }
+};
+
+#endif  // _DWMPKGINFOVIEW_HH_
@@ -0,0 +1,239 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  \file DwmPkgManifest.hh
+//!  \author Daniel W. McRobb
+//!  \brief Dwm::Pkg::Manifest, Dwm::Pkg::ManifestPublisher and related
+//!    function declarations
+//---------------------------------------------------------------------------
+
+#ifndef _DWMPKGMANIFEST_HH_
+#define _DWMPKGMANIFEST_HH_
+
+extern "C" {
+  #include <sys/types.h>
+}
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "DwmPkgScanner.hh"
+
+namespace Dwm {
+
+  namespace Pkg {
+
+    //------------------------------------------------------------------------
+    //!  The start of a published package manifest.  A manifest is a
+    //!  small read-only file named "dwmpkg.<pid>" in ManifestDir(),
+    //!  holding this header followed by @c numStrings null-terminated
+    //!  strings: the program name, then each Dwm::Pkg::Info string
+    //!  (including "@(#)") found in the program and the shared libraries
+    //!  it was linked with, sorted and deduplicated.  @c totalSize covers
+    //!  the header and the strings, and is never more than
+    //!  k_maxManifestSize, so a manifest can always be collected with one
+    //!  read().  Integers are in host byte order; manifests are only
+    //!  meant to be read on the host that wrote them.
+    //------------------------------------------------------------------------
+    struct ManifestHeader
+    {
+      char      magic[8];      // k_manifestMagic
+      uint32_t  version;       // k_manifestVersion
+      uint32_t  headerSize;    // sizeof(ManifestHeader)
+      uint32_t  totalSize;     // header plus strings, in bytes
+      uint32_t  numStrings;    // program name plus packages
+      uint64_t  pid;
+      uint64_t  published;     // seconds since the epoch
+    };
+
+    static_assert(sizeof(ManifestHeader) == 40);
+    
+    inline constexpr char           k_manifestMagic[8] = "DWMPKGM";
+    inline constexpr uint32_t       k_manifestVersion = 1;
+    inline constexpr std::size_t    k_maxManifestSize = 64 * 1024;
+    inline constexpr std::string_view  k_manifestPrefix = "dwmpkg.";
+
+    //------------------------------------------------------------------------
+    //!  Returns the directory holding manifests: $DWM_PKG_MANIFEST_DIR if
+    //!  it's set, else /dev/shm on Linux and /tmp elsewhere.
+    //------------------------------------------------------------------------
+    std::string ManifestDir();
+
+    //------------------------------------------------------------------------
+    //!  Called by ScanLoadedImages() with the path of a loaded image
+    //!  (empty for the program itself on Linux) and a hit found in it.
+    //!  Return false to stop.
+    //------------------------------------------------------------------------
+    using LoadedImageCallback =
+      std::function<bool(std::string_view, const ScanHit &)>;
+    
+    //------------------------------------------------------------------------
+    //!  Scans the running program and the shared libraries loaded in it
+    //!  with @c scanner, in memory: the initialized part of each loaded
+    //!  data segment (inline Info variables are often in .data rather
+    //!  than .rodata) and read-only segments, or on macOS the sections
+    //!  that hold strings.  Nothing is read from disk.  A string linked
+    //!  into several images is found once in each.
+    //------------------------------------------------------------------------
+    void ScanLoadedImages(const Scanner & scanner,
+                          const LoadedImageCallback & cb);
+    
+    //------------------------------------------------------------------------
+    //!  Finds the Dwm::Pkg::Info strings in the running program and the
+    //!  shared libraries loaded in it (their loaded segments are scanned
+    //!  in memory; nothing is read from disk) and publishes them as a
+    //!  manifest in @c dir.  The manifest is written under a temporary
+    //!  name and renamed into place, so collectors never see a partial
+    //!  one, and this process holds a read lock on it until
+    //!  UnpublishManifest() or exit, which collectors use to tell live
+    //!  manifests from those of processes that crashed.  May be called
+    //!  again (after a dlopen(), say) to replace the manifest.  Returns
+    //!  false on failure.
+    //------------------------------------------------------------------------
+    bool PublishManifest(const std::string & dir = ManifestDir());
+
+    //------------------------------------------------------------------------
+    //!  Removes the manifest published by PublishManifest(), if any.
+    //------------------------------------------------------------------------
+    void UnpublishManifest();
+
+    //------------------------------------------------------------------------
+    //!  Publishes a manifest when constructed and removes it when
+    //!  destroyed.  Opting a program in is one line at namespace scope:
+    //!
+    //!  static Dwm::Pkg::ManifestPublisher  pkgManifest;
+    //------------------------------------------------------------------------
+    class ManifestPublisher
+    {
+    public:
+      //----------------------------------------------------------------------
+      //!  Calls PublishManifest(@c dir).
+      //----------------------------------------------------------------------
+      explicit ManifestPublisher(const std::string & dir = ManifestDir());
+
+      //----------------------------------------------------------------------
+      //!  Calls UnpublishManifest().
+      //----------------------------------------------------------------------
+      ~ManifestPublisher();
+
+      ManifestPublisher(const ManifestPublisher &) = delete;
+      ManifestPublisher & operator = (const ManifestPublisher &) = delete;
+      
+      //----------------------------------------------------------------------
+      //!  Returns true if the manifest was published.
+      //----------------------------------------------------------------------
+      bool Published() const
+      { return _published; }
+      
+    private:
+      bool  _published;
+    };
+    
+    //------------------------------------------------------------------------
+    //!  A manifest read from a file.  The views returned by the accessors
+    //!  point into the Manifest and are valid until the next Read() or
+    //!  Parse().
+    //------------------------------------------------------------------------
+    class Manifest
+    {
+    public:
+      Manifest();
+      
+      //----------------------------------------------------------------------
+      //!  Reads a manifest from @c fd with a single read().  Returns
+      //!  false if it's not a valid manifest.
+      //----------------------------------------------------------------------
+      bool Read(int fd);
+
+      //----------------------------------------------------------------------
+      //!  Parses the manifest in the @c len bytes at @c data.  Returns
+      //!  false if it's not a valid manifest.
+      //----------------------------------------------------------------------
+      bool Parse(const char *data, std::size_t len);
+      
+      //----------------------------------------------------------------------
+      //!  Returns the process ID of the publisher.
+      //----------------------------------------------------------------------
+      pid_t Pid() const
+      { return _pid; }
+
+      //----------------------------------------------------------------------
+      //!  Returns when the manifest was published, in seconds since the
+      //!  epoch.
+      //----------------------------------------------------------------------
+      uint64_t Published() const
+      { return _published; }
+      
+      //----------------------------------------------------------------------
+      //!  Returns the name of the publishing program.
+      //----------------------------------------------------------------------
+      std::string_view Program() const
+      { return _program; }
+
+      //----------------------------------------------------------------------
+      //!  Returns the Dwm::Pkg::Info strings, including "@(#)".
+      //----------------------------------------------------------------------
+      const std::vector<std::string_view> & Packages() const
+      { return _packages; }
+      
+    private:
+      std::vector<char>               _buf;
+      pid_t                           _pid;
+      uint64_t                        _published;
+      std::string_view                _program;
+      std::vector<std::string_view>   _packages;
+    };
+
+    //------------------------------------------------------------------------
+    //!  Calls @c cb with each manifest in @c dir whose publisher is still
+    //!  running.  Each manifest costs an open(), one read(), an fcntl()
+    //!  lock test and a close(); manifests left behind by processes that
+    //!  died without removing them are skipped.  @c cb returns false to
+    //!  stop.  Returns the number of manifests handed to @c cb.
+    //------------------------------------------------------------------------
+    std::size_t
+    CollectManifests(const std::string & dir,
+                     const std::function<bool(const Manifest &)> & cb);
+    
+  }  // namespace Pkg
+
+}  // namespace Dwm
+
+#endif  // _DWMPKGMANIFEST_HH_
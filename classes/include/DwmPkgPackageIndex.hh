@@ -0,0 +1,240 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  \file DwmPkgPackageIndex.hh
+//!  \author Daniel W. McRobb
+//!  \brief Dwm::Pkg::PackageIndex class template
+//---------------------------------------------------------------------------
+
+#ifndef _DWMPKGPACKAGEINDEX_HH_
+#define _DWMPKGPACKAGEINDEX_HH_
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include "DwmPkgInfo.hh"
+
+namespace Dwm {
+
+  namespace Pkg {
+
+    //------------------------------------------------------------------------
+    //!  A perfect hash table of packages by name, built at compile time.
+    //!  Lookups hash the name once and do one string comparison, with no
+    //!  allocation.
+    //!
+    //!  The hash is 'hash and displace': each name's 64-bit hash selects
+    //!  a bucket, and each bucket has a seed, found at compile time, that
+    //!  sends all of its names to distinct, otherwise unused slots.  @c N
+    //!  is the maximum number of packages.  If several packages have the
+    //!  same name, only the one with the greatest version (see
+    //!  Dwm::Pkg::Version) is kept.
+    //------------------------------------------------------------------------
+    template <std::size_t N>
+    class PackageIndex
+    {
+    public:
+      static_assert(N < UINT16_MAX, "too many packages");
+
+      //----------------------------------------------------------------------
+      //!  Builds the index from @c data, which must be the data of
+      //!  strings built by Dwm::Pkg::Info (like Info::data_view(), without
+      //!  the "@(#)" prefix) in static storage.  Fails to compile if any
+      //!  of them can't be parsed.
+      //----------------------------------------------------------------------
+      consteval PackageIndex(std::span<const std::string_view> data)
+      {
+        if (data.size() > N) {
+          throw "too many packages for PackageIndex";
+        }
+        for (const auto & d : data) {
+          InfoFields  f;
+          if (! SplitInfoData(d, f)) {
+            throw "not a Dwm::Pkg::Info string";
+          }
+          std::size_t  i = 0;
+          while ((i < _size) && (_entries[i].name != f.name)) {
+            ++i;
+          }
+          if (i == _size) {
+            _entries[_size++] = f;
+          }
+          else if (Version(f.version) > Version(_entries[i].version)) {
+            _entries[i] = f;
+          }
+        }
+        Build();
+      }
+      
+      //----------------------------------------------------------------------
+      //!  Returns the package named @c name, or nullptr if there isn't
+      //!  one.
+      //----------------------------------------------------------------------
+      constexpr const InfoFields * find(std::string_view name) const noexcept
+      {
+        uint64_t  h = Hash(name);
+        uint16_t  slot = _slots[Slot(h, _seeds[h & (k_numBuckets - 1)])];
+        if (slot && (_entries[slot - 1].name == name)) {
+          return &_entries[slot - 1];
+        }
+        return nullptr;
+      }
+
+      //----------------------------------------------------------------------
+      //!  Returns the number of packages.
+      //----------------------------------------------------------------------
+      constexpr std::size_t size() const noexcept
+      { return _size; }
+
+      //----------------------------------------------------------------------
+      //!  Returns the packages, in the order they were given (less any
+      //!  with duplicate names).
+      //----------------------------------------------------------------------
+      constexpr std::span<const InfoFields> entries() const noexcept
+      { return std::span<const InfoFields>(_entries.data(), _size); }
+      
+    private:
+      static constexpr std::size_t  k_numBuckets = std::bit_ceil(N ? N : 1);
+      static constexpr std::size_t  k_numSlots = 2 * k_numBuckets;
+
+      std::array<InfoFields,(N ? N : 1)>  _entries {};
+      std::size_t                          _size = 0;
+      std::array<uint32_t,k_numBuckets>    _seeds {};
+      std::array<uint16_t,k_numSlots>      _slots {};  // entry index + 1
+
+      //----------------------------------------------------------------------
+      //!  64-bit FNV-1a.
+      //----------------------------------------------------------------------
+      static constexpr uint64_t Hash(std::string_view s) noexcept
+      {
+        uint64_t  h = 0xcbf29ce484222325ULL;
+        for (char c : s) {
+          h = (h ^ (uint8_t)c) * 0x100000001b3ULL;
+        }
+        return h;
+      }
+
+      //----------------------------------------------------------------------
+      //!  Mixes @c seed into hash @c h (splitmix64 finalizer) and returns
+      //!  a slot index.  The bucket index is taken from the low bits of
+      //!  @c h, so we use the high bits here.
+      //----------------------------------------------------------------------
+      static constexpr std::size_t Slot(uint64_t h, uint32_t seed) noexcept
+      {
+        h += (uint64_t)seed * 0x9e3779b97f4a7c15ULL;
+        h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+        h ^= (h >> 31);
+        return (h >> 32) & (k_numSlots - 1);
+      }
+
+      //----------------------------------------------------------------------
+      //!  Assigns bucket seeds, placing the largest buckets first.
+      //----------------------------------------------------------------------
+      consteval void Build()
+      {
+        std::array<uint64_t,(N ? N : 1)>     hashes {};
+        std::array<std::size_t,k_numBuckets>  bucketSizes {};
+        for (std::size_t i = 0; i < _size; ++i) {
+          hashes[i] = Hash(_entries[i].name);
+          ++bucketSizes[hashes[i] & (k_numBuckets - 1)];
+        }
+        for (std::size_t bucketSize = N; bucketSize > 0; --bucketSize) {
+          for (std::size_t b = 0; b < k_numBuckets; ++b) {
+            if (bucketSizes[b] == bucketSize) {
+              PlaceBucket(b, hashes);
+            }
+          }
+        }
+      }
+
+      //----------------------------------------------------------------------
+      //!  Finds a seed that sends every entry in bucket @c b to a distinct
+      //!  free slot, and fills those slots.
+      //----------------------------------------------------------------------
+      consteval void
+      PlaceBucket(std::size_t b,
+                  const std::array<uint64_t,(N ? N : 1)> & hashes)
+      {
+        for (uint32_t seed = 0; seed < 1000000; ++seed) {
+          std::array<uint16_t,k_numSlots>  slots = _slots;
+          bool  ok = true;
+          for (std::size_t i = 0; ok && (i < _size); ++i) {
+            if ((hashes[i] & (k_numBuckets - 1)) == b) {
+              std::size_t  slot = Slot(hashes[i], seed);
+              if (slots[slot]) {
+                ok = false;
+              }
+              else {
+                slots[slot] = i + 1;
+              }
+            }
+          }
+          if (ok) {
+            _seeds[b] = seed;
+            _slots = slots;
+            return;
+          }
+        }
+        throw "no perfect hash found (duplicate 64-bit name hashes?)";
+      }
+    };
+
+    //------------------------------------------------------------------------
+    //!  Returns a PackageIndex of the given Info objects, which must be
+    //!  in static storage (normally inline constexpr variables).
+    //!
+    //!  static constexpr auto  idx =
+    //!    Dwm::Pkg::make_package_index(Dwm::Pkg::info, MyPkg::info);
+    //!  auto  pkg = idx.find("libDwmPkg");
+    //------------------------------------------------------------------------
+    template <std::size_t ...Ns>
+    consteval PackageIndex<sizeof...(Ns)>
+    make_package_index(const Info<Ns> & ...infos)
+    {
+      const std::array<std::string_view,sizeof...(Ns)>
+        data { infos.data_view()... };
+      return PackageIndex<sizeof...(Ns)>(data);
+    }
+    
+  }  // namespace Pkg
+
+}  // namespace Dwm
+
+#endif  // _DWMPKGPACKAGEINDEX_HH_
@@ -0,0 +1,192 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  \file DwmPkgPolite.hh
+//!  \author Daniel W. McRobb
+//!  \brief Dwm::Pkg::Polite and Dwm::Pkg::PageCacheGuard class declarations
+//---------------------------------------------------------------------------
+
+#ifndef _DWMPKGPOLITE_HH_
+#define _DWMPKGPOLITE_HH_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace Dwm {
+
+  namespace Pkg {
+
+    //------------------------------------------------------------------------
+    //!  Settings and counters for scanning on a busy host without hurting
+    //!  the services running on it.  Hand one to Scanner::SetPolite().
+    //!
+    //!  - Reads are limited to @c bytesPerSec with a token bucket shared
+    //!    by every thread using the Polite object.
+    //!  - If @c dropCache is true, pages of scanned files that weren't
+    //!    in the page cache before we scanned them are dropped from it
+    //!    afterward (see PageCacheGuard), so a scan doesn't evict other
+    //!    processes' hot pages in favor of files nobody else wants.
+    //!
+    //!  All members are thread safe.
+    //------------------------------------------------------------------------
+    class Polite
+    {
+    public:
+      //----------------------------------------------------------------------
+      //!  Construct.  A @c bytesPerSec of 0 means no rate limit.  The
+      //!  bucket holds up to @c burst bytes (default: a tenth of a
+      //!  second's worth, at least 1 MiB).
+      //----------------------------------------------------------------------
+      Polite(uint64_t bytesPerSec, bool dropCache, uint64_t burst = 0);
+
+      //----------------------------------------------------------------------
+      //!  Takes @c bytes from the token bucket, sleeping until they're
+      //!  available.  Requests larger than the bucket are allowed; they
+      //!  leave it in debt, which later callers wait out.
+      //----------------------------------------------------------------------
+      void Take(uint64_t bytes);
+
+      //----------------------------------------------------------------------
+      //!  Returns true if we should drop the pages we bring into the page
+      //!  cache.
+      //----------------------------------------------------------------------
+      bool DropCache() const
+      { return _dropCache; }
+
+      //----------------------------------------------------------------------
+      //!  Returns the rate limit in bytes per second, 0 if none.
+      //----------------------------------------------------------------------
+      uint64_t BytesPerSec() const
+      { return _bytesPerSec; }
+      
+      //----------------------------------------------------------------------
+      //!  Returns the number of bytes taken with Take().
+      //----------------------------------------------------------------------
+      uint64_t BytesTaken() const
+      { return _bytesTaken; }
+
+      //----------------------------------------------------------------------
+      //!  Returns the total time callers of Take() spent sleeping, in
+      //!  nanoseconds.  With several threads this can exceed wall time.
+      //----------------------------------------------------------------------
+      uint64_t ThrottledNsecs() const
+      { return _throttledNsecs; }
+
+      //----------------------------------------------------------------------
+      //!  Returns the number of times Take() had to sleep.
+      //----------------------------------------------------------------------
+      uint64_t NumThrottled() const
+      { return _numThrottled; }
+      
+      //----------------------------------------------------------------------
+      //!  Returns the number of pages we asked to have dropped from the
+      //!  page cache (those that weren't cached before we scanned).
+      //----------------------------------------------------------------------
+      uint64_t PagesDropped() const
+      { return _pagesDropped; }
+
+      //----------------------------------------------------------------------
+      //!  Returns the number of pages left in the page cache because they
+      //!  were there before we scanned them.
+      //----------------------------------------------------------------------
+      uint64_t PagesKept() const
+      { return _pagesKept; }
+
+      //----------------------------------------------------------------------
+      //!  Adds to the page counters.  Used by PageCacheGuard.
+      //----------------------------------------------------------------------
+      void CountPages(uint64_t dropped, uint64_t kept)
+      {
+        _pagesDropped += dropped;
+        _pagesKept += kept;
+      }
+      
+    private:
+      uint64_t               _bytesPerSec;
+      bool                   _dropCache;
+      double                 _burst;
+      std::mutex             _mtx;
+      double                 _tokens;
+      uint64_t               _lastRefill;
+      std::atomic<uint64_t>  _bytesTaken;
+      std::atomic<uint64_t>  _throttledNsecs;
+      std::atomic<uint64_t>  _numThrottled;
+      std::atomic<uint64_t>  _pagesDropped;
+      std::atomic<uint64_t>  _pagesKept;
+    };
+
+    //------------------------------------------------------------------------
+    //!  Notes which pages of a file are in the page cache when
+    //!  constructed (with mincore()), and on destruction drops the ones
+    //!  that weren't: madvise(MADV_DONTNEED) on our mapping, so the pages
+    //!  aren't mapped, then posix_fadvise(POSIX_FADV_DONTNEED) on the
+    //!  file.  Pages that were already cached (someone else is using
+    //!  them) are left alone.  Does nothing if @c polite is null or
+    //!  doesn't want the cache dropped, or if another PageCacheGuard is
+    //!  active in the same thread (the outer one does the work).
+    //------------------------------------------------------------------------
+    class PageCacheGuard
+    {
+    public:
+      //----------------------------------------------------------------------
+      //!  Construct for the first @c len bytes of the open file @c fd.
+      //!  @c map is our mapping of them, or nullptr if we're going to
+      //!  read() them instead (the file is mapped briefly to check).
+      //----------------------------------------------------------------------
+      PageCacheGuard(Polite *polite, int fd, const void *map,
+                     std::size_t len);
+
+      ~PageCacheGuard();
+
+      PageCacheGuard(const PageCacheGuard &) = delete;
+      PageCacheGuard & operator = (const PageCacheGuard &) = delete;
+      
+    private:
+      Polite                *_polite;
+      int                    _fd;
+      const void            *_map;
+      std::size_t            _len;
+      std::vector<uint8_t>   _resident;
+    };
+    
+  }  // namespace Pkg
+
+}  // namespace Dwm
+
+#endif  // _DWMPKGPOLITE_HH_
@@ -0,0 +1,303 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  \file DwmPkgProbes.hh
+//!  \author Daniel W. McRobb
+//!  \brief Static (SystemTap SDT style) tracing probes
+//---------------------------------------------------------------------------
+
+#ifndef _DWMPKGPROBES_HH_
+#define _DWMPKGPROBES_HH_
+
+//----------------------------------------------------------------------------
+//  Static probes in the style of SystemTap's <sys/sdt.h>, without needing
+//  it.  Each probe is a single nop at the probe site and an ELF note in
+//  .note.stapsdt that says where the nop is and where to find the
+//  arguments (registers, stack slots or constants).  perf, bpftrace,
+//  SystemTap and gdb read the notes, so a probe can be attached to a
+//  running binary without rebuilding it:
+//
+//    bpftrace -e 'usdt:/usr/local/bin/dwmwhat:dwmpkg:scan_end
+//                 { @ns = hist(arg3); }'
+//    perf buildid-cache --add /usr/local/bin/dwmwhat
+//    perf probe sdt_dwmpkg:hit_found
+//    perf record -e sdt_dwmpkg:hit_found -- dwmwhat ...
+//
+//  Every probe has a semaphore (an unsigned short in the .probes
+//  section, whose address is in the note), which tracers increment
+//  while they're attached.  Probe arguments are only computed when the
+//  semaphore is nonzero, so when nothing is attached a probe costs a
+//  load and a not-taken branch.  Arguments are passed as 8-byte unsigned
+//  integers (string arguments as pointers, read with str() in bpftrace).
+//
+//  Probes are compiled in on ELF platforms for x86_64 and aarch64 with
+//  GCC or clang.  Define DWM_PKG_NO_PROBES (make PROBES=no) to compile
+//  them out completely: the macros then expand to nothing and don't
+//  evaluate their arguments, and Dwm::Pkg::Probes::Now() is always 0.
+//
+//  DWM_PKG_PROBE_TIMER(var, probe) declares a uint64_t @c var holding
+//  Dwm::Pkg::Probes::Now() if @c probe is attached and 0 if not, for
+//  durations passed to @c probe with Dwm::Pkg::Probes::Since(var).  It
+//  compiles out with the probes, so only use @c var in probe arguments.
+//  DWM_PKG_PROBE_ENABLED(probe) is true while @c probe is attached, for
+//  anything else that's only needed by probes.
+//
+//  A new probe needs a DWM_PKG_PROBE_SEMAPHORE_() below.
+//----------------------------------------------------------------------------
+
+#include <cstdint>
+
+#if (! defined(DWM_PKG_NO_PROBES)) && defined(__ELF__)          \
+  && (defined(__x86_64__) || defined(__aarch64__))              \
+  && (defined(__GNUC__) || defined(__clang__))
+#  define DWM_PKG_PROBES_ENABLED  1
+#  include <time.h>
+#else
+#  define DWM_PKG_PROBES_ENABLED  0
+#endif
+
+#if DWM_PKG_PROBES_ENABLED
+
+//  A probe's semaphore, named as <sys/sdt.h> names them.  It's an inline
+//  variable, so there's one per binary however many translation units
+//  have the probe, and hidden, so a shared library's probes don't share
+//  semaphores with the program's.
+#  define DWM_PKG_PROBE_SEMAPHORE_(name)                                 \
+  namespace Dwm { namespace Pkg { namespace Probes {                     \
+    inline volatile unsigned short  name##_semaphore                     \
+      __asm__("dwmpkg_" #name "_semaphore")                              \
+      __attribute__((section(".probes"), used, visibility("hidden"))) = 0; \
+  } } }
+
+DWM_PKG_PROBE_SEMAPHORE_(file_open)
+DWM_PKG_PROBE_SEMAPHORE_(map)
+DWM_PKG_PROBE_SEMAPHORE_(read)
+DWM_PKG_PROBE_SEMAPHORE_(scan_start)
+DWM_PKG_PROBE_SEMAPHORE_(scan_end)
+DWM_PKG_PROBE_SEMAPHORE_(hit_found)
+DWM_PKG_PROBE_SEMAPHORE_(parse_success)
+DWM_PKG_PROBE_SEMAPHORE_(parse_fail)
+DWM_PKG_PROBE_SEMAPHORE_(output_flush)
+
+#  define DWM_PKG_PROBE_ENABLED(name)                                    \
+  __builtin_expect(Dwm::Pkg::Probes::name##_semaphore != 0, 0)
+
+//  The note layout is the one <sys/sdt.h> emits (note type 3, "stapsdt"):
+//  probe address, address of _.stapsdt.base (for prelink adjustment),
+//  semaphore address, then the provider, probe name and argument
+//  description strings.
+#  define DWM_PKG_PROBE_ASM_(name, argfmt, ...)                          \
+  __asm__ __volatile__ (                                                 \
+    "990: nop\n"                                                         \
+    ".pushsection .note.stapsdt,\"?\",\"note\"\n"                        \
+    ".balign 4\n"                                                        \
+    ".4byte 992f-991f, 994f-993f, 3\n"                                   \
+    "991: .asciz \"stapsdt\"\n"                                          \
+    "992: .balign 4\n"                                                   \
+    "993: .8byte 990b\n"                                                 \
+    ".8byte _.stapsdt.base\n"                                            \
+    ".8byte dwmpkg_" #name "_semaphore\n"                                \
+    ".asciz \"dwmpkg\"\n"                                                \
+    ".asciz \"" #name "\"\n"                                             \
+    ".asciz \"" argfmt "\"\n"                                            \
+    "994: .balign 4\n"                                                   \
+    ".popsection\n"                                                      \
+    ".ifndef _.stapsdt.base\n"                                           \
+    ".pushsection .stapsdt.base,\"aG\",\"progbits\",.stapsdt.base,comdat\n" \
+    ".weak _.stapsdt.base\n"                                             \
+    ".hidden _.stapsdt.base\n"                                           \
+    "_.stapsdt.base: .space 1\n"                                         \
+    ".size _.stapsdt.base, 1\n"                                          \
+    ".popsection\n"                                                      \
+    ".endif\n"                                                           \
+    :: __VA_ARGS__)
+
+#  define DWM_PKG_PROBE_ARG_(n, x)  [a##n] "nor" ((uint64_t)(x))
+
+#  define DWM_PKG_PROBE1(name, a1)                                       \
+  do {                                                                   \
+    if (DWM_PKG_PROBE_ENABLED(name)) {                                   \
+      DWM_PKG_PROBE_ASM_(name, "8@%[a1]", DWM_PKG_PROBE_ARG_(1, a1));    \
+    }                                                                    \
+  } while (0)
+#  define DWM_PKG_PROBE2(name, a1, a2)                                   \
+  do {                                                                   \
+    if (DWM_PKG_PROBE_ENABLED(name)) {                                   \
+      DWM_PKG_PROBE_ASM_(name, "8@%[a1] 8@%[a2]",                        \
+                         DWM_PKG_PROBE_ARG_(1, a1),                      \
+                         DWM_PKG_PROBE_ARG_(2, a2));                     \
+    }                                                                    \
+  } while (0)
+#  define DWM_PKG_PROBE3(name, a1, a2, a3)                               \
+  do {                                                                   \
+    if (DWM_PKG_PROBE_ENABLED(name)) {                                   \
+      DWM_PKG_PROBE_ASM_(name, "8@%[a1] 8@%[a2] 8@%[a3]",                \
+                         DWM_PKG_PROBE_ARG_(1, a1),                      \
+                         DWM_PKG_PROBE_ARG_(2, a2),                      \
+                         DWM_PKG_PROBE_ARG_(3, a3));                     \
+    }                                                                    \
+  } while (0)
+#  define DWM_PKG_PROBE4(name, a1, a2, a3, a4)                           \
+  do {                                                                   \
+    if (DWM_PKG_PROBE_ENABLED(name)) {                                   \
+      DWM_PKG_PROBE_ASM_(name, "8@%[a1] 8@%[a2] 8@%[a3] 8@%[a4]",        \
+                         DWM_PKG_PROBE_ARG_(1, a1),                      \
+                         DWM_PKG_PROBE_ARG_(2, a2),                      \
+                         DWM_PKG_PROBE_ARG_(3, a3),                      \
+                         DWM_PKG_PROBE_ARG_(4, a4));                     \
+    }                                                                    \
+  } while (0)
+
+#  define DWM_PKG_PROBE_TIMER(var, name)                                 \
+  uint64_t  var = (DWM_PKG_PROBE_ENABLED(name) ? Dwm::Pkg::Probes::Now() : 0)
+
+#else
+
+#  define DWM_PKG_PROBE_ENABLED(name)  false
+#  define DWM_PKG_PROBE1(name, a1)
+#  define DWM_PKG_PROBE2(name, a1, a2)
+#  define DWM_PKG_PROBE3(name, a1, a2, a3)
+#  define DWM_PKG_PROBE4(name, a1, a2, a3, a4)
+#  define DWM_PKG_PROBE_TIMER(var, name)
+
+#endif  // DWM_PKG_PROBES_ENABLED
+
+namespace Dwm {
+
+  namespace Pkg {
+
+    namespace Probes {
+
+      //----------------------------------------------------------------------
+      //!  Returns CLOCK_MONOTONIC in nanoseconds, for probe durations.
+      //!  Always 0 when probes are compiled out, so the clock isn't read.
+      //----------------------------------------------------------------------
+      inline uint64_t Now()
+      {
+#if DWM_PKG_PROBES_ENABLED
+        struct timespec  ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ((uint64_t)ts.tv_sec * 1000000000) + ts.tv_nsec;
+#else
+        return 0;
+#endif
+      }
+
+      //----------------------------------------------------------------------
+      //!  Returns the nanoseconds since @c start (from Now()), or 0 if
+      //!  @c start is 0 (the probe wasn't attached when it was taken).
+      //----------------------------------------------------------------------
+      inline uint64_t Since(uint64_t start)
+      {
+        return (start ? (Now() - start) : 0);
+      }
+      
+#if DWM_PKG_PROBES_ENABLED
+      //----------------------------------------------------------------------
+      //!  The path of the file being scanned by this thread, for probes
+      //!  below the point where we still have it (ScanImage() and
+      //!  ScanMemory() only see bytes).
+      //----------------------------------------------------------------------
+      inline thread_local const char  *t_path = nullptr;
+
+      //----------------------------------------------------------------------
+      //!  Returns true if any probe that reports Path() is attached.
+      //----------------------------------------------------------------------
+      inline bool PathProbesEnabled()
+      {
+        return (DWM_PKG_PROBE_ENABLED(map) || DWM_PKG_PROBE_ENABLED(read)
+                || DWM_PKG_PROBE_ENABLED(scan_start)
+                || DWM_PKG_PROBE_ENABLED(scan_end)
+                || DWM_PKG_PROBE_ENABLED(hit_found)
+                || DWM_PKG_PROBE_ENABLED(parse_success)
+                || DWM_PKG_PROBE_ENABLED(parse_fail));
+      }
+#endif
+      
+      //----------------------------------------------------------------------
+      //!  Sets the path reported by this thread's probes for its lifetime.
+      //!  Does nothing if no probe that reports the path is attached when
+      //!  it's constructed, so probes attached within the scope report "".
+      //----------------------------------------------------------------------
+      class PathScope
+      {
+      public:
+#if DWM_PKG_PROBES_ENABLED
+        explicit PathScope(const char *path)
+            : _set(PathProbesEnabled()), _prev(nullptr)
+        {
+          if (_set) {
+            _prev = t_path;
+            t_path = path;
+          }
+        }
+        
+        ~PathScope()
+        {
+          if (_set) {
+            t_path = _prev;
+          }
+        }
+        
+      private:
+        bool         _set;
+        const char  *_prev;
+#else
+        explicit PathScope(const char *)
+        {}
+#endif
+      };
+
+      //----------------------------------------------------------------------
+      //!  Returns the path set by the innermost PathScope in this thread,
+      //!  or "" if there is none.
+      //----------------------------------------------------------------------
+      inline const char *Path()
+      {
+#if DWM_PKG_PROBES_ENABLED
+        return (t_path ? t_path : "");
+#else
+        return "";
+#endif
+      }
+      
+    }  // namespace Probes
+
+  }  // namespace Pkg
+
+}  // namespace Dwm
+
+#endif  // _DWMPKGPROBES_HH_
@@ -0,0 +1,246 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+
+//---------------------------------------------------------------------------
+//!  \file DwmPkgScanner.hh
+//!  \author Daniel W. McRobb
+//!  \brief Dwm::Pkg::Scanner class declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMPKGSCANNER_HH_
+#define _DWMPKGSCANNER_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "DwmPkgInfoView.hh"
+#include "DwmPkgPolite.hh"
+
+namespace Dwm {
+
+  namespace Pkg {
+
+    //------------------------------------------------------------------------
+    //!  Selects which found strings a Scanner reports.  The literal
+    //!  fields (name, status and type) are checked against the raw bytes
+    //!  of each candidate before it's parsed, which discards nearly
+    //!  everything in a targeted search.  Only candidates that pass the
+    //!  literal check are parsed and checked exactly.  A default
+    //!  constructed ScanFilter accepts everything.
+    //------------------------------------------------------------------------
+    struct ScanFilter
+    {
+      std::string  name;
+      std::string  status;
+      std::string  type;
+      std::vector<std::pair<std::string,std::string>>  versionRange;
+      std::size_t  limit = 0;   // per scan, 0 for no limit
+      std::size_t  maxLength = k_defaultMaxLength;  // 0 for no limit
+      bool         allBytes = false;  // scan whole images, not just data
+
+      //----------------------------------------------------------------------
+      //!  Hits longer than this many bytes are truncated.  Real strings
+      //!  are far shorter; longer ones come from corrupt or hostile
+      //!  files.
+      //----------------------------------------------------------------------
+      static constexpr std::size_t  k_defaultMaxLength = 4096;
+
+      //----------------------------------------------------------------------
+      //!  Returns true if we only want Dwm::Pkg::Info strings.
+      //----------------------------------------------------------------------
+      bool PkgsOnly() const;
+      
+      //----------------------------------------------------------------------
+      //!  Parses a version range such as "<0.0.3" or ">=1.2,<1.4" into
+      //!  versionRange.  A version without an operator means "==".
+      //!  Versions are compared with Dwm::Pkg::Version, so "0.0.10" is
+      //!  greater than "0.0.9" and "1.0.0-rc.1" is less than "1.0.0".
+      //!  Returns false if @c spec is invalid.
+      //----------------------------------------------------------------------
+      bool SetVersionRange(std::string_view spec);
+
+      //----------------------------------------------------------------------
+      //!  Sets status from a status name ("dev", "rc" or "rel").  Anything
+      //!  else is used as is, so the symbol itself may also be given.
+      //----------------------------------------------------------------------
+      void SetStatus(std::string_view s);
+
+      //----------------------------------------------------------------------
+      //!  Sets type from a package type name ("hdr", "lib", "exe" or
+      //!  "doc").  Anything else is used as is, so the symbol itself may
+      //!  also be given.
+      //----------------------------------------------------------------------
+      void SetType(std::string_view t);
+
+      //----------------------------------------------------------------------
+      //!  Cheap check of the raw bytes of candidate string @c s.  Returns
+      //!  false if @c s can't possibly match.
+      //----------------------------------------------------------------------
+      bool Prefilter(std::string_view s) const;
+
+      //----------------------------------------------------------------------
+      //!  Exact check of the parsed fields @c info.
+      //----------------------------------------------------------------------
+      bool Matches(const InfoView & info) const;
+    };
+
+    //------------------------------------------------------------------------
+    //!  The encoding a found string was stored in.
+    //------------------------------------------------------------------------
+    enum class TextEncoding : std::uint8_t
+    {
+      k_utf8,
+      k_utf16le,
+      k_utf16be
+    };
+
+    //------------------------------------------------------------------------
+    //!  Returns "utf-8", "utf-16le" or "utf-16be".
+    //------------------------------------------------------------------------
+    const char *TextEncodingName(TextEncoding encoding);
+    
+    //------------------------------------------------------------------------
+    //!  A string found by a Scanner.  All views point into the scanned
+    //!  data (or, for UTF-16 strings, into the Scanner's UTF-8 copy) and
+    //!  are only valid for the duration of the callback.  Truncated hits
+    //!  are never parsed.
+    //------------------------------------------------------------------------
+    struct ScanHit
+    {
+      std::string_view   raw;      //!< the whole string, including "@(#)"
+      std::size_t        offset;   //!< offset of "@(#)" in the scanned data
+      const InfoView    *info;     //!< parsed fields, or nullptr
+      bool               truncated = false;  //!< raw was cut at maxLength
+      TextEncoding       encoding = TextEncoding::k_utf8;  //!< as stored
+    };
+
+    //------------------------------------------------------------------------
+    //!  Called once per hit.  Return false to stop scanning.
+    //------------------------------------------------------------------------
+    using ScanCallback = std::function<bool(const ScanHit &)>;
+    
+    //------------------------------------------------------------------------
+    //!  Finds strings starting with "@(#)" in files, file descriptors or
+    //!  memory, like what(1), and hands each one to a callback as it's
+    //!  found.  Nothing is copied, except that strings stored as UTF-16
+    //!  (little or big endian, as in Windows resources and Java or ICU
+    //!  data) are found in the same pass and handed over transcoded to
+    //!  UTF-8.  When parsing is enabled, hits that are Dwm::Pkg::Info
+    //!  strings are also handed over in parsed form.
+    //!
+    //!  A Scanner holds no mutable state (a Polite object it's given is
+    //!  thread safe), so one instance may be used by any number of
+    //!  threads at once.
+    //------------------------------------------------------------------------
+    class Scanner
+    {
+    public:
+      //----------------------------------------------------------------------
+      //!  Construct with the given @c filter.  If @c parse is true, hits
+      //!  are parsed as Dwm::Pkg::Info and ScanHit::info is set for those
+      //!  that parse.  Hits are always parsed if @c filter needs it.
+      //----------------------------------------------------------------------
+      explicit Scanner(const ScanFilter & filter = ScanFilter(),
+                       bool parse = true);
+
+      //----------------------------------------------------------------------
+      //!  Scans the file at @c path.  Returns false if the file could
+      //!  not be opened or read.
+      //----------------------------------------------------------------------
+      bool ScanFile(const std::string & path, const ScanCallback & cb) const;
+
+      //----------------------------------------------------------------------
+      //!  Scans the contents of @c fd from its start with ScanImage().
+      //!  Regular files are mapped, anything else is read.  Returns false
+      //!  on error.
+      //----------------------------------------------------------------------
+      bool ScanFd(int fd, const ScanCallback & cb) const;
+
+      //----------------------------------------------------------------------
+      //!  Scans @c len bytes at @c data.  Returns the number of hits
+      //!  handed to @c cb.
+      //----------------------------------------------------------------------
+      std::size_t ScanMemory(const char *data, std::size_t len,
+                             const ScanCallback & cb) const;
+
+      //----------------------------------------------------------------------
+      //!  Scans @c len bytes at @c data.  If they're an ELF, Mach-O or PE
+      //!  image (see FindDataRanges()), only the sections that can hold
+      //!  strings are scanned, unless the filter's allBytes is set.
+      //!  Hit offsets are relative to @c data either way.  Returns the
+      //!  number of hits handed to @c cb.
+      //----------------------------------------------------------------------
+      std::size_t ScanImage(const char *data, std::size_t len,
+                            const ScanCallback & cb) const;
+      
+      //----------------------------------------------------------------------
+      //!  Returns the filter.
+      //----------------------------------------------------------------------
+      const ScanFilter & Filter() const
+      { return _filter; }
+
+      //----------------------------------------------------------------------
+      //!  Makes ScanFile() and ScanFd() (and BatchScanner) polite: bytes
+      //!  mapped or read are taken from @c polite's token bucket, and
+      //!  pages we bring into the page cache are dropped afterward if
+      //!  @c polite wants that.  @c polite must outlive the Scanner.
+      //!  Pass nullptr to stop being polite.
+      //----------------------------------------------------------------------
+      void SetPolite(Polite *polite)
+      { _polite = polite; }
+
+      //----------------------------------------------------------------------
+      //!  Returns the Polite object set with SetPolite(), or nullptr.
+      //----------------------------------------------------------------------
+      Polite *GetPolite() const
+      { return _polite; }
+      
+    private:
+      ScanFilter  _filter;
+      bool        _parse;
+      Polite     *_polite;
+    };
+    
+  }  // namespace Pkg
+
+}  // namespace Dwm
+
+#endif  // _DWMPKGSCANNER_HH_
@@ -44,13 +44,14 @@
 
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstdint>
 #include <limits>
-#include <numeric>
 #include <ranges>
 #include <string_view>
 #include <type_traits>
+#include <utility>
 
 namespace Dwm {
 
@@ -59,11 +60,12 @@ namespace Dwm {
     //------------------------------------------------------------------------
     //!  The idea of this template: hold a concatenated string literal that
     //!  is constructed from a variadic list of string literals, with the
-    //!  length of each string literal stored in an array.  This allows one
+    //!  length of each string literal kept in the type.  This allows one
     //!  string literal to be stored in a binary, but each 'segement' is
     //!  retrievable via the @c nth() member.
-    //!  This is primarily here to support the Dwm::Pkg::Info class, but
-    //!  I split it out simply because it's useful for other things.
+    //!  This was originally the base of Dwm::Pkg::Info, which no longer
+    //!  uses it (an Info type depends only on its total size, to keep the
+    //!  number of instantiations down), but it's useful for other things.
     //!  You can do this:
     //!
     //!  SegmentedLiteral foo("foo","1.0.1","My Name 2025",__DATE__,__FILE__);
@@ -74,16 +76,35 @@ namespace Dwm {
     //!  Probably worth noting some of the goals of this class template:
     //!   - Keep a contiguous single string literal so it can be found as
     //!     one string in a binary.
-    //!   - Try to minimize the space utilized for the array of segment
-    //!     lengths.
+    //!   - Keep nothing else in an instance.  The delimiter length and
+    //!     segment lengths are template arguments, and the total size,
+    //!     segment lengths and segment offsets are static constexpr
+    //!     members, so an instance is exactly its characters (including
+    //!     the terminating null).  The length and offset tables are only
+    //!     emitted (once per type, not per instance) if nth() is called
+    //!     with an index that isn't known at compile time.
     //!   - Almost everything needs to be done at compile time so that
     //!     the compiler is aware of a single string literal ("constexpr
     //!     all the things", Jason Turner).
     //------------------------------------------------------------------------
-    template <std::size_t DelimLen, std::size_t NumSegs, std::size_t NumChars>
+    template <std::size_t DelimLen, std::size_t ...SegLens>
     class SegmentedLiteral
     {
     public:
+      static_assert(sizeof...(SegLens) > 0);
+
+      //----------------------------------------------------------------------
+      //!  Number of segments.
+      //----------------------------------------------------------------------
+      static constexpr std::size_t  NumSegs = sizeof...(SegLens);
+
+      //----------------------------------------------------------------------
+      //!  Size of the buffer: all segments, the delimiters between them
+      //!  and a terminating null.
+      //----------------------------------------------------------------------
+      static constexpr std::size_t  NumChars =
+        (SegLens + ...) + (DelimLen * (NumSegs - 1)) + 1;
+      
       using SegLenType =
         std::conditional<(NumChars <= 256),
                          uint8_t,
@@ -92,6 +113,27 @@ namespace Dwm {
                                                    uint32_t>::type>::type;
       using BufType = const char(&)[NumChars];
 
+      static constexpr std::size_t  size = NumChars;
+      static constexpr std::size_t  delimLen = DelimLen;
+
+      //----------------------------------------------------------------------
+      //!  Length of each segment.
+      //----------------------------------------------------------------------
+      static constexpr SegLenType  seglengths[NumSegs] = { SegLens... };
+
+      //----------------------------------------------------------------------
+      //!  Offset of each segment in the buffer.
+      //----------------------------------------------------------------------
+      static constexpr auto  segoffsets = [] {
+        std::array<SegLenType,NumSegs>  offs {};
+        std::size_t  off = 0;
+        for (std::size_t i = 0; i < NumSegs; ++i) {
+          offs[i] = off;
+          off += seglengths[i] + DelimLen;
+        }
+        return offs;
+      }();
+      
       //----------------------------------------------------------------------
       //!  
       //----------------------------------------------------------------------
@@ -100,13 +142,16 @@ namespace Dwm {
                                  const char (&...s)[Ns])
       {
         static_assert((NumChars) <= std::numeric_limits<SegLenType>::max());
-
+        static_assert(((D - 1) == DelimLen)
+                      && std::is_same_v<std::index_sequence<F-1,(Ns-1)...>,
+                                        std::index_sequence<SegLens...>>,
+                      "arguments don't match the template arguments");
+        static_assert(sizeof(SegmentedLiteral) == NumChars,
+                      "SegmentedLiteral should hold only its characters");
+        
         //  'f' is just 'first'
         auto  it = std::ranges::copy_n(f,F-1,_buffer).out;
-        std::size_t  si = 0;
-        seglengths[si++] = F-1;
-        ((seglengths[si++] = Ns-1,
-          it = std::ranges::copy_n(delim,D-1,it).out,
+        ((it = std::ranges::copy_n(delim,D-1,it).out,
           it = std::ranges::copy_n(s,Ns-1,it).out), ...);
         *it = '\0';
       }
@@ -141,9 +186,7 @@ namespace Dwm {
       constexpr std::string_view nth(std::size_t n) const noexcept
       {
         assert(n < NumSegs);
-        std::size_t  off = std::accumulate(seglengths, &seglengths[n], 0);
-        off += (n - 0) * delimLen;
-        return std::string_view(_buffer + off, seglengths[n]);
+        return std::string_view(_buffer + segoffsets[n], seglengths[n]);
       }
       
       //----------------------------------------------------------------------
@@ -153,10 +196,7 @@ namespace Dwm {
       { return sizeof(SegLenType); }
 
     protected:
-      char         _buffer[NumChars] {};
-      std::size_t  size = NumChars;
-      SegLenType   seglengths[NumSegs] {};
-      std::size_t  delimLen = DelimLen;
+      char  _buffer[NumChars] {};
     };
 
     //------------------------------------------------------------------------
@@ -175,20 +215,16 @@ namespace Dwm {
       SegmentedLiteralChars<D,Ns...>::sz;
     
     //------------------------------------------------------------------------
-    //!  Deduction guide.  This is critical, since we need to deduce DelimLen,
-    //!  NumSegs and NumChars to instantiate the template.  We deduce
-    //!  DelimLen from the length of delim, minus 1 (remove null).  We
-    //!  deduce the number of segments from the number of variadic
-    //!  arguments (sizeof...(Ns)).  To deduce NumChars, we add up the
-    //!  length of all of the variadic arguments (minus 1 for each to ignore
-    //!  null termination).  We then add the number of characters we need to
-    //!  store delimiter strings.  Here we need D-1 characters for each,
-    //!  and we need (sizeof...(Ns) - 1) of them (they only go between
-    //!  segments, not before the first segment or after the last segment).
+    //!  Deduction guide.  This is critical, since we need to deduce DelimLen
+    //!  and the segment lengths to instantiate the template.  We deduce
+    //!  DelimLen from the length of delim, minus 1 (remove null), and each
+    //!  segment length from the length of each variadic argument, minus 1
+    //!  (ignore null termination).  The number of segments and number of
+    //!  characters follow from those.
     //------------------------------------------------------------------------
     template <std::size_t D, std::size_t ...Ns>
     SegmentedLiteral(const char (&delim)[D], const char (&...s)[Ns])
-      -> SegmentedLiteral<D-1,sizeof...(Ns),SegmentedLiteralChars_v<D,Ns...>>;
+      -> SegmentedLiteral<D-1,(Ns-1)...>;
     
   }  // namespace Pkg
 
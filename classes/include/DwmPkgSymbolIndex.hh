@@ -0,0 +1,124 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  \file DwmPkgSymbolIndex.hh
+//!  \author Daniel W. McRobb
+//!  \brief Dwm::Pkg::SymbolIndex class declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMPKGSYMBOLINDEX_HH_
+#define _DWMPKGSYMBOLINDEX_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "DwmPkgImage.hh"
+
+namespace Dwm {
+
+  namespace Pkg {
+
+    //------------------------------------------------------------------------
+    //!  Maps file offsets in an ELF image to virtual addresses and the
+    //!  symbols (from .symtab and .dynsym) that contain them, so a hit
+    //!  from Scanner::ScanImage() can be attributed to the variable that
+    //!  holds it.  The symbols are flattened into a sorted array of
+    //!  disjoint address ranges when the index is built, each naming
+    //!  the innermost symbol covering it, so a lookup is one binary
+    //!  search no matter how many symbols the image has.
+    //!
+    //!  Symbol names are views into the image, which must outlive the
+    //!  index.
+    //------------------------------------------------------------------------
+    class SymbolIndex
+    {
+    public:
+      SymbolIndex();
+      
+      //----------------------------------------------------------------------
+      //!  Builds the index for the ELF image in the @c len bytes at
+      //!  @c data.  Returns false if it's not an ELF image.  A stripped
+      //!  image gives an empty index, but offsets can still be mapped
+      //!  to addresses.
+      //----------------------------------------------------------------------
+      bool Build(const char *data, std::size_t len);
+
+      //----------------------------------------------------------------------
+      //!  Sets @c addr to the virtual address of file offset @c offset
+      //!  and returns true, or returns false if @c offset isn't in a
+      //!  loaded segment.  For relocatable objects, which have no
+      //!  segments, addresses are file offsets.
+      //----------------------------------------------------------------------
+      bool OffsetToAddr(uint64_t offset, uint64_t & addr) const;
+      
+      //----------------------------------------------------------------------
+      //!  Returns the (mangled) name of the innermost symbol containing
+      //!  @c addr, or an empty view if there is none.
+      //----------------------------------------------------------------------
+      std::string_view Find(uint64_t addr) const;
+
+      //----------------------------------------------------------------------
+      //!  Returns the number of address ranges in the index.
+      //----------------------------------------------------------------------
+      std::size_t Size() const
+      { return _ranges.size(); }
+      
+    private:
+      struct SymbolRange
+      {
+        uint64_t          start;
+        uint64_t          end;
+        std::string_view  name;
+      };
+      
+      std::vector<CoreSegment>  _segments;   // sorted by file offset
+      std::vector<SymbolRange>  _ranges;     // disjoint, sorted by start
+    };
+
+    //------------------------------------------------------------------------
+    //!  Returns the demangled form of C++ symbol @c name, or @c name if
+    //!  it isn't a mangled C++ name.
+    //------------------------------------------------------------------------
+    std::string Demangle(std::string_view name);
+    
+  }  // namespace Pkg
+
+}  // namespace Dwm
+
+#endif  // _DWMPKGSYMBOLINDEX_HH_
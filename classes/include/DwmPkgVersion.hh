@@ -0,0 +1,281 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  \file DwmPkgVersion.hh
+//!  \author Daniel W. McRobb
+//!  \brief Dwm::Pkg::Version class declaration
+//---------------------------------------------------------------------------
+
+#ifndef _DWMPKGVERSION_HH_
+#define _DWMPKGVERSION_HH_
+
+#include <compare>
+#include <string_view>
+
+namespace Dwm {
+
+  namespace Pkg {
+
+    //------------------------------------------------------------------------
+    //!  A semantic version (https://semver.org) as a view into a version
+    //!  string: a dotted core ("1.2.3"), an optional pre-release after
+    //!  the first '-' ("rc.1") and optional build metadata after the
+    //!  first '+'.  Everything is constexpr, so versions can be compared
+    //!  at compile time.
+    //!
+    //!  Ordering follows semver precedence, with some leniency for the
+    //!  version strings found in the wild:
+    //!  - Core components are compared numerically ("0.0.10" > "0.0.9"),
+    //!    of any length and without overflow.  A missing component is 0
+    //!    ("1.2" == "1.2.0").  Any non-numeric tail of a component
+    //!    ("3a") is compared lexically after the number.
+    //!  - A version with a pre-release is less than the same version
+    //!    without one ("1.0.0-rc.1" < "1.0.0").  Pre-release identifiers
+    //!    are compared numerically if both are numeric, else lexically,
+    //!    and numeric identifiers are less than non-numeric ones.
+    //!  - Build metadata is ignored.
+    //!
+    //!  Like InfoView, a Version never owns memory; it's only valid as
+    //!  long as the string it was made from.
+    //------------------------------------------------------------------------
+    class Version
+    {
+    public:
+      //----------------------------------------------------------------------
+      //!  Construct an empty version, which is equal to "0".
+      //----------------------------------------------------------------------
+      constexpr Version() noexcept = default;
+
+      //----------------------------------------------------------------------
+      //!  Construct from version string @c s.  Never fails; use Valid()
+      //!  to check for strict semver syntax.
+      //----------------------------------------------------------------------
+      constexpr explicit Version(std::string_view s) noexcept
+          : _core(s.substr(0, s.find_first_of("-+")))
+      {
+        s.remove_prefix(_core.size());
+        if ((! s.empty()) && (s.front() == '-')) {
+          _pre = s.substr(1, s.find('+') - 1);
+          s.remove_prefix(_pre.size() + 1);
+        }
+        if (! s.empty()) {
+          _build = s.substr(1);
+        }
+      }
+
+      //----------------------------------------------------------------------
+      //!  Returns the core ("1.2.3" of "1.2.3-rc.1+abc").
+      //----------------------------------------------------------------------
+      constexpr std::string_view core() const noexcept
+      { return _core; }
+
+      //----------------------------------------------------------------------
+      //!  Returns the pre-release ("rc.1" of "1.2.3-rc.1+abc").
+      //----------------------------------------------------------------------
+      constexpr std::string_view pre_release() const noexcept
+      { return _pre; }
+
+      //----------------------------------------------------------------------
+      //!  Returns the build metadata ("abc" of "1.2.3-rc.1+abc").
+      //----------------------------------------------------------------------
+      constexpr std::string_view build() const noexcept
+      { return _build; }
+
+      //----------------------------------------------------------------------
+      //!  Returns true if we're strict semver: exactly three numeric core
+      //!  components without leading zeros, and non-empty pre-release and
+      //!  build identifiers of [0-9A-Za-z-] (numeric pre-release
+      //!  identifiers without leading zeros).
+      //----------------------------------------------------------------------
+      constexpr bool Valid() const noexcept
+      {
+        std::string_view  core = _core;
+        for (int i = 0; i < 3; ++i) {
+          std::string_view  c = Next(core);
+          if (c.empty() || (! IsNumeric(c))
+              || ((c.size() > 1) && (c[0] == '0'))) {
+            return false;
+          }
+        }
+        if (! core.empty()) {
+          return false;
+        }
+        return (ValidIdents(_pre, true) && ValidIdents(_build, false));
+      }
+
+      //----------------------------------------------------------------------
+      //!  Returns less than 0, 0 or greater than 0 if we're less than,
+      //!  equal to or greater than @c v.
+      //----------------------------------------------------------------------
+      constexpr int Compare(const Version & v) const noexcept
+      {
+        std::string_view  a = _core, b = v._core;
+        while ((! a.empty()) || (! b.empty())) {
+          if (int cmp = CompareCoreComponent(Next(a), Next(b))) {
+            return cmp;
+          }
+        }
+        if (_pre.empty() || v._pre.empty()) {
+          return ((int)_pre.empty() - (int)v._pre.empty());
+        }
+        a = _pre;
+        b = v._pre;
+        while ((! a.empty()) && (! b.empty())) {
+          if (int cmp = ComparePreIdent(Next(a), Next(b))) {
+            return cmp;
+          }
+        }
+        return ((int)(! a.empty()) - (int)(! b.empty()));
+      }
+
+      //----------------------------------------------------------------------
+      //!  Equality is precedence equality ("1.2" == "1.2.0+abc").
+      //----------------------------------------------------------------------
+      constexpr bool operator == (const Version & v) const noexcept
+      { return (Compare(v) == 0); }
+
+      constexpr std::strong_ordering
+      operator <=> (const Version & v) const noexcept
+      { return (Compare(v) <=> 0); }
+      
+    private:
+      std::string_view  _core;
+      std::string_view  _pre;
+      std::string_view  _build;
+
+      //----------------------------------------------------------------------
+      //!  Saves including <algorithm> for std::min(), since this header
+      //!  is included by DwmPkgInfo.hh and hence by everything.
+      //----------------------------------------------------------------------
+      static constexpr std::size_t Min(std::size_t a, std::size_t b) noexcept
+      { return ((a < b) ? a : b); }
+      
+      //----------------------------------------------------------------------
+      //!  Removes and returns the next dot-separated identifier of @c s.
+      //----------------------------------------------------------------------
+      static constexpr std::string_view Next(std::string_view & s) noexcept
+      {
+        std::string_view  rc = s.substr(0, s.find('.'));
+        s.remove_prefix(Min(s.size(), rc.size() + 1));
+        return rc;
+      }
+
+      static constexpr bool IsDigit(char c) noexcept
+      { return ((c >= '0') && (c <= '9')); }
+
+      static constexpr bool IsNumeric(std::string_view s) noexcept
+      {
+        for (char c : s) {
+          if (! IsDigit(c)) {
+            return false;
+          }
+        }
+        return (! s.empty());
+      }
+
+      static constexpr bool ValidIdents(std::string_view s,
+                                        bool noLeadingZeros) noexcept
+      {
+        if (s.data() == nullptr) {
+          return true;
+        }
+        do {
+          std::string_view  id = Next(s);
+          if (id.empty()) {
+            return false;
+          }
+          for (char c : id) {
+            if (! (IsDigit(c) || ((c >= 'A') && (c <= 'Z'))
+                   || ((c >= 'a') && (c <= 'z')) || (c == '-'))) {
+              return false;
+            }
+          }
+          if (noLeadingZeros && IsNumeric(id) && (id.size() > 1)
+              && (id[0] == '0')) {
+            return false;
+          }
+        } while (! s.empty());
+        return true;
+      }
+
+      //----------------------------------------------------------------------
+      //!  Compares two unsigned decimal digit strings of any length.
+      //----------------------------------------------------------------------
+      static constexpr int CompareNumbers(std::string_view a,
+                                          std::string_view b) noexcept
+      {
+        a.remove_prefix(Min(a.size(), a.find_first_not_of('0')));
+        b.remove_prefix(Min(b.size(), b.find_first_not_of('0')));
+        if (a.size() != b.size()) {
+          return ((a.size() < b.size()) ? -1 : 1);
+        }
+        int  cmp = a.compare(b);
+        return ((cmp > 0) - (cmp < 0));
+      }
+      
+      static constexpr int
+      CompareCoreComponent(std::string_view a, std::string_view b) noexcept
+      {
+        std::size_t  ai = 0, bi = 0;
+        while ((ai < a.size()) && IsDigit(a[ai])) { ++ai; }
+        while ((bi < b.size()) && IsDigit(b[bi])) { ++bi; }
+        if (int cmp = CompareNumbers(a.substr(0, ai), b.substr(0, bi))) {
+          return cmp;
+        }
+        int  cmp = a.substr(ai).compare(b.substr(bi));
+        return ((cmp > 0) - (cmp < 0));
+      }
+
+      static constexpr int
+      ComparePreIdent(std::string_view a, std::string_view b) noexcept
+      {
+        bool  an = IsNumeric(a), bn = IsNumeric(b);
+        if (an && bn) {
+          return CompareNumbers(a, b);
+        }
+        if (an != bn) {
+          return (an ? -1 : 1);
+        }
+        int  cmp = a.compare(b);
+        return ((cmp > 0) - (cmp < 0));
+      }
+    };
+    
+  }  // namespace Pkg
+
+}  // namespace Dwm
+
+#endif  // _DWMPKGVERSION_HH_
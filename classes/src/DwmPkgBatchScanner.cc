@@ -0,0 +1,676 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+
+//---------------------------------------------------------------------------
+//!  \file DwmPkgBatchScanner.cc
+//!  \author Daniel W. McRobb
+//!  \brief Dwm::Pkg::BatchScanner class implementation
+//---------------------------------------------------------------------------
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+  #define DWM_PKG_HAVE_URING 1
+#endif
+
+extern "C" {
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <errno.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+#ifdef DWM_PKG_HAVE_URING
+  #include <sys/syscall.h>
+  #include <sys/uio.h>
+  #include <linux/io_uring.h>
+#endif
+}
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+
+#include "DwmPkgBatchScanner.hh"
+#include "DwmPkgImage.hh"
+#include "DwmPkgProbes.hh"
+
+namespace Dwm {
+
+  namespace Pkg {
+
+#ifdef DWM_PKG_HAVE_URING
+
+    //------------------------------------------------------------------------
+    //!  Just enough of an io_uring for BatchScanner, using the raw system
+    //!  calls so we don't depend on liburing.  Single threaded.
+    //------------------------------------------------------------------------
+    class BatchScanner::Uring
+    {
+    public:
+      Uring()
+          : _fd(-1), _sqRing(MAP_FAILED), _sqRingSize(0),
+            _cqRing(MAP_FAILED), _cqRingSize(0), _sqes(nullptr),
+            _sqesSize(0), _sqTail(0), _toSubmit(0), _entries(0),
+            _fixedBufs(false)
+      {}
+
+      ~Uring()
+      {
+        if (_sqes) {
+          munmap(_sqes, _sqesSize);
+        }
+        if (_cqRing != MAP_FAILED && _cqRing != _sqRing) {
+          munmap(_cqRing, _cqRingSize);
+        }
+        if (_sqRing != MAP_FAILED) {
+          munmap(_sqRing, _sqRingSize);
+        }
+        if (_fd >= 0) {
+          close(_fd);
+        }
+      }
+
+      //----------------------------------------------------------------------
+      //!  Sets up a ring with @c entries submission queue entries and
+      //!  tries to register @c numBufs buffers of @c bufSize bytes at
+      //!  @c bufs.  Returns false if the kernel can't give us a ring
+      //!  with the operations we need.
+      //----------------------------------------------------------------------
+      bool Init(unsigned int entries, char *bufs, std::size_t bufSize,
+                unsigned int numBufs)
+      {
+        struct io_uring_params  p;
+        memset(&p, 0, sizeof(p));
+        _fd = (int)syscall(__NR_io_uring_setup, entries, &p);
+        if (_fd < 0) {
+          return false;
+        }
+        _entries = p.sq_entries;
+        _sqRingSize = p.sq_off.array + p.sq_entries * sizeof(uint32_t);
+        _cqRingSize = p.cq_off.cqes
+          + p.cq_entries * sizeof(struct io_uring_cqe);
+        if (p.features & IORING_FEAT_SINGLE_MMAP) {
+          _sqRingSize = _cqRingSize = std::max(_sqRingSize, _cqRingSize);
+        }
+        _sqRing = mmap(nullptr, _sqRingSize, PROT_READ|PROT_WRITE,
+                       MAP_SHARED|MAP_POPULATE, _fd, IORING_OFF_SQ_RING);
+        if (_sqRing == MAP_FAILED) {
+          return false;
+        }
+        if (p.features & IORING_FEAT_SINGLE_MMAP) {
+          _cqRing = _sqRing;
+        }
+        else {
+          _cqRing = mmap(nullptr, _cqRingSize, PROT_READ|PROT_WRITE,
+                         MAP_SHARED|MAP_POPULATE, _fd, IORING_OFF_CQ_RING);
+          if (_cqRing == MAP_FAILED) {
+            return false;
+          }
+        }
+        _sqesSize = p.sq_entries * sizeof(struct io_uring_sqe);
+        void  *sqes = mmap(nullptr, _sqesSize, PROT_READ|PROT_WRITE,
+                           MAP_SHARED|MAP_POPULATE, _fd, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+          return false;
+        }
+        _sqes = (struct io_uring_sqe *)sqes;
+
+        char  *sq = (char *)_sqRing;
+        _sqHeadp  = (uint32_t *)(sq + p.sq_off.head);
+        _sqTailp  = (uint32_t *)(sq + p.sq_off.tail);
+        _sqMask   = *(uint32_t *)(sq + p.sq_off.ring_mask);
+        _sqArray  = (uint32_t *)(sq + p.sq_off.array);
+        char  *cq = (char *)_cqRing;
+        _cqHeadp  = (uint32_t *)(cq + p.cq_off.head);
+        _cqTailp  = (uint32_t *)(cq + p.cq_off.tail);
+        _cqMask   = *(uint32_t *)(cq + p.cq_off.ring_mask);
+        _cqes     = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+        _sqTail   = *_sqTailp;
+
+        if (! Supports({IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ,
+                        IORING_OP_READ_FIXED, IORING_OP_CLOSE})) {
+          return false;
+        }
+
+        //  Registering buffers can fail (RLIMIT_MEMLOCK, for example).
+        //  We can live without it.
+        std::vector<struct iovec>  iovs(numBufs);
+        for (unsigned int i = 0; i < numBufs; ++i) {
+          iovs[i].iov_base = bufs + (i * bufSize);
+          iovs[i].iov_len = bufSize;
+        }
+        _fixedBufs =
+          (syscall(__NR_io_uring_register, _fd, IORING_REGISTER_BUFFERS,
+                   iovs.data(), numBufs) == 0);
+        return true;
+      }
+
+      //----------------------------------------------------------------------
+      //!  Returns true if the buffers were registered.
+      //----------------------------------------------------------------------
+      bool FixedBufs() const
+      { return _fixedBufs; }
+      
+      //----------------------------------------------------------------------
+      //!  Returns a zeroed submission queue entry, submitting what's
+      //!  queued first if the queue is full.
+      //----------------------------------------------------------------------
+      struct io_uring_sqe *GetSqe(uint8_t opcode, int fd, const void *addr,
+                                  uint32_t len, uint64_t off,
+                                  uint64_t userData)
+      {
+        while (_toSubmit == _entries) {
+          Enter(0);
+        }
+        uint32_t             idx = _sqTail & _sqMask;
+        struct io_uring_sqe *sqe = &_sqes[idx];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = opcode;
+        sqe->fd = fd;
+        sqe->addr = (uint64_t)(uintptr_t)addr;
+        sqe->len = len;
+        sqe->off = off;
+        sqe->user_data = userData;
+        _sqArray[idx] = idx;
+        ++_sqTail;
+        __atomic_store_n(_sqTailp, _sqTail, __ATOMIC_RELEASE);
+        ++_toSubmit;
+        return sqe;
+      }
+
+      //----------------------------------------------------------------------
+      //!  Submits everything queued and waits for at least @c minComplete
+      //!  completions.
+      //----------------------------------------------------------------------
+      void Enter(unsigned int minComplete)
+      {
+        for (;;) {
+          long  rc = syscall(__NR_io_uring_enter, _fd, _toSubmit,
+                             minComplete,
+                             minComplete ? IORING_ENTER_GETEVENTS : 0,
+                             nullptr, 0);
+          if (rc >= 0) {
+            _toSubmit -= std::min<unsigned int>(rc, _toSubmit);
+            return;
+          }
+          if ((errno != EINTR) && (errno != EAGAIN)) {
+            return;
+          }
+        }
+      }
+
+      //----------------------------------------------------------------------
+      //!  Calls @c fn(userData, res) for each available completion.
+      //!  Returns the number of completions.
+      //----------------------------------------------------------------------
+      template <typename Fn>
+      unsigned int Reap(Fn && fn)
+      {
+        unsigned int  n = 0;
+        uint32_t      head = *_cqHeadp;
+        for (;;) {
+          uint32_t  tail = __atomic_load_n(_cqTailp, __ATOMIC_ACQUIRE);
+          if (head == tail) {
+            break;
+          }
+          const struct io_uring_cqe  & cqe = _cqes[head & _cqMask];
+          uint64_t  userData = cqe.user_data;
+          int32_t   res = cqe.res;
+          ++head;
+          __atomic_store_n(_cqHeadp, head, __ATOMIC_RELEASE);
+          fn(userData, res);
+          ++n;
+        }
+        return n;
+      }
+      
+    private:
+      int                   _fd;
+      void                 *_sqRing;
+      std::size_t           _sqRingSize;
+      void                 *_cqRing;
+      std::size_t           _cqRingSize;
+      struct io_uring_sqe  *_sqes;
+      std::size_t           _sqesSize;
+      uint32_t             *_sqHeadp;
+      uint32_t             *_sqTailp;
+      uint32_t              _sqMask;
+      uint32_t             *_sqArray;
+      uint32_t             *_cqHeadp;
+      uint32_t             *_cqTailp;
+      uint32_t              _cqMask;
+      struct io_uring_cqe  *_cqes;
+      uint32_t              _sqTail;
+      unsigned int          _toSubmit;
+      unsigned int          _entries;
+      bool                  _fixedBufs;
+
+      //----------------------------------------------------------------------
+      //!  
+      //----------------------------------------------------------------------
+      bool Supports(std::initializer_list<uint8_t> ops)
+      {
+        std::size_t  len = sizeof(struct io_uring_probe)
+          + 256 * sizeof(struct io_uring_probe_op);
+        std::vector<char>  buf(len, 0);
+        auto  probe = (struct io_uring_probe *)buf.data();
+        if (syscall(__NR_io_uring_register, _fd, IORING_REGISTER_PROBE,
+                    probe, 256) < 0) {
+          return false;
+        }
+        for (auto op : ops) {
+          if ((op > probe->last_op)
+              || (! (probe->ops[op].flags & IO_URING_OP_SUPPORTED))) {
+            return false;
+          }
+        }
+        return true;
+      }
+    };
+
+#else
+
+    class BatchScanner::Uring {};
+    
+#endif  // DWM_PKG_HAVE_URING
+    
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    BatchScanner::BatchScanner(const Scanner & scanner, unsigned int depth,
+                               std::size_t bufSize, bool useUring)
+        : _scanner(scanner), _depth(std::max(depth, 1U)),
+          _bufSize(std::max<std::size_t>(bufSize, 4096)), _bufs(nullptr),
+          _ring(), _buildIdCb()
+    {
+      //  Page aligned, so reads can be direct.
+      _bufSize = (_bufSize + 4095) & ~((std::size_t)4095);
+      void  *p = mmap(nullptr, _depth * _bufSize, PROT_READ|PROT_WRITE,
+                      MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+      if (p != MAP_FAILED) {
+        _bufs = (char *)p;
+      }
+#ifdef DWM_PKG_HAVE_URING
+      if (useUring && _bufs) {
+        _ring = std::make_unique<Uring>();
+        if (! _ring->Init(_depth * 4, _bufs, _bufSize, _depth)) {
+          _ring.reset();
+        }
+      }
+#else
+      (void)useUring;
+#endif
+    }
+
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    BatchScanner::~BatchScanner()
+    {
+      _ring.reset();
+      if (_bufs) {
+        munmap(_bufs, _depth * _bufSize);
+      }
+    }
+
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    void BatchScanner::Run(const std::vector<std::string> & paths,
+                           std::atomic<std::size_t> & next,
+                           const BatchCallback & cb,
+                           const BatchDoneCallback & done)
+    {
+      if (_ring && (! _scanner.GetPolite())) {
+        RunUring(paths, next, cb, done);
+      }
+      else {
+        RunRead(paths, next, cb, done);
+      }
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    //!  Returns false if the file at index @c fileIdx, whose first
+    //!  @c len bytes are at @c head, has a build ID that our build ID
+    //!  callback says not to scan.
+    //------------------------------------------------------------------------
+    bool BatchScanner::WantScan(std::size_t fileIdx, const char *head,
+                                std::size_t len)
+    {
+      if (_buildIdCb) {
+        std::string_view  buildId = FindBuildId(head, len);
+        if (! buildId.empty()) {
+          return _buildIdCb(fileIdx, buildId);
+        }
+      }
+      return true;
+    }
+
+    //------------------------------------------------------------------------
+    //!  Like WantScan(), for a file we haven't read.  Reads the start of
+    //!  the open file @c fd into @c buf (one of our buffers).
+    //------------------------------------------------------------------------
+    bool BatchScanner::WantScanFd(std::size_t fileIdx, int fd, char *buf)
+    {
+      if (_buildIdCb && buf) {
+        ssize_t  len;
+        do {
+          len = pread(fd, buf, _bufSize, 0);
+        } while ((len < 0) && (errno == EINTR));
+        if (len > 0) {
+          if (_scanner.GetPolite()) {
+            _scanner.GetPolite()->Take(len);
+          }
+          return WantScan(fileIdx, buf, len);
+        }
+      }
+      return true;
+    }
+    
+    //------------------------------------------------------------------------
+    //!  One file at a time: open, fstat, read into our buffer if it fits
+    //!  (else let the Scanner map it), scan, close.
+    //------------------------------------------------------------------------
+    void BatchScanner::RunRead(const std::vector<std::string> & paths,
+                               std::atomic<std::size_t> & next,
+                               const BatchCallback & cb,
+                               const BatchDoneCallback & done)
+    {
+      std::size_t  fileIdx;
+      while ((fileIdx = next++) < paths.size()) {
+        auto  hitcb = [&] (const ScanHit & hit) { return cb(fileIdx, hit); };
+        int   fd = open(paths[fileIdx].c_str(), O_RDONLY|O_CLOEXEC);
+        DWM_PKG_PROBE2(file_open, paths[fileIdx].c_str(), fd);
+        if (fd >= 0) {
+          Probes::PathScope  probePath(paths[fileIdx].c_str());
+          struct stat  st;
+          if (fstat(fd, &st) == 0) {
+            if ((! _bufs) || (! S_ISREG(st.st_mode))
+                || ((std::size_t)st.st_size > _bufSize)) {
+              //  Covers our read of the build ID as well as the scan.
+              PageCacheGuard  guard(S_ISREG(st.st_mode)
+                                    ? _scanner.GetPolite() : nullptr,
+                                    fd, nullptr, st.st_size);
+              if ((! S_ISREG(st.st_mode)) || WantScanFd(fileIdx, fd, _bufs)) {
+                _scanner.ScanFd(fd, hitcb);
+              }
+            }
+            else {
+              Polite  *polite = _scanner.GetPolite();
+              if (polite) {
+                polite->Take(st.st_size);
+              }
+              PageCacheGuard  guard(polite, fd, nullptr, st.st_size);
+              std::size_t  len = 0;
+              DWM_PKG_PROBE_TIMER(start, read);
+              while (len < (std::size_t)st.st_size) {
+                ssize_t  rc = read(fd, _bufs + len, st.st_size - len);
+                if (rc < 0 && errno == EINTR) {
+                  continue;
+                }
+                if (rc <= 0) {
+                  break;
+                }
+                len += rc;
+              }
+              DWM_PKG_PROBE3(read, Probes::Path(), len,
+                             Probes::Since(start));
+              if (len && WantScan(fileIdx, _bufs, len)) {
+                _scanner.ScanImage(_bufs, len, hitcb);
+              }
+            }
+          }
+          close(fd);
+        }
+        done(fileIdx);
+      }
+      return;
+    }
+
+#ifdef DWM_PKG_HAVE_URING
+    
+    namespace {
+
+      //----------------------------------------------------------------------
+      //!  The state of one in-flight file.
+      //----------------------------------------------------------------------
+      struct UringSlot
+      {
+        std::size_t   fileIdx;
+        int           fd;
+        int           openRes;
+        int           statxRes;
+        unsigned int  pending;
+        uint64_t      size;
+        uint64_t      off;
+        uint64_t      readStart;
+        struct statx  stx;
+      };
+
+      enum : uint64_t {
+        k_opOpen  = 1,
+        k_opStatx = 2,
+        k_opRead  = 3,
+        k_opClose = 4
+      };
+      
+    }  // anonymous namespace
+
+    //------------------------------------------------------------------------
+    //!  Each slot holds one file.  For each file we queue an openat and a
+    //!  statx together, then reads into the slot's buffer, then an async
+    //!  close.  The slot is refilled with the next file as soon as the
+    //!  file is scanned, so the ring stays full until we run out of
+    //!  files.
+    //------------------------------------------------------------------------
+    void BatchScanner::RunUring(const std::vector<std::string> & paths,
+                                std::atomic<std::size_t> & next,
+                                const BatchCallback & cb,
+                                const BatchDoneCallback & done)
+    {
+      std::vector<UringSlot>  slots(_depth);
+      unsigned int  numBusy = 0;
+      bool          exhausted = false;
+      Uring       & ring = *_ring;
+
+      auto  userData = [] (std::size_t slotIdx, uint64_t op) -> uint64_t
+      { return (((uint64_t)slotIdx) << 3) | op; };
+
+      auto  start = [&] (std::size_t s) {
+        if (exhausted) {
+          return;
+        }
+        std::size_t  fileIdx = next++;
+        if (fileIdx >= paths.size()) {
+          exhausted = true;
+          return;
+        }
+        UringSlot  & slot = slots[s];
+        slot.fileIdx = fileIdx;
+        slot.fd = -1;
+        slot.openRes = slot.statxRes = 0;
+        slot.pending = 2;
+        slot.size = slot.off = 0;
+        const char  *path = paths[fileIdx].c_str();
+        auto  sqe = ring.GetSqe(IORING_OP_OPENAT, AT_FDCWD, path, 0, 0,
+                                userData(s, k_opOpen));
+        sqe->open_flags = O_RDONLY|O_CLOEXEC;
+        ring.GetSqe(IORING_OP_STATX, AT_FDCWD, path,
+                          STATX_TYPE|STATX_SIZE, (uint64_t)&slot.stx,
+                          userData(s, k_opStatx));
+        ++numBusy;
+      };
+
+      auto  queueRead = [&] (std::size_t s) {
+        UringSlot  & slot = slots[s];
+        char  *buf = _bufs + (s * _bufSize) + slot.off;
+        if (ring.FixedBufs()) {
+          auto  sqe = ring.GetSqe(IORING_OP_READ_FIXED, slot.fd, buf,
+                                  slot.size - slot.off, slot.off,
+                                  userData(s, k_opRead));
+          sqe->buf_index = s;
+        }
+        else {
+          ring.GetSqe(IORING_OP_READ, slot.fd, buf, slot.size - slot.off,
+                      slot.off, userData(s, k_opRead));
+        }
+        slot.pending = 1;
+      };
+      
+      auto  finish = [&] (std::size_t s) {
+        UringSlot  & slot = slots[s];
+        if (slot.fd >= 0) {
+          ring.GetSqe(IORING_OP_CLOSE, slot.fd, nullptr, 0, 0,
+                      userData(s, k_opClose));
+          slot.fd = -1;
+        }
+        done(slot.fileIdx);
+        --numBusy;
+        start(s);
+      };
+
+      auto  scan = [&] (std::size_t s) {
+        UringSlot    & slot = slots[s];
+        std::size_t    fileIdx = slot.fileIdx;
+        char         *buf = _bufs + (s * _bufSize);
+        if (slot.off && WantScan(fileIdx, buf, slot.off)) {
+          Probes::PathScope  probePath(paths[fileIdx].c_str());
+          DWM_PKG_PROBE3(read, Probes::Path(), slot.off,
+                         Probes::Since(slot.readStart));
+          _scanner.ScanImage(buf, slot.off,
+                             [&] (const ScanHit & hit)
+                             { return cb(fileIdx, hit); });
+        }
+        finish(s);
+      };
+      
+      auto  opened = [&] (std::size_t s) {
+        UringSlot  & slot = slots[s];
+        DWM_PKG_PROBE2(file_open, paths[slot.fileIdx].c_str(), slot.openRes);
+        if ((slot.openRes < 0) || (slot.statxRes < 0)) {
+          finish(s);
+        }
+        else if ((! S_ISREG(slot.stx.stx_mode))
+                 || (slot.stx.stx_size > _bufSize)) {
+          //  Too big for our buffers; let the Scanner map it.
+          std::size_t  fileIdx = slot.fileIdx;
+          if ((! S_ISREG(slot.stx.stx_mode))
+              || WantScanFd(fileIdx, slot.fd, _bufs + (s * _bufSize))) {
+            Probes::PathScope  probePath(paths[fileIdx].c_str());
+            _scanner.ScanFd(slot.fd, [&] (const ScanHit & hit)
+                            { return cb(fileIdx, hit); });
+          }
+          finish(s);
+        }
+        else if (slot.stx.stx_size == 0) {
+          finish(s);
+        }
+        else {
+          slot.size = slot.stx.stx_size;
+          slot.readStart = (DWM_PKG_PROBE_ENABLED(read)
+                            ? Probes::Now() : 0);
+          queueRead(s);
+        }
+      };
+      
+      for (std::size_t s = 0; s < slots.size(); ++s) {
+        start(s);
+      }
+      while (numBusy) {
+        ring.Enter(1);
+        ring.Reap([&] (uint64_t ud, int32_t res) {
+          std::size_t  s = ud >> 3;
+          UringSlot  & slot = slots[s];
+          switch (ud & 7) {
+            case k_opOpen:
+              slot.openRes = res;
+              if (res >= 0) {
+                slot.fd = res;
+              }
+              if (--slot.pending == 0) {
+                opened(s);
+              }
+              break;
+            case k_opStatx:
+              slot.statxRes = res;
+              if (--slot.pending == 0) {
+                opened(s);
+              }
+              break;
+            case k_opRead:
+              if ((res == -EINTR) || (res == -EAGAIN)) {
+                queueRead(s);
+              }
+              else if (res < 0) {
+                finish(s);
+              }
+              else {
+                slot.off += res;
+                if ((res > 0) && (slot.off < slot.size)) {
+                  queueRead(s);   // short read
+                }
+                else {
+                  scan(s);
+                }
+              }
+              break;
+            default:
+              break;
+          }
+        });
+      }
+      //  Collect any outstanding closes.
+      ring.Enter(0);
+      ring.Reap([] (uint64_t, int32_t) {});
+      return;
+    }
+
+#else
+
+    void BatchScanner::RunUring(const std::vector<std::string> & paths,
+                                std::atomic<std::size_t> & next,
+                                const BatchCallback & cb,
+                                const BatchDoneCallback & done)
+    {
+      RunRead(paths, next, cb, done);
+    }
+    
+#endif  // DWM_PKG_HAVE_URING
+
+  }  // namespace Pkg
+
+}  // namespace Dwm
@@ -0,0 +1,292 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  \file DwmPkgC.cc
+//!  \author Daniel W. McRobb
+//!  \brief C interface to libDwmPkg
+//---------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#include "DwmPkgC.h"
+#include "DwmPkgInfoView.hh"
+#include "DwmPkgManifest.hh"
+#include "DwmPkgScanner.hh"
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+struct dwm_pkg_scanner
+{
+  Dwm::Pkg::Scanner  scanner;
+
+  explicit dwm_pkg_scanner(const Dwm::Pkg::ScanFilter & filter)
+      : scanner(filter)
+  {}
+};
+
+namespace {
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  dwm_pkg_str ToStr(std::string_view s)
+  {
+    return { s.data(), s.size() };
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  dwm_pkg_info ToInfo(const Dwm::Pkg::InfoView & iv)
+  {
+    return { sizeof(dwm_pkg_info), ToStr(iv.id), ToStr(iv.type),
+             ToStr(iv.status), ToStr(iv.name), ToStr(iv.version),
+             ToStr(iv.copyright), ToStr(iv.date), ToStr(iv.other) };
+  }
+
+  //--------------------------------------------------------------------------
+  //!  Returns the scanner to use for @c scanner (which may be NULL).
+  //--------------------------------------------------------------------------
+  const Dwm::Pkg::Scanner & GetScanner(const dwm_pkg_scanner *scanner)
+  {
+    static const Dwm::Pkg::Scanner  defaultScanner;
+    return scanner ? scanner->scanner : defaultScanner;
+  }
+  
+  //--------------------------------------------------------------------------
+  //!  Hands hits from a Dwm::Pkg::Scanner to a dwm_pkg_hit_fn.  The
+  //!  ScanCallback captures only a pointer to this, so it fits in
+  //!  std::function's local storage and scans don't allocate.
+  //--------------------------------------------------------------------------
+  struct HitAdapter
+  {
+    dwm_pkg_hit_fn  fn;
+    void           *arg;
+    long            numHits;
+
+    HitAdapter(dwm_pkg_hit_fn f, void *a)
+        : fn(f), arg(a), numHits(0)
+    {}
+    
+    Dwm::Pkg::ScanCallback Callback()
+    {
+      return [this] (const Dwm::Pkg::ScanHit & hit) {
+        dwm_pkg_info  info;
+        dwm_pkg_hit   h = { sizeof(dwm_pkg_hit), ToStr(hit.raw), hit.offset,
+                            nullptr, hit.truncated, (int)hit.encoding };
+        if (hit.info) {
+          info = ToInfo(*hit.info);
+          h.info = &info;
+        }
+        ++numHits;
+        return (fn(&h, arg) != 0);
+      };
+    }
+  };
+
+}  // anonymous namespace
+
+extern "C" {
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  unsigned int dwm_pkg_api_version(void)
+  {
+    return DWM_PKG_C_API_VERSION;
+  }
+  
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  dwm_pkg_scanner *dwm_pkg_scanner_new(const dwm_pkg_filter *filter)
+  {
+    //  Callers built against an older header pass a smaller filter; the
+    //  fields they don't know about stay zero.
+    dwm_pkg_filter  f;
+    memset(&f, 0, sizeof(f));
+    if (filter) {
+      memcpy(&f, filter, std::min(filter->size, sizeof(f)));
+    }
+    try {
+      Dwm::Pkg::ScanFilter  sf;
+      if (f.name) {
+        sf.name = f.name;
+      }
+      if (f.status) {
+        sf.SetStatus(f.status);
+      }
+      if (f.type) {
+        sf.SetType(f.type);
+      }
+      if (f.version_range && (! sf.SetVersionRange(f.version_range))) {
+        errno = EINVAL;
+        return nullptr;
+      }
+      sf.limit = f.limit;
+      if (f.max_length == SIZE_MAX) {
+        sf.maxLength = 0;
+      }
+      else if (f.max_length) {
+        sf.maxLength = f.max_length;
+      }
+      sf.allBytes = (f.all_bytes != 0);
+      return new dwm_pkg_scanner(sf);
+    }
+    catch (...) {
+      errno = ENOMEM;
+      return nullptr;
+    }
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  void dwm_pkg_scanner_free(dwm_pkg_scanner *scanner)
+  {
+    delete scanner;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  long dwm_pkg_scan_file(const dwm_pkg_scanner *scanner, const char *path,
+                         dwm_pkg_hit_fn fn, void *arg)
+  {
+    try {
+      HitAdapter  adapter(fn, arg);
+      if (! GetScanner(scanner).ScanFile(path, adapter.Callback())) {
+        return -1;
+      }
+      return adapter.numHits;
+    }
+    catch (...) {
+      errno = ENOMEM;
+      return -1;
+    }
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  long dwm_pkg_scan_fd(const dwm_pkg_scanner *scanner, int fd,
+                       dwm_pkg_hit_fn fn, void *arg)
+  {
+    try {
+      HitAdapter  adapter(fn, arg);
+      if (! GetScanner(scanner).ScanFd(fd, adapter.Callback())) {
+        return -1;
+      }
+      return adapter.numHits;
+    }
+    catch (...) {
+      errno = ENOMEM;
+      return -1;
+    }
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  long dwm_pkg_scan_buffer(const dwm_pkg_scanner *scanner, const void *data,
+                           size_t len, dwm_pkg_hit_fn fn, void *arg)
+  {
+    try {
+      HitAdapter  adapter(fn, arg);
+      GetScanner(scanner).ScanImage((const char *)data, len,
+                                    adapter.Callback());
+      return adapter.numHits;
+    }
+    catch (...) {
+      errno = ENOMEM;
+      return -1;
+    }
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  long dwm_pkg_loaded(dwm_pkg_info_fn fn, void *arg)
+  {
+    long  numInfos = 0;
+    try {
+      Dwm::Pkg::ScanLoadedImages(Dwm::Pkg::Scanner(),
+                                 [&] (std::string_view image,
+                                      const Dwm::Pkg::ScanHit & hit) {
+        if (hit.info) {
+          dwm_pkg_info  info = ToInfo(*hit.info);
+          ++numInfos;
+          return (fn(&info, ToStr(image), arg) != 0);
+        }
+        return true;
+      });
+    }
+    catch (...) {
+      errno = ENOMEM;
+      return -1;
+    }
+    return numInfos;
+  }
+
+  //--------------------------------------------------------------------------
+  //!  
+  //--------------------------------------------------------------------------
+  int dwm_pkg_parse(const char *s, size_t len, dwm_pkg_info *info)
+  {
+    //  info->size may differ from ours if the caller was built against
+    //  another version of the header.  We fill in the fields both
+    //  versions have; every version has at least size and raw.
+    if ((! info)
+        || (info->size < offsetof(dwm_pkg_info, raw) + sizeof(dwm_pkg_str))) {
+      return 0;
+    }
+    Dwm::Pkg::InfoView  iv;
+    if (! iv.Parse(std::string_view(s, len))) {
+      return 0;
+    }
+    dwm_pkg_info  full = ToInfo(iv);
+    full.size = info->size;
+    memcpy(info, &full, std::min(info->size, sizeof(full)));
+    return 1;
+  }
+  
+}  // extern "C"
@@ -0,0 +1,261 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  \file DwmPkgCoreScanner.cc
+//!  \author Daniel W. McRobb
+//!  \brief Dwm::Pkg::CoreScanner class implementation
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+}
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "DwmPkgCoreScanner.hh"
+#include "DwmPkgPolite.hh"
+#include "DwmPkgProbes.hh"
+
+namespace Dwm {
+
+  namespace Pkg {
+
+    namespace {
+
+      //----------------------------------------------------------------------
+      //!  A window of a segment, scanned by one thread.
+      //----------------------------------------------------------------------
+      struct CoreWindow
+      {
+        const CoreSegment  *segment;
+        uint64_t            offset;   // in the core
+        uint64_t            length;
+      };
+      
+    }  // anonymous namespace
+    
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    CoreScanner::CoreScanner(const Scanner & scanner, unsigned int numThreads,
+                             std::size_t windowSize)
+        : _scanner(scanner), _numThreads(std::max(numThreads, 1U)),
+          _windowSize(windowSize), _path(), _fd(-1), _map(nullptr), _len(0),
+          _segments(), _mappings()
+    {
+      std::size_t  pageSize = sysconf(_SC_PAGESIZE);
+      _windowSize = std::max(_windowSize, pageSize);
+      _windowSize = (_windowSize + pageSize - 1) & ~(pageSize - 1);
+    }
+
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    CoreScanner::~CoreScanner()
+    {
+      Close();
+    }
+
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    void CoreScanner::Close()
+    {
+      if (_map) {
+        munmap((void *)_map, _len);
+        _map = nullptr;
+      }
+      if (_fd >= 0) {
+        close(_fd);
+        _fd = -1;
+      }
+      _len = 0;
+      _segments.clear();
+      _mappings.clear();
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    bool CoreScanner::Open(const std::string & path)
+    {
+      Close();
+      _path = path;
+      _fd = open(path.c_str(), O_RDONLY|O_CLOEXEC);
+      DWM_PKG_PROBE2(file_open, _path.c_str(), _fd);
+      if (_fd < 0) {
+        return false;
+      }
+      struct stat  st;
+      if ((fstat(_fd, &st) != 0) || (! S_ISREG(st.st_mode))
+          || (st.st_size == 0)) {
+        Close();
+        return false;
+      }
+      //  Mapping faults nothing in; FindCoreLayout() only touches the
+      //  headers and notes.
+      void  *p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, _fd, 0);
+      if (p == MAP_FAILED) {
+        Close();
+        return false;
+      }
+      _map = (const char *)p;
+      _len = st.st_size;
+      if (! FindCoreLayout(_map, _len, _segments, _mappings)) {
+        Close();
+        return false;
+      }
+      return true;
+    }
+
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    const CoreMapping *CoreScanner::FindMapping(uint64_t vaddr) const
+    {
+      auto  it = std::upper_bound(_mappings.begin(), _mappings.end(), vaddr,
+                                  [] (uint64_t a, const CoreMapping & m)
+                                  { return (a < m.start); });
+      if (it == _mappings.begin()) {
+        return nullptr;
+      }
+      --it;
+      return ((vaddr < it->end) ? &(*it) : nullptr);
+    }
+    
+    //------------------------------------------------------------------------
+    //!  Readable segments are cut into windows.  A thread scans a window
+    //!  plus enough of the next one to finish a hit that starts near its
+    //!  end, and reports only the hits that start in its window.
+    //------------------------------------------------------------------------
+    bool CoreScanner::Scan(const CoreCallback & cb)
+    {
+      if (! _map) {
+        return false;
+      }
+      std::vector<CoreWindow>  windows;
+      for (const auto & seg : _segments) {
+        if ((! (seg.flags & 0x4)) || (seg.offset >= _len)) {   // PF_R
+          continue;
+        }
+        uint64_t  segEnd = std::min<uint64_t>(seg.offset + seg.fileSize,
+                                              _len);
+        for (uint64_t off = seg.offset; off < segEnd; off += _windowSize) {
+          windows.push_back({&seg, off,
+                             std::min<uint64_t>(_windowSize, segEnd - off)});
+        }
+      }
+
+      const ScanFilter  & filter = _scanner.Filter();
+      uint64_t  overlap = filter.maxLength ? (filter.maxLength + 1)
+                                           : (1024 * 1024);
+      std::size_t     pageSize = sysconf(_SC_PAGESIZE);
+      Polite         *polite = _scanner.GetPolite();
+      PageCacheGuard  guard(polite, _fd, _map, _len);
+      std::atomic<std::size_t>  next = 0;
+      std::atomic<bool>         stop = false;
+      //  ScanMemory() applies filter.limit per window.  It's per scan,
+      //  so we also count hits across windows.
+      std::atomic<std::size_t>  numHits = 0;
+      
+      auto  worker = [&] () {
+        Probes::PathScope  probePath(_path.c_str());
+        std::size_t  w;
+        while ((! stop) && ((w = next++) < windows.size())) {
+          const CoreWindow   & win = windows[w];
+          const CoreSegment  & seg = *win.segment;
+          uint64_t  segEnd = std::min<uint64_t>(seg.offset + seg.fileSize,
+                                                _len);
+          uint64_t  scanLen = std::min(win.length + overlap,
+                                       segEnd - win.offset);
+          if (polite) {
+            polite->Take(win.length);
+          }
+          _scanner.ScanMemory(_map + win.offset, scanLen,
+                              [&] (const ScanHit & hit) {
+                                if (hit.offset >= win.length) {
+                                  return false;   // next window's
+                                }
+                                if (stop) {
+                                  return false;
+                                }
+                                std::size_t  n = ++numHits;
+                                if (filter.limit && (n > filter.limit)) {
+                                  stop = true;
+                                  return false;
+                                }
+                                CoreHit  coreHit;
+                                coreHit.hit = hit;
+                                coreHit.hit.offset += win.offset;
+                                coreHit.vaddr = seg.vaddr
+                                  + (coreHit.hit.offset - seg.offset);
+                                coreHit.mapping = FindMapping(coreHit.vaddr);
+                                if ((! cb(coreHit))
+                                    || (n == filter.limit)) {
+                                  stop = true;
+                                }
+                                return (! stop);
+                              });
+          //  Release the window's pages from our address space.
+          uint64_t  start = win.offset & ~((uint64_t)pageSize - 1);
+          madvise((void *)(_map + start), scanLen + (win.offset - start),
+                  MADV_DONTNEED);
+        }
+      };
+
+      std::vector<std::thread>  threads;
+      unsigned int  numThreads =
+        std::min<std::size_t>(_numThreads,
+                              std::max<std::size_t>(windows.size(), 1));
+      for (unsigned int i = 1; i < numThreads; ++i) {
+        threads.emplace_back(worker);
+      }
+      worker();
+      for (auto & t : threads) {
+        t.join();
+      }
+      return true;
+    }
+    
+  }  // namespace Pkg
+
+}  // namespace Dwm
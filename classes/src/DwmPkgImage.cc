@@ -0,0 +1,843 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+
+//---------------------------------------------------------------------------
+//!  \file DwmPkgImage.cc
+//!  \author Daniel W. McRobb
+//!  \brief Object file image parsing for section-aware scanning
+//---------------------------------------------------------------------------
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#include "DwmPkgImage.hh"
+
+namespace Dwm {
+
+  namespace Pkg {
+
+    namespace {
+
+      //----------------------------------------------------------------------
+      //!  ByteSwap() is C++23.
+      //----------------------------------------------------------------------
+      template <typename T>
+      constexpr T ByteSwap(T value)
+      {
+        if constexpr (sizeof(T) == 1) {
+          return value;
+        }
+        else if constexpr (sizeof(T) == 2) {
+          return __builtin_bswap16(value);
+        }
+        else if constexpr (sizeof(T) == 4) {
+          return __builtin_bswap32(value);
+        }
+        else {
+          static_assert(sizeof(T) == 8);
+          return __builtin_bswap64(value);
+        }
+      }
+      
+      //----------------------------------------------------------------------
+      //!  Bounds-checked fixed-endian reads from an image.  Every Get
+      //!  returns false instead of reading past the end.
+      //----------------------------------------------------------------------
+      class ImageBytes
+      {
+      public:
+        ImageBytes(const char *data, std::size_t len, bool bigEndian)
+            : _data(data), _len(len),
+              _swap(bigEndian != (std::endian::native == std::endian::big))
+        {}
+
+        bool Has(uint64_t off, uint64_t n) const
+        { return ((off <= _len) && (n <= (_len - off))); }
+
+        template <typename T>
+        bool Get(uint64_t off, T & value) const
+        {
+          if (! Has(off, sizeof(T))) {
+            return false;
+          }
+          memcpy(&value, _data + off, sizeof(T));
+          if (_swap) {
+            value = ByteSwap(value);
+          }
+          return true;
+        }
+
+        //--------------------------------------------------------------------
+        //!  A name of at most @c maxLen bytes at @c off, stopping at a NUL.
+        //--------------------------------------------------------------------
+        std::string_view Name(uint64_t off, std::size_t maxLen) const
+        {
+          if (off >= _len) {
+            return std::string_view();
+          }
+          maxLen = std::min<std::size_t>(maxLen, _len - off);
+          return std::string_view(_data + off, strnlen(_data + off, maxLen));
+        }
+        
+        std::size_t Length() const
+        { return _len; }
+        
+      private:
+        const char   *_data;
+        std::size_t   _len;
+        bool          _swap;
+      };
+
+      //----------------------------------------------------------------------
+      //!  Adds a range, clamped to the end of the image.
+      //----------------------------------------------------------------------
+      void AddRange(std::vector<ImageRange> & ranges, const ImageBytes & b,
+                    uint64_t base, uint64_t off, uint64_t len,
+                    std::string_view section, uint32_t slice)
+      {
+        if ((off == 0) || (len == 0) || (off >= b.Length())) {
+          return;
+        }
+        len = std::min<uint64_t>(len, b.Length() - off);
+        ranges.push_back({base + off, len, section, slice});
+        return;
+      }
+      
+      //----------------------------------------------------------------------
+      //!  The ELF section header fields we use.
+      //----------------------------------------------------------------------
+      struct ElfShdr
+      {
+        std::string_view  name;
+        uint32_t          type;
+        uint32_t          link;
+        uint64_t          flags;
+        uint64_t          addr;
+        uint64_t          offset;
+        uint64_t          size;
+        uint64_t          entsize;
+      };
+
+      //----------------------------------------------------------------------
+      //!  Reads the section headers of the ELF image at @c data, including
+      //!  the null section 0.  Returns false if it's not ELF, is malformed
+      //!  or has no section headers.
+      //----------------------------------------------------------------------
+      bool ElfSectionHeaders(const char *data, std::size_t len,
+                             std::vector<ElfShdr> & shdrs)
+      {
+        shdrs.clear();
+        if ((len < 52) || (data[4] != 1 && data[4] != 2)
+            || (data[5] != 1 && data[5] != 2)) {
+          return false;
+        }
+        bool        is64 = (data[4] == 2);
+        ImageBytes  b(data, len, (data[5] == 2));
+        uint64_t    shoff;
+        uint16_t    shentsize, shnum16, shstrndx16;
+        if (is64) {
+          if (! (b.Get(0x28, shoff) && b.Get(0x3a, shentsize)
+                 && b.Get(0x3c, shnum16) && b.Get(0x3e, shstrndx16))) {
+            return false;
+          }
+        }
+        else {
+          uint32_t  shoff32;
+          if (! (b.Get(0x20, shoff32) && b.Get(0x2e, shentsize)
+                 && b.Get(0x30, shnum16) && b.Get(0x32, shstrndx16))) {
+            return false;
+          }
+          shoff = shoff32;
+        }
+        if ((shoff == 0) || (shentsize < (is64 ? 64 : 40))) {
+          return false;   // no section headers
+        }
+
+        //  Section header fields we need, by class.
+        const uint64_t  nameOff = 0, typeOff = 4, flagsOff = 8;
+        const uint64_t  addrOff = is64 ? 16 : 12;
+        const uint64_t  offsetOff = is64 ? 24 : 16;
+        const uint64_t  sizeOff = is64 ? 32 : 20;
+        const uint64_t  linkOff = is64 ? 40 : 24;
+        const uint64_t  entsizeOff = is64 ? 56 : 36;
+        auto  getWord = [&] (uint64_t off, uint64_t & value) {
+          if (is64) {
+            return b.Get(off, value);
+          }
+          uint32_t  v;
+          if (! b.Get(off, v)) {
+            return false;
+          }
+          value = v;
+          return true;
+        };
+
+        //  Extended numbering: the real counts are in section 0.
+        uint64_t  shnum = shnum16;
+        uint32_t  shstrndx = shstrndx16;
+        if (shnum == 0) {
+          if (! getWord(shoff + sizeOff, shnum)) {
+            return false;
+          }
+        }
+        if (shstrndx == 0xffff) {
+          if (! b.Get(shoff + linkOff, shstrndx)) {
+            return false;
+          }
+        }
+        if ((shnum == 0) || (! b.Has(shoff, shnum * shentsize))
+            || (shstrndx >= shnum)) {
+          return false;
+        }
+        uint64_t  strtabOff, strtabSize;
+        if (! (getWord(shoff + shstrndx * shentsize + offsetOff, strtabOff)
+               && getWord(shoff + shstrndx * shentsize + sizeOff,
+                          strtabSize))) {
+          return false;
+        }
+
+        shdrs.resize(shnum);
+        for (uint64_t i = 0; i < shnum; ++i) {
+          uint64_t  sh = shoff + i * shentsize;
+          ElfShdr & shdr = shdrs[i];
+          uint32_t  name;
+          if (! (b.Get(sh + nameOff, name) && b.Get(sh + typeOff, shdr.type)
+                 && b.Get(sh + linkOff, shdr.link)
+                 && getWord(sh + flagsOff, shdr.flags)
+                 && getWord(sh + addrOff, shdr.addr)
+                 && getWord(sh + offsetOff, shdr.offset)
+                 && getWord(sh + sizeOff, shdr.size)
+                 && getWord(sh + entsizeOff, shdr.entsize))) {
+            shdrs.clear();
+            return false;
+          }
+          if (name < strtabSize) {
+            shdr.name = b.Name(strtabOff + name, strtabSize - name);
+          }
+        }
+        return true;
+      }
+      
+      //----------------------------------------------------------------------
+      //!  
+      //----------------------------------------------------------------------
+      bool ElfRanges(const char *data, std::size_t len,
+                     std::vector<ImageRange> & ranges)
+      {
+        std::vector<ElfShdr>  shdrs;
+        if (! ElfSectionHeaders(data, len, shdrs)) {
+          return false;
+        }
+        ImageBytes  b(data, len, (data[5] == 2));
+        for (std::size_t i = 1; i < shdrs.size(); ++i) {
+          const ElfShdr & shdr = shdrs[i];
+          if (shdr.type != 1) {       // SHT_PROGBITS
+            continue;
+          }
+          bool  alloc = (shdr.flags & 0x2), exec = (shdr.flags & 0x4);
+          if ((alloc && (! exec)) || (shdr.name == ".comment")) {
+            AddRange(ranges, b, 0, shdr.offset, shdr.size, shdr.name, 0);
+          }
+        }
+        return true;
+      }
+
+      //----------------------------------------------------------------------
+      //!  Returns true if we want Mach-O section @c sect of segment
+      //!  @c seg.
+      //----------------------------------------------------------------------
+      bool WantMachOSection(std::string_view seg, std::string_view sect)
+      {
+        if (seg == "__TEXT") {
+          return ((sect == "__cstring") || (sect == "__const"));
+        }
+        if (seg == "__DATA") {
+          return ((sect == "__data") || (sect == "__const"));
+        }
+        return (seg == "__DATA_CONST");
+      }
+      
+      //----------------------------------------------------------------------
+      //!  Parses the thin Mach-O image at @c data, adding ranges offset by
+      //!  @c base.
+      //----------------------------------------------------------------------
+      bool MachORanges(const char *data, std::size_t len, uint64_t base,
+                       uint32_t slice, std::vector<ImageRange> & ranges)
+      {
+        uint32_t  magic;
+        if (len < 28) {
+          return false;
+        }
+        memcpy(&magic, data, sizeof(magic));
+        bool  bigEndian;
+        if ((magic == 0xfeedface) || (magic == 0xfeedfacf)) {
+          bigEndian = (std::endian::native == std::endian::big);
+        }
+        else if ((magic == 0xcefaedfe) || (magic == 0xcffaedfe)) {
+          bigEndian = (std::endian::native != std::endian::big);
+          magic = ByteSwap(magic);
+        }
+        else {
+          return false;
+        }
+        bool        is64 = (magic == 0xfeedfacf);
+        ImageBytes  b(data, len, bigEndian);
+        uint32_t    ncmds, sizeofcmds;
+        if (! (b.Get(16, ncmds) && b.Get(20, sizeofcmds))) {
+          return false;
+        }
+        uint64_t  cmdOff = is64 ? 32 : 28;
+        uint64_t  cmdsEnd = cmdOff + sizeofcmds;
+        if (! b.Has(cmdOff, sizeofcmds)) {
+          return false;
+        }
+        for (uint32_t c = 0; c < ncmds; ++c) {
+          uint32_t  cmd, cmdsize;
+          if ((! (b.Get(cmdOff, cmd) && b.Get(cmdOff + 4, cmdsize)))
+              || (cmdsize < 8) || ((cmdOff + cmdsize) > cmdsEnd)) {
+            return false;
+          }
+          if ((cmd == 0x1) || (cmd == 0x19)) {   // LC_SEGMENT(_64)
+            bool      seg64 = (cmd == 0x19);
+            uint32_t  nsects;
+            if (! b.Get(cmdOff + (seg64 ? 64 : 48), nsects)) {
+              return false;
+            }
+            uint64_t  sectOff = cmdOff + (seg64 ? 72 : 56);
+            uint64_t  sectSize = seg64 ? 80 : 68;
+            if ((sectOff + (nsects * sectSize)) > (cmdOff + cmdsize)) {
+              return false;
+            }
+            for (uint32_t s = 0; s < nsects; ++s, sectOff += sectSize) {
+              std::string_view  sectName = b.Name(sectOff, 16);
+              std::string_view  segName = b.Name(sectOff + 16, 16);
+              uint64_t  size;
+              uint32_t  offset, flags;
+              if (seg64) {
+                if (! (b.Get(sectOff + 40, size)
+                       && b.Get(sectOff + 48, offset)
+                       && b.Get(sectOff + 64, flags))) {
+                  return false;
+                }
+              }
+              else {
+                uint32_t  size32;
+                if (! (b.Get(sectOff + 36, size32)
+                       && b.Get(sectOff + 40, offset)
+                       && b.Get(sectOff + 56, flags))) {
+                  return false;
+                }
+                size = size32;
+              }
+              uint8_t  type = flags & 0xff;
+              if ((type == 0x1) || (type == 0xc) || (type == 0x12)) {
+                continue;   // zero fill, nothing in the file
+              }
+              if (WantMachOSection(segName, sectName)) {
+                AddRange(ranges, b, base, offset, size, sectName, slice);
+              }
+            }
+          }
+          cmdOff += cmdsize;
+        }
+        return true;
+      }
+
+      //----------------------------------------------------------------------
+      //!  Fat (universal) Mach-O: a big-endian table of architecture
+      //!  slices, each a thin Mach-O image.  Java class files share the
+      //!  0xcafebabe magic; their version numbers look like a large
+      //!  architecture count, which we reject.
+      //----------------------------------------------------------------------
+      bool FatRanges(const char *data, std::size_t len,
+                     std::vector<ImageRange> & ranges)
+      {
+        ImageBytes  b(data, len, true);
+        uint32_t    magic, nfat;
+        if (! (b.Get(0, magic) && b.Get(4, nfat))) {
+          return false;
+        }
+        if (((magic != 0xcafebabe) && (magic != 0xcafebabf))
+            || (nfat == 0) || (nfat > 32)) {
+          return false;
+        }
+        bool      is64 = (magic == 0xcafebabf);
+        uint64_t  archOff = 8;
+        for (uint32_t a = 0; a < nfat; ++a, archOff += (is64 ? 32 : 20)) {
+          uint64_t  offset, size;
+          if (is64) {
+            if (! (b.Get(archOff + 8, offset) && b.Get(archOff + 16, size))) {
+              return false;
+            }
+          }
+          else {
+            uint32_t  offset32, size32;
+            if (! (b.Get(archOff + 8, offset32)
+                   && b.Get(archOff + 12, size32))) {
+              return false;
+            }
+            offset = offset32;
+            size = size32;
+          }
+          if ((offset < 8) || (! b.Has(offset, size))
+              || (! MachORanges(data + offset, size, offset, a, ranges))) {
+            return false;
+          }
+        }
+        return true;
+      }
+
+      //----------------------------------------------------------------------
+      //!  
+      //----------------------------------------------------------------------
+      bool PeRanges(const char *data, std::size_t len,
+                    std::vector<ImageRange> & ranges)
+      {
+        ImageBytes  b(data, len, false);
+        uint32_t    peOff, peMagic;
+        uint16_t    numSections, optHdrSize;
+        if (! (b.Get(0x3c, peOff) && b.Get(peOff, peMagic)
+               && b.Get(peOff + 6, numSections)
+               && b.Get(peOff + 20, optHdrSize))) {
+          return false;
+        }
+        if (peMagic != 0x00004550) {   // "PE\0\0"
+          return false;
+        }
+        uint64_t  sectOff = (uint64_t)peOff + 24 + optHdrSize;
+        if (! b.Has(sectOff, numSections * 40ULL)) {
+          return false;
+        }
+        for (uint16_t s = 0; s < numSections; ++s, sectOff += 40) {
+          std::string_view  name = b.Name(sectOff, 8);
+          uint32_t  rawSize = 0, rawOff = 0;
+          b.Get(sectOff + 16, rawSize);   // in bounds, checked above
+          b.Get(sectOff + 20, rawOff);
+          //  .rsrc holds version resources, which are UTF-16.
+          if ((name == ".rdata") || (name == ".data") || (name == ".rsrc")) {
+            AddRange(ranges, b, 0, rawOff, rawSize, name, 0);
+          }
+        }
+        return true;
+      }
+      
+    }  // anonymous namespace
+    
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    ImageFormat FindDataRanges(const char *data, std::size_t len,
+                               std::vector<ImageRange> & ranges)
+    {
+      ImageFormat  format = ImageFormat::k_unknown;
+      ranges.clear();
+      if (len >= 4) {
+        if (memcmp(data, "\x7f" "ELF", 4) == 0) {
+          if (ElfRanges(data, len, ranges)) {
+            format = ImageFormat::k_elf;
+          }
+        }
+        else if ((memcmp(data, "\xca\xfe\xba\xbe", 4) == 0)
+                 || (memcmp(data, "\xca\xfe\xba\xbf", 4) == 0)) {
+          if (FatRanges(data, len, ranges)) {
+            format = ImageFormat::k_machOFat;
+          }
+        }
+        else if ((data[0] == 'M') && (data[1] == 'Z')) {
+          if (PeRanges(data, len, ranges)) {
+            format = ImageFormat::k_pe;
+          }
+        }
+        else if (MachORanges(data, len, 0, 0, ranges)) {
+          format = ImageFormat::k_machO;
+        }
+      }
+      if (format == ImageFormat::k_unknown) {
+        ranges.clear();
+      }
+      else {
+        std::sort(ranges.begin(), ranges.end(),
+                  [] (const ImageRange & a, const ImageRange & b)
+                  { return (a.offset < b.offset); });
+      }
+      return format;
+    }
+    
+    namespace {
+
+      //----------------------------------------------------------------------
+      //!  The ELF program header fields we use.
+      //----------------------------------------------------------------------
+      struct ElfPhdr
+      {
+        uint32_t  type;
+        uint32_t  flags;
+        uint64_t  offset;
+        uint64_t  vaddr;
+        uint64_t  filesz;
+        uint64_t  memsz;
+        uint64_t  align;
+      };
+
+      //----------------------------------------------------------------------
+      //!  Reads the ELF header and program headers of the image at
+      //!  @c data.  Returns false if it's not ELF, is malformed or has no
+      //!  program headers in the first @c len bytes.
+      //----------------------------------------------------------------------
+      bool ElfProgramHeaders(const char *data, std::size_t len,
+                             uint16_t & elfType, std::vector<ElfPhdr> & phdrs)
+      {
+        phdrs.clear();
+        if ((len < 52) || (memcmp(data, "\x7f" "ELF", 4) != 0)
+            || (data[4] != 1 && data[4] != 2)
+            || (data[5] != 1 && data[5] != 2)) {
+          return false;
+        }
+        bool        is64 = (data[4] == 2);
+        ImageBytes  b(data, len, (data[5] == 2));
+        uint64_t    phoff;
+        uint16_t    phentsize, phnum;
+        if (! b.Get(16, elfType)) {
+          return false;
+        }
+        if (is64) {
+          if (! (b.Get(0x20, phoff) && b.Get(0x36, phentsize)
+                 && b.Get(0x38, phnum))) {
+            return false;
+          }
+        }
+        else {
+          uint32_t  phoff32;
+          if (! (b.Get(0x1c, phoff32) && b.Get(0x2a, phentsize)
+                 && b.Get(0x2c, phnum))) {
+            return false;
+          }
+          phoff = phoff32;
+        }
+        if ((phoff == 0) || (phentsize < (is64 ? 56 : 32))
+            || (phnum == 0xffff) || (! b.Has(phoff, phnum * phentsize))) {
+          return false;
+        }
+        phdrs.resize(phnum);
+        for (uint64_t i = 0; i < phnum; ++i) {
+          uint64_t  ph = phoff + i * phentsize;
+          ElfPhdr & phdr = phdrs[i];
+          b.Get(ph, phdr.type);
+          if (is64) {
+            b.Get(ph + 4, phdr.flags);
+            b.Get(ph + 8, phdr.offset);
+            b.Get(ph + 16, phdr.vaddr);
+            b.Get(ph + 32, phdr.filesz);
+            b.Get(ph + 40, phdr.memsz);
+            b.Get(ph + 48, phdr.align);
+          }
+          else {
+            //  b.Has() above covers the whole table, so these can't fail.
+            uint32_t  offset = 0, vaddr = 0, filesz = 0, memsz = 0, align = 0;
+            b.Get(ph + 4, offset);
+            b.Get(ph + 8, vaddr);
+            b.Get(ph + 16, filesz);
+            b.Get(ph + 20, memsz);
+            b.Get(ph + 24, phdr.flags);
+            b.Get(ph + 28, align);
+            phdr.offset = offset;
+            phdr.vaddr = vaddr;
+            phdr.filesz = filesz;
+            phdr.memsz = memsz;
+            phdr.align = align;
+          }
+        }
+        return true;
+      }
+
+      //----------------------------------------------------------------------
+      //!  Calls @c fn(name, type, descOff, descSize) for each note in the
+      //!  PT_NOTE segment @c phdr, until @c fn returns false.  Stops at
+      //!  the end of the segment or of @c b, whichever comes first.
+      //----------------------------------------------------------------------
+      template <typename Fn>
+      void ForEachNote(const char *data, const ImageBytes & b,
+                       const ElfPhdr & phdr, Fn && fn)
+      {
+        if (! b.Has(phdr.offset, phdr.filesz)) {
+          return;
+        }
+        //  Each note: namesz, descsz, type, then the name and the
+        //  descriptor, each padded to the segment's alignment.
+        uint64_t  pad = (phdr.align == 8) ? 7 : 3;
+        uint64_t  off = phdr.offset, end = phdr.offset + phdr.filesz;
+        while ((end - off) >= 12) {
+          uint32_t  namesz, descsz, type;
+          if (! (b.Get(off, namesz) && b.Get(off + 4, descsz)
+                 && b.Get(off + 8, type))) {
+            break;
+          }
+          uint64_t  nameOff = off + 12;
+          uint64_t  descOff = (nameOff + namesz + pad) & ~pad;
+          if ((descOff + descsz) > end) {
+            break;
+          }
+          std::string_view  name(data + nameOff, namesz);
+          if ((! name.empty()) && (name.back() == '\0')) {
+            name.remove_suffix(1);
+          }
+          if (! fn(name, type, descOff, descsz)) {
+            break;
+          }
+          off = (descOff + descsz + pad) & ~pad;
+        }
+        return;
+      }
+      
+    }  // anonymous namespace
+    
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    std::string_view FindBuildId(const char *data, std::size_t len)
+    {
+      uint16_t              elfType;
+      std::vector<ElfPhdr>  phdrs;
+      std::string_view      rc;
+      if (! ElfProgramHeaders(data, len, elfType, phdrs)) {
+        return rc;
+      }
+      ImageBytes  b(data, len, (data[5] == 2));
+      for (const auto & phdr : phdrs) {
+        if (phdr.type != 4) {   // PT_NOTE
+          continue;
+        }
+        ForEachNote(data, b, phdr,
+                    [&] (std::string_view name, uint32_t type,
+                         uint64_t descOff, uint32_t descSize) {
+                      if ((type == 3) && (name == "GNU") && descSize) {
+                        rc = std::string_view(data + descOff, descSize);
+                        return false;
+                      }
+                      return true;
+                    });
+        if (! rc.empty()) {
+          break;
+        }
+      }
+      return rc;
+    }
+
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    bool FindCoreLayout(const char *data, std::size_t len,
+                        std::vector<CoreSegment> & segments,
+                        std::vector<CoreMapping> & mappings)
+    {
+      segments.clear();
+      mappings.clear();
+      uint16_t              elfType;
+      std::vector<ElfPhdr>  phdrs;
+      if ((! ElfProgramHeaders(data, len, elfType, phdrs))
+          || (elfType != 4)) {    // ET_CORE
+        return false;
+      }
+      bool        is64 = (data[4] == 2);
+      ImageBytes  b(data, len, (data[5] == 2));
+      auto  getWord = [&] (uint64_t off, uint64_t & value) {
+        if (is64) {
+          return b.Get(off, value);
+        }
+        uint32_t  v;
+        if (! b.Get(off, v)) {
+          return false;
+        }
+        value = v;
+        return true;
+      };
+      const uint64_t  wordSize = is64 ? 8 : 4;
+      
+      for (const auto & phdr : phdrs) {
+        if (phdr.type == 1) {   // PT_LOAD
+          segments.push_back({phdr.vaddr, phdr.offset, phdr.filesz,
+                              phdr.memsz, phdr.flags});
+        }
+        else if (phdr.type == 4) {   // PT_NOTE
+          ForEachNote(data, b, phdr,
+                      [&] (std::string_view name, uint32_t type,
+                           uint64_t descOff, uint32_t descSize) {
+                        if ((type != 0x46494c45) || (name != "CORE")) {
+                          return true;   // not NT_FILE
+                        }
+                        //  count, page size, count * (start, end, page
+                        //  offset), then count NUL-terminated paths.
+                        uint64_t  count, pageSize;
+                        uint64_t  descEnd = descOff + descSize;
+                        if ((! getWord(descOff, count))
+                            || (! getWord(descOff + wordSize, pageSize))
+                            || (count > (descSize / (3 * wordSize)))) {
+                          return false;
+                        }
+                        uint64_t  off = descOff + 2 * wordSize;
+                        uint64_t  pathOff = off + count * 3 * wordSize;
+                        for (uint64_t i = 0; i < count; ++i) {
+                          CoreMapping  m;
+                          uint64_t     pageOff;
+                          if ((! getWord(off, m.start))
+                              || (! getWord(off + wordSize, m.end))
+                              || (! getWord(off + 2 * wordSize, pageOff))) {
+                            break;
+                          }
+                          off += 3 * wordSize;
+                          m.fileOffset = pageOff * pageSize;
+                          if (pathOff >= descEnd) {
+                            break;
+                          }
+                          m.path = b.Name(pathOff, descEnd - pathOff);
+                          pathOff += m.path.size() + 1;
+                          mappings.push_back(m);
+                        }
+                        return false;
+                      });
+        }
+      }
+      std::sort(segments.begin(), segments.end(),
+                [] (const CoreSegment & a, const CoreSegment & b)
+                { return (a.offset < b.offset); });
+      std::sort(mappings.begin(), mappings.end(),
+                [] (const CoreMapping & a, const CoreMapping & b)
+                { return (a.start < b.start); });
+      return true;
+    }
+
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    bool FindLoadSegments(const char *data, std::size_t len,
+                          std::vector<CoreSegment> & segments)
+    {
+      segments.clear();
+      uint16_t              elfType;
+      std::vector<ElfPhdr>  phdrs;
+      if (! ElfProgramHeaders(data, len, elfType, phdrs)) {
+        return false;
+      }
+      for (const auto & phdr : phdrs) {
+        if (phdr.type == 1) {       // PT_LOAD
+          segments.push_back({phdr.vaddr, phdr.offset, phdr.filesz,
+                              phdr.memsz, phdr.flags});
+        }
+      }
+      return true;
+    }
+    
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    bool FindElfSymbols(const char *data, std::size_t len,
+                        std::vector<ElfSymbol> & symbols)
+    {
+      std::vector<ElfShdr>  shdrs;
+      if ((memcmp(data, "\x7f" "ELF", std::min<std::size_t>(len, 4)) != 0)
+          || (! ElfSectionHeaders(data, len, shdrs))) {
+        return false;
+      }
+      bool        is64 = (data[4] == 2);
+      ImageBytes  b(data, len, (data[5] == 2));
+      uint16_t    elfType;
+      if (! b.Get(16, elfType)) {
+        return false;
+      }
+      bool  relocatable = (elfType == 1);    // ET_REL
+      std::size_t  symSize = is64 ? 24 : 16;
+      for (const auto & shdr : shdrs) {
+        //  SHT_SYMTAB or SHT_DYNSYM, with a string table
+        if (((shdr.type != 2) && (shdr.type != 11))
+            || (shdr.link >= shdrs.size())
+            || (! b.Has(shdr.offset, shdr.size))) {
+          continue;
+        }
+        const ElfShdr  & strtab = shdrs[shdr.link];
+        if (! b.Has(strtab.offset, strtab.size)) {
+          continue;
+        }
+        for (uint64_t off = shdr.offset + symSize;   // skip the null symbol
+             off + symSize <= shdr.offset + shdr.size; off += symSize) {
+          //  The symbol table passed b.Has(), so these reads succeed.
+          uint32_t  name = 0;
+          uint8_t   info = 0;
+          uint16_t  shndx = 0;
+          uint64_t  value = 0, size = 0;
+          b.Get(off, name);
+          if (is64) {
+            b.Get(off + 4, info);
+            b.Get(off + 6, shndx);
+            b.Get(off + 8, value);
+            b.Get(off + 16, size);
+          }
+          else {
+            uint32_t  value32 = 0, size32 = 0;
+            b.Get(off + 4, value32);
+            b.Get(off + 8, size32);
+            b.Get(off + 12, info);
+            b.Get(off + 14, shndx);
+            value = value32;
+            size = size32;
+          }
+          //  STT_OBJECT, STT_FUNC or STT_GNU_IFUNC, defined in a real
+          //  section (not SHN_UNDEF, SHN_ABS or SHN_COMMON).
+          uint8_t  type = info & 0xf;
+          if (((type != 1) && (type != 2) && (type != 10)) || (size == 0)
+              || (shndx == 0) || (shndx >= 0xff00)
+              || (name >= strtab.size)) {
+            continue;
+          }
+          if (relocatable) {
+            if (shndx >= shdrs.size()) {
+              continue;
+            }
+            value += shdrs[shndx].offset;
+          }
+          std::string_view  symName = b.Name(strtab.offset + name,
+                                             strtab.size - name);
+          if (! symName.empty()) {
+            symbols.push_back({value, size, symName, ((info >> 4) == 0)});
+          }
+        }
+      }
+      return true;
+    }
+    
+  }  // namespace Pkg
+
+}  // namespace Dwm
@@ -0,0 +1,123 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+
+//---------------------------------------------------------------------------
+//!  \file DwmPkgInfoView.cc
+//!  \author Daniel W. McRobb
+//!  \brief Dwm::Pkg::InfoView class implementation
+//---------------------------------------------------------------------------
+
+#include <algorithm>
+#include <iterator>
+
+#include "DwmPkgInfo.hh"
+#include "DwmPkgInfoView.hh"
+
+namespace Dwm {
+
+  namespace Pkg {
+
+    //------------------------------------------------------------------------
+    //!  Info's constructor makes sure SplitInfoString() recovers exactly
+    //!  the fields it was given, so that's all the parsing we need (no
+    //!  regex to compile on first use, no allocation).  We also insist
+    //!  on a type and status we know, and a name and version.
+    //------------------------------------------------------------------------
+    bool InfoView::Parse(std::string_view s)
+    {
+      static constexpr std::string_view  pkgTypes[] = {
+        DWM_PKG_TYPE_HDR, DWM_PKG_TYPE_LIB, DWM_PKG_TYPE_EXE, DWM_PKG_TYPE_DOC
+      };
+      static constexpr std::string_view  pkgStatus[] = {
+        DWM_PKG_STATUS_DEV, DWM_PKG_STATUS_RC, DWM_PKG_STATUS_REL
+      };
+      auto  known = [] (std::string_view field, const auto & values) {
+        return (std::find(std::begin(values), std::end(values), field)
+                != std::end(values));
+      };
+      
+      InfoFields  f;
+      if (SplitInfoString(s, f) && known(f.type, pkgTypes)
+          && known(f.status, pkgStatus) && (! f.name.empty())
+          && (! f.version.empty())) {
+        type = f.type;
+        status = f.status;
+        name = f.name;
+        version = f.version;
+        copyright = f.copyright;
+        date = f.date;
+        other = f.other;
+        id = s;
+        return true;
+      }
+      *this = InfoView();
+      return false;
+    }
+
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    std::string InfoView::as_json() const
+    {
+      std::string  rc("{ \"copyright\": \"");
+      rc += copyright;
+      rc += "\", \"date\": \"";
+      rc += date;
+      rc += "\", \"name\": \"";
+      rc += name;
+      rc += "\", \"other\": \"";
+      rc += other;
+      rc += "\", \"status\": \"";
+      rc += status;
+      rc += "\", \"type\": \"";
+      rc += type;
+      rc += "\", \"version\": \"";
+      rc += version;
+      rc += "\" }";
+      return rc;
+    }
+
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    std::uint64_t InfoView::hash() const noexcept
+    {
+      return InfoHash(id);
+    }
+    
+  }  // namespace Pkg
+
+}  // namespace Dwm
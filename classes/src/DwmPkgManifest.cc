@@ -0,0 +1,447 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  \file DwmPkgManifest.cc
+//!  \author Daniel W. McRobb
+//!  \brief Dwm::Pkg::Manifest, Dwm::Pkg::ManifestPublisher and related
+//!    function implementations
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <sys/stat.h>
+  #include <dirent.h>
+  #include <fcntl.h>
+  #include <stdlib.h>
+  #include <unistd.h>
+#if defined(__APPLE__)
+  #include <mach-o/dyld.h>
+  #include <mach-o/getsect.h>
+#else
+  #include <link.h>
+#endif
+}
+
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <set>
+
+#include "DwmPkgManifest.hh"
+#include "DwmPkgScanner.hh"
+
+namespace Dwm {
+
+  namespace Pkg {
+
+    namespace {
+
+      //----------------------------------------------------------------------
+      //!  The manifest we published, and the descriptor holding our lock
+      //!  on it.
+      //----------------------------------------------------------------------
+      std::mutex   g_publishMtx;
+      std::string  g_publishedPath;
+      int          g_publishedFd = -1;
+
+      //----------------------------------------------------------------------
+      //!  Open file description locks (Linux) belong to the descriptor
+      //!  rather than the process, so a process that collects manifests
+      //!  (and so opens and closes its own) doesn't drop the lock on the
+      //!  one it published.  Elsewhere we fall back to POSIX locks, and
+      //!  CollectManifests() skips our own manifest.
+      //----------------------------------------------------------------------
+#if defined(F_OFD_SETLK)
+      constexpr int  k_setLock = F_OFD_SETLK;
+      constexpr int  k_getLock = F_OFD_GETLK;
+#else
+      constexpr int  k_setLock = F_SETLK;
+      constexpr int  k_getLock = F_GETLK;
+#endif
+      
+      //----------------------------------------------------------------------
+      //!  
+      //----------------------------------------------------------------------
+      struct flock WholeFileLock(short type)
+      {
+        struct flock  fl;
+        memset(&fl, 0, sizeof(fl));
+        fl.l_type = type;
+        fl.l_whence = SEEK_SET;
+        return fl;
+      }
+      
+      //----------------------------------------------------------------------
+      //!  Returns the name of the running program.
+      //----------------------------------------------------------------------
+      std::string ProgramName()
+      {
+#if defined(__GLIBC__)
+        return program_invocation_short_name;
+#else
+        const char  *name = getprogname();
+        return name ? name : "";
+#endif
+      }
+      
+      //----------------------------------------------------------------------
+      //!  Adds the Dwm::Pkg::Info strings in the running program and its
+      //!  loaded shared libraries to @c pkgs.
+      //----------------------------------------------------------------------
+      void FindLoadedPackages(std::set<std::string> & pkgs)
+      {
+        ScanLoadedImages(Scanner(),
+                         [&] (std::string_view, const ScanHit & hit) {
+                           if (hit.info) {
+                             pkgs.emplace(hit.raw);
+                           }
+                           return true;
+                         });
+        return;
+      }
+      
+      //----------------------------------------------------------------------
+      //!  Returns the manifest for the running program.
+      //----------------------------------------------------------------------
+      std::string BuildManifest()
+      {
+        std::set<std::string>  pkgs;
+        FindLoadedPackages(pkgs);
+        
+        ManifestHeader  hdr;
+        memset(&hdr, 0, sizeof(hdr));
+        memcpy(hdr.magic, k_manifestMagic, sizeof(hdr.magic));
+        hdr.version = k_manifestVersion;
+        hdr.headerSize = sizeof(hdr);
+        hdr.pid = getpid();
+        hdr.published = time(nullptr);
+        std::string  s((const char *)&hdr, sizeof(hdr));
+        std::string  program = ProgramName();
+        s.append(program.c_str(), program.size() + 1);
+        hdr.numStrings = 1;
+        for (const auto & pkg : pkgs) {
+          if ((s.size() + pkg.size() + 1) > k_maxManifestSize) {
+            break;
+          }
+          s.append(pkg.c_str(), pkg.size() + 1);
+          ++hdr.numStrings;
+        }
+        hdr.totalSize = s.size();
+        memcpy(s.data(), &hdr, sizeof(hdr));
+        return s;
+      }
+      
+      //----------------------------------------------------------------------
+      //!  
+      //----------------------------------------------------------------------
+      bool WriteAll(int fd, const std::string & s)
+      {
+        std::size_t  written = 0;
+        while (written < s.size()) {
+          ssize_t  rc = write(fd, s.data() + written, s.size() - written);
+          if (rc < 0) {
+            if (errno == EINTR) {
+              continue;
+            }
+            return false;
+          }
+          written += rc;
+        }
+        return true;
+      }
+      
+    }  // anonymous namespace
+
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    void ScanLoadedImages(const Scanner & scanner,
+                          const LoadedImageCallback & cb)
+    {
+      std::string_view  image;
+      bool              stopped = false;
+      ScanCallback      hitcb = [&] (const ScanHit & hit) {
+        stopped = (! cb(image, hit));
+        return (! stopped);
+      };
+#if defined(__APPLE__)
+      static const char  *sects[][2] = {
+        { "__TEXT", "__cstring" }, { "__TEXT", "__const" },
+        { "__DATA_CONST", "__const" }, { "__DATA", "__data" }
+      };
+      for (uint32_t i = 0; (i < _dyld_image_count()) && (! stopped); ++i) {
+        auto  hdr = (const struct mach_header_64 *)_dyld_get_image_header(i);
+        const char  *name = _dyld_get_image_name(i);
+        image = name ? name : "";
+        for (const auto & sect : sects) {
+          unsigned long  size = 0;
+          auto  data = getsectiondata(hdr, sect[0], sect[1], &size);
+          if (data && size && (! stopped)) {
+            scanner.ScanMemory((const char *)data, size, hitcb);
+          }
+        }
+      }
+#else
+      struct Ctx {
+        const Scanner       *scanner;
+        const ScanCallback  *cb;
+        std::string_view    *image;
+        const bool          *stopped;
+      };
+      Ctx  ctx = { &scanner, &hitcb, &image, &stopped };
+      dl_iterate_phdr([] (struct dl_phdr_info *info, size_t, void *arg) {
+        Ctx  *ctx = (Ctx *)arg;
+        *ctx->image = info->dlpi_name ? info->dlpi_name : "";
+        //  Code is only scanned if .rodata shares its segment, i.e.
+        //  the image wasn't linked with -z separate-code.
+        bool  skipCode = false;
+        for (int i = 0; i < info->dlpi_phnum; ++i) {
+          const auto  & phdr = info->dlpi_phdr[i];
+          if ((phdr.p_type == PT_LOAD)
+              && ((phdr.p_flags & (PF_R|PF_W|PF_X)) == PF_R)) {
+            skipCode = true;
+          }
+        }
+        for (int i = 0; (i < info->dlpi_phnum) && (! *ctx->stopped); ++i) {
+          const auto  & phdr = info->dlpi_phdr[i];
+          if ((phdr.p_type == PT_LOAD) && (phdr.p_flags & PF_R)
+              && (! (skipCode && (phdr.p_flags & PF_X)))
+              && phdr.p_filesz) {
+            ctx->scanner->ScanMemory((const char *)(info->dlpi_addr
+                                                    + phdr.p_vaddr),
+                                     phdr.p_filesz, *ctx->cb);
+          }
+        }
+        return (*ctx->stopped ? 1 : 0);
+      }, &ctx);
+#endif
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    std::string ManifestDir()
+    {
+      const char  *dir = getenv("DWM_PKG_MANIFEST_DIR");
+      if (dir && *dir) {
+        return dir;
+      }
+#if defined(__linux__)
+      return "/dev/shm";
+#else
+      return "/tmp";
+#endif
+    }
+
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    bool PublishManifest(const std::string & dir)
+    {
+      std::string  manifest = BuildManifest();
+      std::string  path(dir + '/' + std::string(k_manifestPrefix)
+                        + std::to_string(getpid()));
+      std::string  tmpPath(path + ".tmp");
+      
+      std::lock_guard<std::mutex>  lck(g_publishMtx);
+      unlink(tmpPath.c_str());
+      int  fd = open(tmpPath.c_str(), O_RDWR|O_CREAT|O_EXCL|O_CLOEXEC, 0444);
+      if (fd < 0) {
+        return false;
+      }
+      struct flock  fl = WholeFileLock(F_RDLCK);
+      if ((! WriteAll(fd, manifest)) || (fcntl(fd, k_setLock, &fl) != 0)
+          || (rename(tmpPath.c_str(), path.c_str()) != 0)) {
+        close(fd);
+        unlink(tmpPath.c_str());
+        return false;
+      }
+      if ((g_publishedFd >= 0) && (g_publishedPath != path)) {
+        unlink(g_publishedPath.c_str());
+      }
+      if (g_publishedFd >= 0) {
+        close(g_publishedFd);
+      }
+      g_publishedFd = fd;
+      g_publishedPath = path;
+      return true;
+    }
+
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    void UnpublishManifest()
+    {
+      std::lock_guard<std::mutex>  lck(g_publishMtx);
+      if (g_publishedFd >= 0) {
+        unlink(g_publishedPath.c_str());
+        close(g_publishedFd);
+        g_publishedFd = -1;
+        g_publishedPath.clear();
+      }
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    ManifestPublisher::ManifestPublisher(const std::string & dir)
+        : _published(PublishManifest(dir))
+    {}
+
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    ManifestPublisher::~ManifestPublisher()
+    {
+      if (_published) {
+        UnpublishManifest();
+      }
+    }
+    
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    Manifest::Manifest()
+        : _buf(), _pid(0), _published(0), _program(), _packages()
+    {}
+
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    bool Manifest::Read(int fd)
+    {
+      _buf.resize(k_maxManifestSize);
+      ssize_t  rc = pread(fd, _buf.data(), _buf.size(), 0);
+      if (rc <= 0) {
+        return false;
+      }
+      return Parse(_buf.data(), rc);
+    }
+
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    bool Manifest::Parse(const char *data, std::size_t len)
+    {
+      _program = std::string_view();
+      _packages.clear();
+      if (data != _buf.data()) {
+        _buf.assign(data, data + len);
+      }
+      ManifestHeader  hdr;
+      if (len < sizeof(hdr)) {
+        return false;
+      }
+      memcpy(&hdr, _buf.data(), sizeof(hdr));
+      if ((memcmp(hdr.magic, k_manifestMagic, sizeof(hdr.magic)) != 0)
+          || (hdr.version != k_manifestVersion)
+          || (hdr.headerSize != sizeof(hdr)) || (hdr.totalSize != len)
+          || (hdr.numStrings == 0) || (_buf[len - 1] != '\0')) {
+        return false;
+      }
+      const char  *p = _buf.data() + sizeof(hdr);
+      const char  *end = _buf.data() + len;
+      std::vector<std::string_view>  strs;
+      while (p < end) {
+        std::string_view  s(p);
+        strs.push_back(s);
+        p += s.size() + 1;
+      }
+      if (strs.size() != hdr.numStrings) {
+        return false;
+      }
+      _pid = hdr.pid;
+      _published = hdr.published;
+      _program = strs[0];
+      _packages.assign(strs.begin() + 1, strs.end());
+      return true;
+    }
+
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    std::size_t
+    CollectManifests(const std::string & dir,
+                     const std::function<bool(const Manifest &)> & cb)
+    {
+      DIR  *dirp = opendir(dir.c_str());
+      if (! dirp) {
+        return 0;
+      }
+      std::size_t  numCollected = 0;
+      Manifest     manifest;
+      while (struct dirent *ent = readdir(dirp)) {
+        std::string_view  name(ent->d_name);
+        if ((! name.starts_with(k_manifestPrefix))
+            || (name.size() == k_manifestPrefix.size())
+            || (name.find_first_not_of("0123456789", k_manifestPrefix.size())
+                != std::string_view::npos)) {
+          continue;
+        }
+#if ! defined(F_OFD_SETLK)
+        //  Closing our own manifest would drop our POSIX lock on it.
+        if (strtol(name.data() + k_manifestPrefix.size(), nullptr, 10)
+            == getpid()) {
+          continue;
+        }
+#endif
+        int  fd = openat(dirfd(dirp), ent->d_name, O_RDONLY|O_CLOEXEC);
+        if (fd < 0) {
+          continue;
+        }
+        //  A manifest is live while its publisher holds a read lock on
+        //  it, so a write lock would conflict.
+        struct flock  fl = WholeFileLock(F_WRLCK);
+        bool  live = ((fcntl(fd, k_getLock, &fl) == 0)
+                      && (fl.l_type != F_UNLCK));
+        bool  valid = live && manifest.Read(fd);
+        close(fd);
+        if (valid) {
+          ++numCollected;
+          if (! cb(manifest)) {
+            break;
+          }
+        }
+      }
+      closedir(dirp);
+      return numCollected;
+    }
+    
+  }  // namespace Pkg
+
+}  // namespace Dwm
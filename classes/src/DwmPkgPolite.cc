@@ -0,0 +1,198 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  \file DwmPkgPolite.cc
+//!  \author Daniel W. McRobb
+//!  \brief Dwm::Pkg::Polite and Dwm::Pkg::PageCacheGuard implementations
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <sys/mman.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+}
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "DwmPkgPolite.hh"
+
+namespace Dwm {
+
+  namespace Pkg {
+
+    namespace {
+
+      //----------------------------------------------------------------------
+      //!  
+      //----------------------------------------------------------------------
+      uint64_t NowNsecs()
+      {
+        using namespace std::chrono;
+        return duration_cast<nanoseconds>(steady_clock::now()
+                                          .time_since_epoch()).count();
+      }
+
+      //----------------------------------------------------------------------
+      //!  mincore() takes unsigned char * on Linux and char * elsewhere.
+      //----------------------------------------------------------------------
+#if defined(__linux__)
+      using MincoreVec = unsigned char *;
+#else
+      using MincoreVec = char *;
+#endif
+
+      //----------------------------------------------------------------------
+      //!  True while a PageCacheGuard is active in this thread.  A guard
+      //!  created inside another (ScanFd() called by BatchScanner) does
+      //!  nothing, since the outer one covers the whole file.
+      //----------------------------------------------------------------------
+      thread_local bool  t_guarding = false;
+      
+    }  // anonymous namespace
+    
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    Polite::Polite(uint64_t bytesPerSec, bool dropCache, uint64_t burst)
+        : _bytesPerSec(bytesPerSec), _dropCache(dropCache),
+          _burst(burst ? burst
+                 : std::max<uint64_t>(bytesPerSec / 10, 1024 * 1024)),
+          _mtx(), _tokens(_burst), _lastRefill(NowNsecs()), _bytesTaken(0),
+          _throttledNsecs(0), _numThrottled(0), _pagesDropped(0),
+          _pagesKept(0)
+    {}
+
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    void Polite::Take(uint64_t bytes)
+    {
+      _bytesTaken += bytes;
+      if (0 == _bytesPerSec) {
+        return;
+      }
+      uint64_t  waitNsecs = 0;
+      {
+        std::lock_guard<std::mutex>  lck(_mtx);
+        uint64_t  now = NowNsecs();
+        _tokens = std::min(_burst, _tokens + ((now - _lastRefill) * 1e-9
+                                              * _bytesPerSec));
+        _lastRefill = now;
+        _tokens -= bytes;
+        if (_tokens < 0) {
+          waitNsecs = (-_tokens / _bytesPerSec) * 1e9;
+        }
+      }
+      if (waitNsecs) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(waitNsecs));
+        _throttledNsecs += waitNsecs;
+        ++_numThrottled;
+      }
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    PageCacheGuard::PageCacheGuard(Polite *polite, int fd, const void *map,
+                                   std::size_t len)
+        : _polite(polite), _fd(fd), _map(map), _len(len), _resident()
+    {
+      if ((! _polite) || (! _polite->DropCache()) || (0 == _len)
+          || t_guarding) {
+        _polite = nullptr;
+        return;
+      }
+      std::size_t  pageSize = sysconf(_SC_PAGESIZE);
+      _resident.resize((_len + pageSize - 1) / pageSize);
+      void  *p = const_cast<void *>(_map);
+      if (! _map) {
+        p = mmap(nullptr, _len, PROT_READ, MAP_SHARED, _fd, 0);
+        if (p == MAP_FAILED) {
+          _polite = nullptr;
+          return;
+        }
+      }
+      if (mincore(p, _len, (MincoreVec)_resident.data()) != 0) {
+        _polite = nullptr;
+      }
+      else {
+        t_guarding = true;
+      }
+      if (! _map) {
+        munmap(p, _len);
+      }
+    }
+
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    PageCacheGuard::~PageCacheGuard()
+    {
+      if (! _polite) {
+        return;
+      }
+      t_guarding = false;
+      std::size_t  pageSize = sysconf(_SC_PAGESIZE);
+      uint64_t     dropped = 0;
+      std::size_t  page = 0;
+      while (page < _resident.size()) {
+        if (_resident[page] & 1) {
+          ++page;
+          continue;
+        }
+        std::size_t  first = page;
+        while ((page < _resident.size()) && (! (_resident[page] & 1))) {
+          ++page;
+        }
+        std::size_t  off = first * pageSize;
+        std::size_t  len = std::min(page * pageSize, _len) - off;
+        if (_map) {
+          madvise((char *)_map + off, len, MADV_DONTNEED);
+        }
+#if defined(POSIX_FADV_DONTNEED)
+        posix_fadvise(_fd, off, len, POSIX_FADV_DONTNEED);
+#endif
+        dropped += page - first;
+      }
+      _polite->CountPages(dropped, _resident.size() - dropped);
+    }
+    
+  }  // namespace Pkg
+
+}  // namespace Dwm
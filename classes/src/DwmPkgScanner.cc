@@ -0,0 +1,495 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+
+//---------------------------------------------------------------------------
+//!  \file DwmPkgScanner.cc
+//!  \author Daniel W. McRobb
+//!  \brief Dwm::Pkg::Scanner class implementation
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+}
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "DwmPkgImage.hh"
+#include "DwmPkgInfo.hh"
+#include "DwmPkgProbes.hh"
+#include "DwmPkgScanner.hh"
+#include "DwmPkgVersion.hh"
+
+namespace Dwm {
+
+  namespace Pkg {
+
+    namespace {
+
+      //----------------------------------------------------------------------
+      //!  Returns true if there's a "@(#)" whose '@' byte is at @c map[i]
+      //!  (with @c size bytes at @c map), setting @c encoding.  Every
+      //!  encoding of the marker has an '@' byte: "@(#)" in UTF-8,
+      //!  "@\0(\0#\0)\0" in UTF-16LE and "\0@\0(\0#\0)" in UTF-16BE,
+      //!  where the marker starts a byte before the '@'.  So one search
+      //!  for '@' finds candidates for all three, and the UTF-16 checks
+      //!  only run for an '@' followed by a NUL.
+      //!
+      //!  "\0@\0(\0#\0)\0" is both.  Read either way, ASCII text comes
+      //!  out the same, but anything else doesn't, so we go by alignment:
+      //!  UTF-16 data is 2-byte aligned in practice.
+      //----------------------------------------------------------------------
+      bool MarkerAt(const char *map, std::size_t size, std::size_t i,
+                    TextEncoding & encoding)
+      {
+        if ((size - i) < 4) {
+          return false;
+        }
+        if (map[i+1] != '\0') {
+          encoding = TextEncoding::k_utf8;
+          return ((map[i+1] == '(') && (map[i+2] == '#')
+                  && (map[i+3] == ')'));
+        }
+        bool  le = (((size - i) >= 8)
+                    && (memcmp(map + i + 1, "\0(\0#\0)\0", 7) == 0));
+        bool  be = ((i > 0) && ((size - i) >= 7) && (map[i-1] == '\0')
+                    && (memcmp(map + i + 1, "\0(\0#\0)", 6) == 0));
+        if (le && be) {
+          be = (((uintptr_t)(map + i)) & 1);
+        }
+        if (be) {
+          encoding = TextEncoding::k_utf16be;
+          return true;
+        }
+        if (le) {
+          encoding = TextEncoding::k_utf16le;
+          return true;
+        }
+        return false;
+      }
+
+      //----------------------------------------------------------------------
+      //!  Transcodes the UTF-16 string at @c p (at most @c len bytes) to
+      //!  UTF-8 in @c out, up to a NUL or newline, or until another
+      //!  character would take @c out past @c maxLength bytes (0 for no
+      //!  limit).  Unpaired surrogates become U+FFFD.  Returns the number
+      //!  of bytes of @c p used, not counting the terminator, and sets
+      //!  @c terminated to whether we stopped at one.
+      //----------------------------------------------------------------------
+      std::size_t Utf16ToUtf8(const char *p, std::size_t len,
+                              bool bigEndian, std::size_t maxLength,
+                              std::string & out, bool & terminated)
+      {
+        auto  unit = [&] (std::size_t at) -> uint32_t {
+          const unsigned char  *u = (const unsigned char *)p + at;
+          return (bigEndian ? ((u[0] << 8) | u[1]) : ((u[1] << 8) | u[0]));
+        };
+        
+        out.clear();
+        terminated = false;
+        std::size_t  i = 0;
+        while ((len - i) >= 2) {
+          uint32_t  c = unit(i);
+          if ((c == 0) || (c == '\n')) {
+            terminated = true;
+            break;
+          }
+          std::size_t  units = 1;
+          if ((c >= 0xD800) && (c < 0xDC00) && ((len - i) >= 4)) {
+            uint32_t  lo = unit(i + 2);
+            if ((lo >= 0xDC00) && (lo < 0xE000)) {
+              c = 0x10000 + ((c - 0xD800) << 10) + (lo - 0xDC00);
+              units = 2;
+            }
+          }
+          if ((c >= 0xD800) && (c < 0xE000)) {
+            c = 0xFFFD;
+          }
+          std::size_t  n = (c < 0x80) ? 1 : ((c < 0x800) ? 2
+                                             : ((c < 0x10000) ? 3 : 4));
+          if (maxLength && ((out.size() + n) > maxLength)) {
+            break;
+          }
+          if (n == 1) {
+            out += (char)c;
+          }
+          else {
+            char  buf[4];
+            for (std::size_t b = n - 1; b > 0; --b) {
+              buf[b] = (char)(0x80 | (c & 0x3F));
+              c >>= 6;
+            }
+            buf[0] = (char)((0xF00 >> n) | c);
+            out.append(buf, n);
+          }
+          i += 2 * units;
+        }
+        return i;
+      }
+      
+    }  // anonymous namespace
+
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    const char *TextEncodingName(TextEncoding encoding)
+    {
+      switch (encoding) {
+        case TextEncoding::k_utf16le:  return "utf-16le";
+        case TextEncoding::k_utf16be:  return "utf-16be";
+        default:                       return "utf-8";
+      }
+    }
+    
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    bool ScanFilter::PkgsOnly() const
+    {
+      return ((! name.empty()) || (! status.empty()) || (! type.empty())
+              || (! versionRange.empty()));
+    }
+
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    bool ScanFilter::SetVersionRange(std::string_view spec)
+    {
+      versionRange.clear();
+      while (! spec.empty()) {
+        std::string_view  term = spec.substr(0, spec.find(','));
+        spec.remove_prefix(std::min(spec.size(), term.size() + 1));
+        std::size_t  opLen = term.find_first_not_of("<>=!");
+        if ((opLen == std::string_view::npos) || (opLen > 2)) {
+          return false;
+        }
+        std::string  op(term.substr(0, opLen));
+        if (op.empty() || (op == "=")) {
+          op = "==";
+        }
+        if ((op != "<") && (op != "<=") && (op != ">") && (op != ">=")
+            && (op != "==") && (op != "!=")) {
+          return false;
+        }
+        versionRange.push_back({op, std::string(term.substr(opLen))});
+      }
+      return (! versionRange.empty());
+    }
+    
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    void ScanFilter::SetStatus(std::string_view s)
+    {
+      if (s == "dev")       { status = DWM_PKG_STATUS_DEV; }
+      else if (s == "rc")   { status = DWM_PKG_STATUS_RC;  }
+      else if (s == "rel")  { status = DWM_PKG_STATUS_REL; }
+      else                  { status = s; }
+      return;
+    }
+
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    void ScanFilter::SetType(std::string_view t)
+    {
+      if (t == "hdr")       { type = DWM_PKG_TYPE_HDR; }
+      else if (t == "lib")  { type = DWM_PKG_TYPE_LIB; }
+      else if (t == "exe")  { type = DWM_PKG_TYPE_EXE; }
+      else if (t == "doc")  { type = DWM_PKG_TYPE_DOC; }
+      else                  { type = t; }
+      return;
+    }
+    
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    bool ScanFilter::Prefilter(std::string_view s) const
+    {
+      if ((! type.empty()) && (s.find(type) == std::string_view::npos)) {
+        return false;
+      }
+      if ((! status.empty()) && (s.find(status) == std::string_view::npos)) {
+        return false;
+      }
+      if ((! name.empty()) && (s.find(name) == std::string_view::npos)) {
+        return false;
+      }
+      return true;
+    }
+
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    bool ScanFilter::Matches(const InfoView & info) const
+    {
+      if (((! name.empty()) && (info.name != name))
+          || ((! status.empty()) && (info.status != status))
+          || ((! type.empty()) && (info.type != type))) {
+        return false;
+      }
+      Version  version(info.version);
+      for (const auto & term : versionRange) {
+        int  cmp = version.Compare(Version(term.second));
+        if (((term.first == "<") && (cmp >= 0))
+            || ((term.first == "<=") && (cmp > 0))
+            || ((term.first == ">") && (cmp <= 0))
+            || ((term.first == ">=") && (cmp < 0))
+            || ((term.first == "==") && (cmp != 0))
+            || ((term.first == "!=") && (cmp == 0))) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    Scanner::Scanner(const ScanFilter & filter, bool parse)
+        : _filter(filter), _parse(parse || filter.PkgsOnly()),
+          _polite(nullptr)
+    {}
+    
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    bool Scanner::ScanFile(const std::string & path,
+                           const ScanCallback & cb) const
+    {
+      bool  rc = false;
+      int   fd = open(path.c_str(), O_RDONLY);
+      DWM_PKG_PROBE2(file_open, path.c_str(), fd);
+      if (fd >= 0) {
+        Probes::PathScope  probePath(path.c_str());
+        rc = ScanFd(fd, cb);
+        close(fd);
+      }
+      return rc;
+    }
+
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    bool Scanner::ScanFd(int fd, const ScanCallback & cb) const
+    {
+      struct stat  statbuf;
+      if (fstat(fd, &statbuf) != 0) {
+        return false;
+      }
+      if (S_ISREG(statbuf.st_mode)) {
+        if (statbuf.st_size == 0) {
+          return true;
+        }
+        if (_polite) {
+          _polite->Take(statbuf.st_size);
+        }
+        DWM_PKG_PROBE_TIMER(start, map);
+        void  *p = mmap(0, statbuf.st_size, PROT_READ, MAP_FILE|MAP_SHARED,
+                        fd, 0);
+        if (p == MAP_FAILED) {
+          return false;
+        }
+        DWM_PKG_PROBE3(map, Probes::Path(), statbuf.st_size,
+                       Probes::Since(start));
+        {
+          PageCacheGuard  guard(_polite, fd, p, statbuf.st_size);
+          ScanImage((const char *)p, statbuf.st_size, cb);
+        }
+        munmap(p, statbuf.st_size);
+        return true;
+      }
+
+      //  Not a regular file (pipe, socket, device...).  Read it all.
+      std::vector<char>  buf;
+      char      chunk[64 * 1024];
+      ssize_t   bytesRead;
+      DWM_PKG_PROBE_TIMER(start, read);
+      while ((bytesRead = read(fd, chunk, sizeof(chunk))) > 0) {
+        buf.insert(buf.end(), chunk, chunk + bytesRead);
+        if (_polite) {
+          _polite->Take(bytesRead);
+        }
+      }
+      if (bytesRead < 0) {
+        return false;
+      }
+      DWM_PKG_PROBE3(read, Probes::Path(), buf.size(), Probes::Since(start));
+      if (! buf.empty()) {
+        ScanImage(buf.data(), buf.size(), cb);
+      }
+      return true;
+    }
+    
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    std::size_t Scanner::ScanImage(const char *data, std::size_t len,
+                                   const ScanCallback & cb) const
+    {
+      DWM_PKG_PROBE2(scan_start, Probes::Path(), len);
+      DWM_PKG_PROBE_TIMER(start, scan_end);
+      std::vector<ImageRange>  ranges;
+      if (_filter.allBytes
+          || (FindDataRanges(data, len, ranges) == ImageFormat::k_unknown)) {
+        std::size_t  rc = ScanMemory(data, len, cb);
+        DWM_PKG_PROBE4(scan_end, Probes::Path(), len, rc,
+                       Probes::Since(start));
+        return rc;
+      }
+      std::size_t  rc = 0;
+      bool         stop = false;
+      for (const auto & range : ranges) {
+        ScanMemory(data + range.offset, range.length,
+                   [&] (const ScanHit & hit) {
+                     ScanHit  imageHit(hit);
+                     imageHit.offset += range.offset;
+                     ++rc;
+                     stop = ((! cb(imageHit)) || (rc == _filter.limit));
+                     return (! stop);
+                   });
+        if (stop) {
+          break;
+        }
+      }
+      DWM_PKG_PROBE4(scan_end, Probes::Path(), len, rc,
+                     Probes::Since(start));
+      return rc;
+    }
+    
+    //------------------------------------------------------------------------
+    //!  A hit runs from "@(#)" to the next NUL or newline.  One that runs
+    //!  off the end of the data is not reported.  One longer than
+    //!  _filter.maxLength is reported truncated (and not parsed), and we
+    //!  resume searching at the truncation point so a huge unterminated
+    //!  run can't hide the hits in it.  UTF-16 hits are the same, in
+    //!  16-bit units, and maxLength applies to their UTF-8 form, except
+    //!  that an unterminated one doesn't end the search.
+    //------------------------------------------------------------------------
+    std::size_t Scanner::ScanMemory(const char *map, std::size_t size,
+                                    const ScanCallback & cb) const
+    {
+      std::size_t   rc = 0;
+      std::size_t   i = 0;
+      InfoView      info;
+      TextEncoding  encoding;
+      std::string   utf8;
+      while ((size - i) > 4) {
+        const char  *at = (const char *)memchr(map + i, '@', size - i - 4);
+        if (! at) {
+          break;
+        }
+        i = at - map;
+        if (! MarkerAt(map, size, i, encoding)) {
+          ++i;
+          continue;
+        }
+        std::size_t       startidx = i;
+        std::string_view  raw;
+        bool              truncated;
+        if (encoding == TextEncoding::k_utf8) {
+          std::size_t  endidx = size;
+          if (_filter.maxLength
+              && (_filter.maxLength < (size - startidx))) {
+            endidx = startidx + _filter.maxLength;
+          }
+          i += 4;
+          while ((i < endidx) && (map[i] != '\0') && (map[i] != '\n')) {
+            ++i;
+          }
+          if (i == size) {
+            break;   // unterminated
+          }
+          truncated = ((map[i] != '\0') && (map[i] != '\n'));
+          raw = std::string_view(&map[startidx], i - startidx);
+        }
+        else {
+          bool  bigEndian = (encoding == TextEncoding::k_utf16be);
+          if (bigEndian) {
+            --startidx;
+          }
+          //  Always take at least the marker, so we make progress.
+          std::size_t  maxLength = _filter.maxLength;
+          if (maxLength) {
+            maxLength = std::max(maxLength, (std::size_t)4);
+          }
+          bool  terminated;
+          i = startidx + Utf16ToUtf8(map + startidx, size - startidx,
+                                     bigEndian, maxLength, utf8, terminated);
+          if ((! terminated) && ((size - i) < 2)) {
+            //  Unterminated.  Unlike UTF-8, it may have been a misread
+            //  (see MarkerAt()), so keep looking after its '@'.
+            i = at - map + 1;
+            continue;
+          }
+          truncated = (! terminated);
+          raw = utf8;
+        }
+        DWM_PKG_PROBE3(hit_found, Probes::Path(), raw.data(), raw.size());
+        if (_filter.Prefilter(raw)) {
+          bool  isInfo = (_parse && (! truncated) && info.Parse(raw));
+          if (isInfo) {
+            DWM_PKG_PROBE3(parse_success, Probes::Path(), raw.data(),
+                           raw.size());
+          }
+          else if (_parse) {
+            DWM_PKG_PROBE3(parse_fail, Probes::Path(), raw.data(),
+                           raw.size());
+          }
+          if (isInfo || (! _filter.PkgsOnly())) {
+            if ((! isInfo) || _filter.Matches(info)) {
+              ++rc;
+              if (! cb({raw, startidx, isInfo ? &info : nullptr,
+                        truncated, encoding})) {
+                break;
+              }
+              if (rc == _filter.limit) {
+                break;
+              }
+            }
+          }
+        }
+      }
+      return rc;
+    }
+    
+  }  // namespace Pkg
+
+}  // namespace Dwm
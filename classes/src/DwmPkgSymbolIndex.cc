@@ -0,0 +1,191 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  \file DwmPkgSymbolIndex.cc
+//!  \author Daniel W. McRobb
+//!  \brief Dwm::Pkg::SymbolIndex class implementation
+//---------------------------------------------------------------------------
+
+#include <cxxabi.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+#include "DwmPkgSymbolIndex.hh"
+
+namespace Dwm {
+
+  namespace Pkg {
+
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    SymbolIndex::SymbolIndex()
+        : _segments(), _ranges()
+    {}
+    
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    bool SymbolIndex::Build(const char *data, std::size_t len)
+    {
+      _segments.clear();
+      _ranges.clear();
+      std::vector<ElfSymbol>  symbols;
+      if (! FindElfSymbols(data, len, symbols)) {
+        return false;
+      }
+      FindLoadSegments(data, len, _segments);
+      std::sort(_segments.begin(), _segments.end(),
+                [] (const CoreSegment & a, const CoreSegment & b)
+                { return (a.offset < b.offset); });
+
+      //  Outer symbols before the ones nested in them, and a global
+      //  before a local alias (or the .dynsym copy of a .symtab entry)
+      //  at the same address and size, which is then dropped.
+      std::sort(symbols.begin(), symbols.end(),
+                [] (const ElfSymbol & a, const ElfSymbol & b) {
+                  if (a.addr != b.addr)    { return (a.addr < b.addr); }
+                  if (a.size != b.size)    { return (a.size > b.size); }
+                  if (a.local != b.local)  { return b.local; }
+                  return (a.name < b.name);
+                });
+      auto  dups = std::unique(symbols.begin(), symbols.end(),
+                               [] (const ElfSymbol & a, const ElfSymbol & b)
+                               { return ((a.addr == b.addr)
+                                         && (a.size == b.size)); });
+      symbols.erase(dups, symbols.end());
+
+      //  Sweep the symbols in address order, keeping a stack of the
+      //  ones we're inside, and emit a range each time the innermost
+      //  symbol changes.  A symbol that sticks out of the one it starts
+      //  in is cut off at the end of the outer one.
+      _ranges.reserve(symbols.size());
+      std::vector<SymbolRange>  open;
+      uint64_t  cursor = 0;
+      auto  emitTo = [&] (uint64_t end) {
+        if ((! open.empty()) && (cursor < end)) {
+          _ranges.push_back({cursor, end, open.back().name});
+        }
+        cursor = std::max(cursor, end);
+      };
+      for (const auto & sym : symbols) {
+        while ((! open.empty()) && (open.back().end <= sym.addr)) {
+          emitTo(open.back().end);
+          open.pop_back();
+        }
+        emitTo(sym.addr);
+        cursor = sym.addr;
+        uint64_t  end = sym.addr + sym.size;
+        if (end < sym.addr) {
+          end = std::numeric_limits<uint64_t>::max();
+        }
+        if (! open.empty()) {
+          end = std::min(end, open.back().end);
+        }
+        open.push_back({sym.addr, end, sym.name});
+      }
+      while (! open.empty()) {
+        emitTo(open.back().end);
+        open.pop_back();
+      }
+      return true;
+    }
+
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    bool SymbolIndex::OffsetToAddr(uint64_t offset, uint64_t & addr) const
+    {
+      if (_segments.empty()) {
+        addr = offset;
+        return true;
+      }
+      auto  it = std::upper_bound(_segments.begin(), _segments.end(), offset,
+                                  [] (uint64_t off, const CoreSegment & seg)
+                                  { return (off < seg.offset); });
+      //  Segments can share a page at their boundaries, so look at the
+      //  previous one too.
+      for (int i = 0; (i < 2) && (it != _segments.begin()); ++i) {
+        --it;
+        if ((offset - it->offset) < it->fileSize) {
+          addr = it->vaddr + (offset - it->offset);
+          return true;
+        }
+      }
+      return false;
+    }
+    
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    std::string_view SymbolIndex::Find(uint64_t addr) const
+    {
+      auto  it = std::upper_bound(_ranges.begin(), _ranges.end(), addr,
+                                  [] (uint64_t a, const SymbolRange & r)
+                                  { return (a < r.start); });
+      if (it != _ranges.begin()) {
+        --it;
+        if (addr < it->end) {
+          return it->name;
+        }
+      }
+      return std::string_view();
+    }
+
+    //------------------------------------------------------------------------
+    //!  
+    //------------------------------------------------------------------------
+    std::string Demangle(std::string_view name)
+    {
+      std::string  mangled(name);
+      int    status = -1;
+      char  *demangled = abi::__cxa_demangle(mangled.c_str(), nullptr,
+                                             nullptr, &status);
+      if (demangled) {
+        std::string  rc(demangled);
+        free(demangled);
+        if (status == 0) {
+          return rc;
+        }
+      }
+      return mangled;
+    }
+    
+  }  // namespace Pkg
+
+}  // namespace Dwm
@@ -0,0 +1,144 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  \file BenchPackageIndex.cc
+//!  \author Daniel W. McRobb
+//!  \brief Compares Dwm::Pkg::PackageIndex::find() with a linear search.
+//!    Not built by default, since it's a benchmark and not a test:
+//!
+//!    c++ -std=c++20 -O2 -I../include BenchPackageIndex.cc
+//---------------------------------------------------------------------------
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "DwmPkgPackageIndex.hh"
+
+#define MK_INFO(n)                                                         \
+  inline constexpr const Dwm::Pkg::Info                                    \
+  pkg##n(DWM_PKG_TYPE_LIB, DWM_PKG_STATUS_REL, "libBench" #n, "1.0." #n,   \
+         "Someone", "");
+#define MK_INFO8(n)                                                        \
+  MK_INFO(n##0) MK_INFO(n##1) MK_INFO(n##2) MK_INFO(n##3) MK_INFO(n##4)    \
+  MK_INFO(n##5) MK_INFO(n##6) MK_INFO(n##7)
+#define LIST_INFO8(n)                                                      \
+  pkg##n##0, pkg##n##1, pkg##n##2, pkg##n##3, pkg##n##4, pkg##n##5,        \
+  pkg##n##6, pkg##n##7
+
+namespace Bench {
+  MK_INFO8(1) MK_INFO8(2) MK_INFO8(3) MK_INFO8(4)
+  MK_INFO8(5) MK_INFO8(6) MK_INFO8(7) MK_INFO8(8)
+
+  static constexpr auto  idx4 = Dwm::Pkg::make_package_index(pkg10, pkg11,
+                                                             pkg12, pkg13);
+  static constexpr auto  idx16 =
+    Dwm::Pkg::make_package_index(LIST_INFO8(1), LIST_INFO8(2));
+  static constexpr auto  idx64 =
+    Dwm::Pkg::make_package_index(LIST_INFO8(1), LIST_INFO8(2),
+                                 LIST_INFO8(3), LIST_INFO8(4),
+                                 LIST_INFO8(5), LIST_INFO8(6),
+                                 LIST_INFO8(7), LIST_INFO8(8));
+}
+
+//----------------------------------------------------------------------------
+//!  Linear search, comparing names, as callers of get_packages() do.
+//----------------------------------------------------------------------------
+static const Dwm::Pkg::InfoFields *
+LinearFind(std::span<const Dwm::Pkg::InfoFields> pkgs, std::string_view name)
+{
+  for (const auto & pkg : pkgs) {
+    if (pkg.name == name) {
+      return &pkg;
+    }
+  }
+  return nullptr;
+}
+
+//----------------------------------------------------------------------------
+//!  Returns the mean nanoseconds per call of @c fn over @c names.
+//----------------------------------------------------------------------------
+template <typename Fn>
+static double Time(const std::vector<std::string> & names, Fn && fn)
+{
+  constexpr size_t  k_rounds = 200000;
+  size_t  found = 0;
+  auto  start = std::chrono::steady_clock::now();
+  for (size_t r = 0; r < k_rounds; ++r) {
+    for (const auto & name : names) {
+      found += (fn(std::string_view(name)) != nullptr);
+    }
+  }
+  auto  end = std::chrono::steady_clock::now();
+  if (found == 1) {   // keeps the loop from being optimized away
+    std::puts("");
+  }
+  return std::chrono::duration<double,std::nano>(end - start).count()
+    / (k_rounds * names.size());
+}
+
+//----------------------------------------------------------------------------
+//!  Times hits and misses on @c idx.
+//----------------------------------------------------------------------------
+template <typename Index>
+static void Run(const Index & idx)
+{
+  std::vector<std::string>  hits, misses;
+  for (const auto & pkg : idx.entries()) {
+    hits.emplace_back(pkg.name);
+    misses.emplace_back(std::string(pkg.name) + "x");
+  }
+  auto  hash = [&] (std::string_view n) { return idx.find(n); };
+  auto  linear = [&] (std::string_view n)
+  { return LinearFind(idx.entries(), n); };
+  std::printf("%4zu packages  hit: %6.1f ns hash %6.1f ns linear"
+              "  miss: %6.1f ns hash %6.1f ns linear\n", idx.size(),
+              Time(hits, hash), Time(hits, linear),
+              Time(misses, hash), Time(misses, linear));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  Run(Bench::idx4);
+  Run(Bench::idx16);
+  Run(Bench::idx64);
+  return 0;
+}
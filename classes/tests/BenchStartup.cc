@@ -0,0 +1,148 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  \file BenchStartup.cc
+//!  \author Daniel W. McRobb
+//!  \brief Measures the exec-to-exit latency of a command, e.g.
+//!    'BenchStartup -n 2000 ../../apps/dwmwhat/dwmwhat -v'.  The command's
+//!    output goes to /dev/null.  Not built by default, since it's a
+//!    benchmark and not a test:
+//!
+//!    c++ -std=c++20 -O2 BenchStartup.cc -o BenchStartup
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <sys/wait.h>
+  #include <fcntl.h>
+  #include <spawn.h>
+  #include <unistd.h>
+}
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+extern char **environ;
+
+//----------------------------------------------------------------------------
+//!  Runs @c argv once and returns its exec-to-exit time in microseconds,
+//!  or a negative number if it couldn't be run or didn't exit 0.
+//----------------------------------------------------------------------------
+static double RunOnce(char *argv[], int devNull)
+{
+  posix_spawn_file_actions_t  actions;
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_adddup2(&actions, devNull, STDOUT_FILENO);
+  auto   start = std::chrono::steady_clock::now();
+  pid_t  pid;
+  int    rc = posix_spawn(&pid, argv[0], &actions, nullptr, argv, environ);
+  posix_spawn_file_actions_destroy(&actions);
+  if (rc != 0) {
+    return -1.0;
+  }
+  int  status;
+  if ((waitpid(pid, &status, 0) != pid)
+      || (! WIFEXITED(status)) || (WEXITSTATUS(status) != 0)) {
+    return -1.0;
+  }
+  auto  end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double,std::micro>(end - start).count();
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void Usage(const char *argv0)
+{
+  std::fprintf(stderr, "usage: %s [-n runs] command [args...]\n", argv0);
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  size_t  numRuns = 1000;
+  int     optChar;
+  while ((optChar = getopt(argc, argv, "+n:")) != -1) {
+    switch (optChar) {
+      case 'n':
+        numRuns = strtoul(optarg, nullptr, 10);
+        break;
+      default:
+        Usage(argv[0]);
+        return 1;
+    }
+  }
+  if ((optind >= argc) || (numRuns == 0)) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  int  devNull = open("/dev/null", O_WRONLY);
+  if (devNull < 0) {
+    std::perror("/dev/null");
+    return 1;
+  }
+  //  One untimed run to warm the page cache.
+  if (RunOnce(&argv[optind], devNull) < 0) {
+    std::fprintf(stderr, "failed to run %s\n", argv[optind]);
+    return 1;
+  }
+  std::vector<double>  usecs;
+  usecs.reserve(numRuns);
+  for (size_t i = 0; i < numRuns; ++i) {
+    double  t = RunOnce(&argv[optind], devNull);
+    if (t < 0) {
+      std::fprintf(stderr, "failed to run %s\n", argv[optind]);
+      return 1;
+    }
+    usecs.push_back(t);
+  }
+  std::sort(usecs.begin(), usecs.end());
+  double  sum = 0;
+  for (auto t : usecs) {
+    sum += t;
+  }
+  std::printf("%zu runs  min %.0f us  median %.0f us  mean %.0f us"
+              "  p99 %.0f us\n", numRuns, usecs.front(),
+              usecs[numRuns / 2], sum / numRuns,
+              usecs[std::min(numRuns - 1, (numRuns * 99) / 100)]);
+  return 0;
+}
@@ -0,0 +1,159 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+
+//---------------------------------------------------------------------------
+//!  \file TestBatchScanner.cc
+//!  \author Daniel W. McRobb
+//!  \brief Unit tests for Dwm::Pkg::BatchScanner
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <stdlib.h>
+  #include <unistd.h>
+}
+
+#include <atomic>
+#include <cassert>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "DwmPkgBatchScanner.hh"
+
+//----------------------------------------------------------------------------
+//!  Writes test files to a temporary directory.  File i holds i hits,
+//!  except the last two, which are empty and missing.  One file is
+//!  bigger than the batch buffers.
+//----------------------------------------------------------------------------
+static std::vector<std::string> MakeFiles(const std::string & dir,
+                                          size_t numFiles)
+{
+  std::vector<std::string>  paths;
+  for (size_t i = 0; i < numFiles; ++i) {
+    std::string  path = dir + "/file" + std::to_string(i);
+    paths.push_back(path);
+    if (i == (numFiles - 1)) {
+      break;   // missing
+    }
+    std::ofstream  os(path, std::ios::binary);
+    if (i == (numFiles - 2)) {
+      continue;  // empty
+    }
+    for (size_t h = 0; h < i; ++h) {
+      os << "junk" << std::string(i * 10, 'x') << '\0'
+         << "@(#) file" << i << " hit" << h << '\0';
+    }
+    if (i == 7) {
+      os << std::string(300 * 1024, 'y') << '\0' << "@(#) big" << '\0';
+    }
+  }
+  return paths;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestScan(const std::vector<std::string> & paths, bool useUring,
+                     unsigned int numThreads)
+{
+  Dwm::Pkg::Scanner  scanner;
+  std::vector<std::vector<std::string>>  hits(paths.size());
+  std::vector<size_t>  doneCount(paths.size(), 0);
+  std::atomic<size_t>  next = 0;
+  std::mutex           mtx;
+
+  auto  worker = [&] () {
+    Dwm::Pkg::BatchScanner  batch(scanner, 4, 8192, useUring);
+    if (! useUring) {
+      assert(! batch.UsingUring());
+    }
+    batch.Run(paths, next,
+              [&] (size_t fileIdx, const Dwm::Pkg::ScanHit & hit) {
+                std::lock_guard  lck(mtx);
+                hits[fileIdx].push_back(std::string(hit.raw));
+                return true;
+              },
+              [&] (size_t fileIdx) {
+                std::lock_guard  lck(mtx);
+                ++doneCount[fileIdx];
+              });
+  };
+  std::vector<std::thread>  threads;
+  for (unsigned int i = 0; i < numThreads; ++i) {
+    threads.emplace_back(worker);
+  }
+  for (auto & t : threads) {
+    t.join();
+  }
+  
+  for (size_t i = 0; i < paths.size(); ++i) {
+    assert(doneCount[i] == 1);
+    if (i >= paths.size() - 2) {
+      assert(hits[i].empty());
+      continue;
+    }
+    assert(hits[i].size() == i + (i == 7 ? 1 : 0));
+    for (size_t h = 0; h < i; ++h) {
+      assert(hits[i][h] == ("@(#) file" + std::to_string(i) + " hit"
+                            + std::to_string(h)));
+    }
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  char  dirTemplate[] = "/tmp/TestBatchScanner.XXXXXX";
+  assert(mkdtemp(dirTemplate));
+  std::string  dir(dirTemplate);
+  auto  paths = MakeFiles(dir, 40);
+
+  TestScan(paths, true, 1);
+  TestScan(paths, true, 3);
+  TestScan(paths, false, 1);
+  TestScan(paths, false, 3);
+
+  for (const auto & path : paths) {
+    unlink(path.c_str());
+  }
+  rmdir(dir.c_str());
+  return 0;
+}
@@ -0,0 +1,329 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  \file TestCApi.cc
+//!  \author Daniel W. McRobb
+//!  \brief Unit tests for the C interface in DwmPkgC.h
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <fcntl.h>
+  #include <stdlib.h>
+  #include <unistd.h>
+}
+
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "DwmPkgC.h"
+#include "DwmPkgInfo.hh"
+
+namespace TestCApi {
+  inline constexpr const Dwm::Pkg::Info __attribute__((used))
+  info(DWM_PKG_TYPE_LIB, DWM_PKG_STATUS_RC, "TestCApi", "2.3.4",
+       "Daniel McRobb", "test");
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static std::string_view View(dwm_pkg_str s)
+{
+  return std::string_view(s.ptr, s.len);
+}
+
+//----------------------------------------------------------------------------
+//!  What a scan handed to our callback, copied.
+//----------------------------------------------------------------------------
+struct Found
+{
+  std::string  raw;
+  uint64_t     offset;
+  std::string  name;     // empty if not parsed
+  bool         truncated;
+  int          encoding;
+};
+
+//----------------------------------------------------------------------------
+//!  A dwm_pkg_hit_fn that collects hits into a std::vector<Found>.
+//!  Stops after the first hit if the vector's first element says so.
+//----------------------------------------------------------------------------
+static int Collect(const dwm_pkg_hit *hit, void *arg)
+{
+  auto  found = (std::vector<Found> *)arg;
+  assert(hit->size == sizeof(dwm_pkg_hit));
+  found->push_back({std::string(View(hit->raw)), hit->offset,
+                    hit->info ? std::string(View(hit->info->name)) : "",
+                    (hit->truncated != 0), hit->encoding});
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static int StopAtFirst(const dwm_pkg_hit *, void *)
+{
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestParse()
+{
+  assert(dwm_pkg_api_version() == DWM_PKG_C_API_VERSION);
+  
+  std::string_view  s = TestCApi::info.view();
+  dwm_pkg_info      info;
+  memset(&info, 0, sizeof(info));
+  info.size = sizeof(info);
+  assert(dwm_pkg_parse(s.data(), s.size(), &info) == 1);
+  assert(info.size == sizeof(info));
+  assert(View(info.raw) == s);
+  assert(info.raw.ptr == s.data());
+  assert(View(info.type) == DWM_PKG_TYPE_LIB);
+  assert(View(info.status) == DWM_PKG_STATUS_RC);
+  assert(View(info.name) == "TestCApi");
+  assert(View(info.version) == "2.3.4");
+  assert(View(info.other) == "test");
+
+  //  Not an Info string.
+  std::string_view  what("@(#) just a string");
+  assert(dwm_pkg_parse(what.data(), what.size(), &info) == 0);
+
+  //  A caller built against an older header (smaller struct) gets the
+  //  fields it has, and nothing past them is written.
+  dwm_pkg_info  older;
+  memset(&older, 0, sizeof(older));
+  older.size = offsetof(dwm_pkg_info, other);
+  older.other.ptr = "untouched";
+  older.other.len = 9;
+  assert(dwm_pkg_parse(s.data(), s.size(), &older) == 1);
+  assert(older.size == offsetof(dwm_pkg_info, other));
+  assert(View(older.raw) == s);
+  assert(View(older.name) == "TestCApi");
+  assert(View(older.date) == View(info.date));
+  assert(View(older.other) == "untouched");
+
+  //  Only size and raw: still accepted.  Anything smaller is refused.
+  older.size = offsetof(dwm_pkg_info, raw) + sizeof(dwm_pkg_str);
+  older.name.len = 0;
+  assert(dwm_pkg_parse(s.data(), s.size(), &older) == 1);
+  assert(View(older.raw) == s);
+  assert(older.name.len == 0);
+  older.size = offsetof(dwm_pkg_info, raw) + sizeof(dwm_pkg_str) - 1;
+  assert(dwm_pkg_parse(s.data(), s.size(), &older) == 0);
+
+  //  A caller built against a newer header (bigger struct) gets the
+  //  fields we know about, and the rest is left alone.
+  struct {
+    dwm_pkg_info  info;
+    uint64_t      newer;
+  } bigger;
+  memset(&bigger, 0, sizeof(bigger));
+  bigger.info.size = sizeof(bigger);
+  bigger.newer = 42;
+  assert(dwm_pkg_parse(s.data(), s.size(), &bigger.info) == 1);
+  assert(bigger.info.size == sizeof(bigger));
+  assert(View(bigger.info.name) == "TestCApi");
+  assert(bigger.newer == 42);
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestScanBuffer()
+{
+  std::string  buf("junk");
+  buf += TestCApi::info.view();
+  buf += std::string("\0junk@(#) other string\0", 23);
+  buf += Dwm::Pkg::info.view();
+  buf += '\0';
+
+  std::vector<Found>  found;
+  assert(dwm_pkg_scan_buffer(nullptr, buf.data(), buf.size(), Collect,
+                             &found) == 3);
+  assert(found.size() == 3);
+  assert(found[0].raw == TestCApi::info.view());
+  assert(found[0].offset == 4);
+  assert(found[0].name == "TestCApi");
+  assert(found[0].encoding == DWM_PKG_ENCODING_UTF8);
+  assert(found[1].raw == "@(#) other string");
+  assert(found[1].name.empty());
+  assert(found[2].name == "libDwmPkg");
+
+  //  Stopping early.
+  assert(dwm_pkg_scan_buffer(nullptr, buf.data(), buf.size(), StopAtFirst,
+                             nullptr) == 1);
+
+  //  Filters.
+  dwm_pkg_filter  filter;
+  memset(&filter, 0, sizeof(filter));
+  filter.size = sizeof(filter);
+  filter.name = "TestCApi";
+  filter.status = "rc";
+  filter.version_range = ">=2.3,<3";
+  dwm_pkg_scanner  *scanner = dwm_pkg_scanner_new(&filter);
+  assert(scanner);
+  found.clear();
+  assert(dwm_pkg_scan_buffer(scanner, buf.data(), buf.size(), Collect,
+                             &found) == 1);
+  assert(found[0].name == "TestCApi");
+  dwm_pkg_scanner_free(scanner);
+
+  filter.status = "dev";
+  scanner = dwm_pkg_scanner_new(&filter);
+  assert(dwm_pkg_scan_buffer(scanner, buf.data(), buf.size(), Collect,
+                             &found) == 0);
+  dwm_pkg_scanner_free(scanner);
+
+  filter.version_range = "<<<2";
+  errno = 0;
+  assert(dwm_pkg_scanner_new(&filter) == nullptr);
+  assert(errno == EINVAL);
+
+  //  A caller built against an older header passes a smaller filter;
+  //  whatever follows it isn't read.
+  struct {
+    dwm_pkg_filter  filter;
+  } older;
+  memset(&older, 0xff, sizeof(older));
+  older.filter.size = offsetof(dwm_pkg_filter, status);
+  older.filter.name = "libDwmPkg";
+  scanner = dwm_pkg_scanner_new(&older.filter);
+  assert(scanner);
+  found.clear();
+  assert(dwm_pkg_scan_buffer(scanner, buf.data(), buf.size(), Collect,
+                             &found) == 1);
+  assert(found[0].name == "libDwmPkg");
+  dwm_pkg_scanner_free(scanner);
+
+  //  Truncation.
+  memset(&filter, 0, sizeof(filter));
+  filter.size = sizeof(filter);
+  filter.max_length = 10;
+  scanner = dwm_pkg_scanner_new(&filter);
+  found.clear();
+  assert(dwm_pkg_scan_buffer(scanner, buf.data(), buf.size(), Collect,
+                             &found) == 3);
+  assert(found[1].raw == "@(#) other");
+  assert(found[1].truncated);
+  dwm_pkg_scanner_free(scanner);
+  dwm_pkg_scanner_free(nullptr);
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestScanFile()
+{
+  char  path[] = "/tmp/TestCApi.XXXXXX";
+  int   fd = mkstemp(path);
+  assert(fd >= 0);
+  std::string  data("xx");
+  data += TestCApi::info.view();
+  data += '\0';
+  assert(write(fd, data.data(), data.size()) == (ssize_t)data.size());
+
+  std::vector<Found>  found;
+  assert(dwm_pkg_scan_file(nullptr, path, Collect, &found) == 1);
+  assert(found[0].name == "TestCApi");
+  assert(found[0].offset == 2);
+  found.clear();
+  assert(dwm_pkg_scan_fd(nullptr, fd, Collect, &found) == 1);
+  assert(found[0].name == "TestCApi");
+  close(fd);
+  unlink(path);
+
+  errno = 0;
+  assert(dwm_pkg_scan_file(nullptr, path, Collect, &found) == -1);
+  assert(errno == ENOENT);
+  assert(dwm_pkg_scan_fd(nullptr, -1, Collect, &found) == -1);
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestLoaded()
+{
+  struct Names {
+    std::vector<std::string>  names;
+    std::vector<std::string>  images;
+  } names;
+  auto  fn = [] (const dwm_pkg_info *info, dwm_pkg_str image, void *arg) {
+    assert(info->size == sizeof(dwm_pkg_info));
+    ((Names *)arg)->names.emplace_back(View(info->name));
+    ((Names *)arg)->images.emplace_back(View(image));
+    return 1;
+  };
+  long  n = dwm_pkg_loaded(fn, &names);
+  assert(n > 0);
+  assert((size_t)n == names.names.size());
+  bool  foundUs = false;
+  for (size_t i = 0; i < names.names.size(); ++i) {
+    if (names.names[i] == "TestCApi") {
+      foundUs = true;
+#if defined(__linux__)
+      assert(names.images[i].empty());   // the program itself
+#endif
+    }
+  }
+  assert(foundUs);
+
+  auto  stop = [] (const dwm_pkg_info *, dwm_pkg_str, void *) { return 0; };
+  assert(dwm_pkg_loaded(stop, nullptr) == 1);
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  TestParse();
+  TestScanBuffer();
+  TestScanFile();
+  TestLoaded();
+  return 0;
+}
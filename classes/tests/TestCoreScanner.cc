@@ -0,0 +1,251 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  \file TestCoreScanner.cc
+//!  \author Daniel W. McRobb
+//!  \brief Unit tests for Dwm::Pkg::FindCoreLayout() and
+//!    Dwm::Pkg::CoreScanner, using a small synthetic core file
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <stdlib.h>
+  #include <unistd.h>
+}
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "DwmPkgCoreScanner.hh"
+
+static const uint64_t  k_page = 4096;
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+template <typename T>
+static void Put(std::string & s, size_t off, T value)
+{
+  if (s.size() < off + sizeof(T)) {
+    s.resize(off + sizeof(T), '\0');
+  }
+  memcpy(&s[off], &value, sizeof(T));   // little-endian hosts only
+}
+
+//----------------------------------------------------------------------------
+//!  A 64-bit core with an NT_FILE note mapping /lib/libone.so at
+//!  0x10000 (2 pages) and /lib/libtwo.so at 0x20000 (1 page), and three
+//!  PT_LOAD segments:
+//!  - 0x10000, 2 pages, readable: a hit in each page, and one that
+//!    straddles the page boundary
+//!  - 0x20000, 1 page, not readable: a hit we must not see
+//!  - 0x30000, 1 page, readable, anonymous: one hit
+//----------------------------------------------------------------------------
+static std::string MakeCore()
+{
+  std::string  core;
+  core.append("\x7f" "ELF", 4);
+  Put<uint8_t>(core, 4, 2);      // ELFCLASS64
+  Put<uint8_t>(core, 5, 1);      // ELFDATA2LSB
+  Put<uint8_t>(core, 6, 1);
+  Put<uint16_t>(core, 16, 4);    // ET_CORE
+  Put<uint64_t>(core, 0x20, 64);
+  Put<uint16_t>(core, 0x36, 56);
+  Put<uint16_t>(core, 0x38, 4);
+
+  //  NT_FILE note after the program headers.
+  std::string  desc;
+  uint64_t  words[] = { 2, k_page,
+                        0x10000, 0x12000, 0,
+                        0x20000, 0x21000, 3 };
+  desc.append((const char *)words, sizeof(words));
+  desc.append("/lib/libone.so", 15);
+  desc.append("/lib/libtwo.so", 15);
+  std::string  note;
+  Put<uint32_t>(note, 0, 5);
+  Put<uint32_t>(note, 4, desc.size());
+  Put<uint32_t>(note, 8, 0x46494c45);
+  note.append("CORE\0\0\0", 8);
+  note += desc;
+  note.resize((note.size() + 7) & ~7, '\0');
+  size_t  noteOff = 64 + 4 * 56;
+  core.resize(noteOff);
+  core += note;
+
+  struct Load { uint64_t vaddr; uint64_t pages; uint32_t flags; };
+  Load  loads[] = { { 0x10000, 2, 5 }, { 0x20000, 1, 0 },
+                    { 0x30000, 1, 6 } };
+  uint64_t  off = (core.size() + k_page - 1) & ~(k_page - 1);
+  for (int i = 0; i < 4; ++i) {
+    size_t  ph = 64 + i * 56;
+    if (i == 0) {
+      Put<uint32_t>(core, ph, 4);   // PT_NOTE
+      Put<uint64_t>(core, ph + 8, noteOff);
+      Put<uint64_t>(core, ph + 32, note.size());
+      Put<uint64_t>(core, ph + 48, 4);
+      continue;
+    }
+    const Load & load = loads[i - 1];
+    Put<uint32_t>(core, ph, 1);     // PT_LOAD
+    Put<uint32_t>(core, ph + 4, load.flags);
+    Put<uint64_t>(core, ph + 8, off);
+    Put<uint64_t>(core, ph + 16, load.vaddr);
+    Put<uint64_t>(core, ph + 32, load.pages * k_page);
+    Put<uint64_t>(core, ph + 40, load.pages * k_page);
+    Put<uint64_t>(core, ph + 48, k_page);
+    core.resize(off + load.pages * k_page, '\0');
+    off += load.pages * k_page;
+  }
+  auto  putHit = [&] (uint64_t at, const std::string & s) {
+    memcpy(&core[at], s.c_str(), s.size() + 1);
+  };
+  uint64_t  seg1 = (noteOff + note.size() + k_page - 1) & ~(k_page - 1);
+  putHit(seg1 + 100, "@(#) one first page");
+  putHit(seg1 + k_page - 10, "@(#) one straddler");
+  putHit(seg1 + k_page + 100, "@(#) one second page");
+  putHit(seg1 + 2 * k_page + 100, "@(#) two unreadable");
+  putHit(seg1 + 3 * k_page + 100, "@(#) anonymous");
+  return core;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestLayout(const std::string & core)
+{
+  std::vector<Dwm::Pkg::CoreSegment>  segments;
+  std::vector<Dwm::Pkg::CoreMapping>  mappings;
+  assert(Dwm::Pkg::FindCoreLayout(core.data(), core.size(), segments,
+                                  mappings));
+  assert(segments.size() == 3);
+  assert(segments[0].vaddr == 0x10000);
+  assert(segments[0].fileSize == 2 * k_page);
+  assert(segments[1].flags == 0);
+  assert(mappings.size() == 2);
+  assert(mappings[0].path == "/lib/libone.so");
+  assert(mappings[0].end == 0x12000);
+  assert(mappings[1].path == "/lib/libtwo.so");
+  assert(mappings[1].fileOffset == 3 * k_page);
+
+  //  Not a core.
+  std::string  notCore(core);
+  Put<uint16_t>(notCore, 16, 3);   // ET_DYN
+  assert(! Dwm::Pkg::FindCoreLayout(notCore.data(), notCore.size(),
+                                    segments, mappings));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestScan(const std::string & path, unsigned int numThreads)
+{
+  Dwm::Pkg::Scanner      scanner;
+  Dwm::Pkg::CoreScanner  coreScanner(scanner, numThreads, k_page);
+  assert(coreScanner.Open(path));
+  std::mutex  mtx;
+  std::map<std::string,std::string>  hits;   // hit -> mapped file
+  std::map<std::string,uint64_t>     vaddrs;
+  assert(coreScanner.Scan([&] (const Dwm::Pkg::CoreHit & coreHit) {
+    std::lock_guard<std::mutex>  lck(mtx);
+    std::string  hit(coreHit.hit.raw.substr(5));
+    assert(hits.find(hit) == hits.end());
+    hits[hit] = coreHit.mapping ? std::string(coreHit.mapping->path) : "";
+    vaddrs[hit] = coreHit.vaddr;
+    return true;
+  }));
+  assert(hits.size() == 4);
+  assert(hits["one first page"] == "/lib/libone.so");
+  assert(vaddrs["one first page"] == 0x10000 + 100);
+  assert(hits["one straddler"] == "/lib/libone.so");
+  assert(hits["one second page"] == "/lib/libone.so");
+  assert(vaddrs["one second page"] == 0x10000 + k_page + 100);
+  assert(hits["anonymous"] == "");
+  assert(vaddrs["anonymous"] == 0x30000 + 100);
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  The filter's limit applies to the whole scan, not to each window.
+//----------------------------------------------------------------------------
+static void TestLimit(const std::string & path, unsigned int numThreads)
+{
+  for (std::size_t limit : { 1, 2, 3 }) {
+    Dwm::Pkg::ScanFilter  filter;
+    filter.limit = limit;
+    Dwm::Pkg::Scanner      scanner(filter);
+    Dwm::Pkg::CoreScanner  coreScanner(scanner, numThreads, k_page);
+    assert(coreScanner.Open(path));
+    std::atomic<std::size_t>  numHits = 0;
+    assert(coreScanner.Scan([&] (const Dwm::Pkg::CoreHit &) {
+      ++numHits;
+      return true;
+    }));
+    assert(numHits == limit);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  std::string  core = MakeCore();
+  TestLayout(core);
+  
+  char  pathTemplate[] = "/tmp/TestCoreScanner.XXXXXX";
+  int   fd = mkstemp(pathTemplate);
+  assert(fd >= 0);
+  assert(write(fd, core.data(), core.size()) == (ssize_t)core.size());
+  close(fd);
+  TestScan(pathTemplate, 1);
+  TestScan(pathTemplate, 3);
+  TestLimit(pathTemplate, 1);
+  TestLimit(pathTemplate, 3);
+  
+  Dwm::Pkg::Scanner      scanner;
+  Dwm::Pkg::CoreScanner  coreScanner(scanner);
+  assert(! coreScanner.Open("/nonexistent/core"));
+  
+  unlink(pathTemplate);
+  return 0;
+}
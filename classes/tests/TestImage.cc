@@ -0,0 +1,457 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+
+//---------------------------------------------------------------------------
+//!  \file TestImage.cc
+//!  \author Daniel W. McRobb
+//!  \brief Unit tests for Dwm::Pkg::FindDataRanges(), FindBuildId() and
+//!    section-aware scanning, using small synthetic images
+//---------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "DwmPkgImage.hh"
+#include "DwmPkgScanner.hh"
+
+//----------------------------------------------------------------------------
+//!  Builds an image in a string, with fixed endianness.
+//----------------------------------------------------------------------------
+class ImageBuilder
+{
+public:
+  ImageBuilder(bool bigEndian)
+      : _data(), _bigEndian(bigEndian)
+  {}
+
+  template <typename T>
+  void Put(size_t off, T value)
+  {
+    if (_data.size() < off + sizeof(T)) {
+      _data.resize(off + sizeof(T), '\0');
+    }
+    for (size_t i = 0; i < sizeof(T); ++i) {
+      size_t  shift = _bigEndian ? (sizeof(T) - 1 - i) * 8 : i * 8;
+      _data[off + i] = (char)((uint64_t)value >> shift);
+    }
+  }
+
+  void PutBytes(size_t off, const std::string & s)
+  {
+    if (_data.size() < off + s.size()) {
+      _data.resize(off + s.size(), '\0');
+    }
+    _data.replace(off, s.size(), s);
+  }
+
+  //--------------------------------------------------------------------------
+  //!  Appends "@(#) <name>\0" at a 16-byte boundary, returns its offset.
+  //--------------------------------------------------------------------------
+  size_t AddHit(const std::string & name, size_t & len)
+  {
+    size_t  off = (_data.size() + 15) & ~(size_t)15;
+    std::string  s = "@(#) " + name;
+    s += '\0';
+    PutBytes(off, s);
+    len = s.size();
+    return off;
+  }
+  
+  std::string  _data;
+  bool         _bigEndian;
+};
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static std::set<std::string> ScanHits(const std::string & image,
+                                      bool allBytes = false)
+{
+  Dwm::Pkg::ScanFilter  filter;
+  filter.allBytes = allBytes;
+  std::set<std::string>  rc;
+  auto  cb = [&] (const Dwm::Pkg::ScanHit & hit) {
+    assert(image.substr(hit.offset, hit.raw.size()) == hit.raw);
+    rc.insert(std::string(hit.raw.substr(5)));
+    return true;
+  };
+  Dwm::Pkg::Scanner(filter).ScanImage(image.data(), image.size(), cb);
+  return rc;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static std::string MakeElf(bool is64, bool bigEndian)
+{
+  ImageBuilder  b(bigEndian);
+  b.PutBytes(0, "\x7f" "ELF");
+  b.Put<uint8_t>(4, is64 ? 2 : 1);
+  b.Put<uint8_t>(5, bigEndian ? 2 : 1);
+  b.Put<uint8_t>(6, 1);
+  b._data.resize(is64 ? 64 : 52);
+
+  struct Sect { std::string name; uint32_t type; uint64_t flags; };
+  std::vector<Sect>  sects = {
+    { "",           0, 0 },
+    { ".text",      1, 0x6 },
+    { ".rodata",    1, 0x2 },
+    { ".data",      1, 0x3 },
+    { ".comment",   1, 0x30 },
+    { ".debug_str", 1, 0x30 },
+    { ".symtab",    2, 0 },
+    { ".shstrtab",  3, 0 }
+  };
+  std::vector<std::pair<size_t,size_t>>  contents(sects.size());
+  for (size_t i = 1; i < sects.size() - 1; ++i) {
+    contents[i].first = b.AddHit("in " + sects[i].name, contents[i].second);
+  }
+  std::string  strtab(1, '\0');
+  std::vector<uint32_t>  nameOffs;
+  for (const auto & s : sects) {
+    nameOffs.push_back(s.name.empty() ? 0 : strtab.size());
+    if (! s.name.empty()) {
+      strtab += s.name + '\0';
+    }
+  }
+  contents.back().first = b._data.size();
+  contents.back().second = strtab.size();
+  b.PutBytes(b._data.size(), strtab);
+
+  size_t  shoff = (b._data.size() + 7) & ~(size_t)7;
+  size_t  shentsize = is64 ? 64 : 40;
+  for (size_t i = 0; i < sects.size(); ++i) {
+    size_t  sh = shoff + i * shentsize;
+    b.Put<uint32_t>(sh, nameOffs[i]);
+    b.Put<uint32_t>(sh + 4, sects[i].type);
+    if (is64) {
+      b.Put<uint64_t>(sh + 8, sects[i].flags);
+      b.Put<uint64_t>(sh + 24, contents[i].first);
+      b.Put<uint64_t>(sh + 32, contents[i].second);
+      b.Put<uint64_t>(sh + 56, 0);
+    }
+    else {
+      b.Put<uint32_t>(sh + 8, sects[i].flags);
+      b.Put<uint32_t>(sh + 16, contents[i].first);
+      b.Put<uint32_t>(sh + 20, contents[i].second);
+      b.Put<uint32_t>(sh + 36, 0);
+    }
+  }
+  if (is64) {
+    b.Put<uint64_t>(0x28, shoff);
+    b.Put<uint16_t>(0x3a, shentsize);
+    b.Put<uint16_t>(0x3c, sects.size());
+    b.Put<uint16_t>(0x3e, sects.size() - 1);
+  }
+  else {
+    b.Put<uint32_t>(0x20, shoff);
+    b.Put<uint16_t>(0x2e, shentsize);
+    b.Put<uint16_t>(0x30, sects.size());
+    b.Put<uint16_t>(0x32, sects.size() - 1);
+  }
+  return b._data;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestElf()
+{
+  std::set<std::string>  want = {
+    "in .rodata", "in .data", "in .comment"
+  };
+  for (bool is64 : { true, false }) {
+    for (bool bigEndian : { false, true }) {
+      std::string  elf = MakeElf(is64, bigEndian);
+      std::vector<Dwm::Pkg::ImageRange>  ranges;
+      assert(Dwm::Pkg::FindDataRanges(elf.data(), elf.size(), ranges)
+             == Dwm::Pkg::ImageFormat::k_elf);
+      assert(ranges.size() == 3);
+      assert(ranges[0].section == ".rodata");
+      assert(ScanHits(elf) == want);
+      assert(ScanHits(elf, true).size() == 6);
+
+      //  Truncated section headers: not parsed, everything scanned.
+      elf.resize(elf.size() - 10);
+      assert(Dwm::Pkg::FindDataRanges(elf.data(), elf.size(), ranges)
+             == Dwm::Pkg::ImageFormat::k_unknown);
+      assert(ScanHits(elf).size() == 6);
+    }
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  Builds a thin Mach-O image with a __TEXT, __DATA_CONST and __DATA
+//!  segment.
+//----------------------------------------------------------------------------
+static std::string MakeMachO(bool is64, bool bigEndian,
+                             const std::string & tag)
+{
+  ImageBuilder  b(bigEndian);
+  b.Put<uint32_t>(0, is64 ? 0xfeedfacf : 0xfeedface);
+  b.Put<uint32_t>(4, is64 ? 0x01000007 : 7);
+
+  struct Sect { std::string seg; std::string sect; uint32_t flags; };
+  std::vector<std::vector<Sect>>  segs = {
+    { { "__TEXT", "__text", 0x80000400 }, { "__TEXT", "__cstring", 2 },
+      { "__TEXT", "__const", 0 } },
+    { { "__DATA_CONST", "__const", 0 } },
+    { { "__DATA", "__data", 0 }, { "__DATA", "__bss", 1 },
+      { "__DATA", "__objc_x", 0 } }
+  };
+  size_t  hdrSize = is64 ? 32 : 28;
+  size_t  segSize = is64 ? 72 : 56;
+  size_t  sectSize = is64 ? 80 : 68;
+  size_t  cmdsSize = 0;
+  for (const auto & seg : segs) {
+    cmdsSize += segSize + seg.size() * sectSize;
+  }
+  b.Put<uint32_t>(16, segs.size());
+  b.Put<uint32_t>(20, cmdsSize);
+  b._data.resize(hdrSize + cmdsSize);
+
+  size_t  cmdOff = hdrSize;
+  for (const auto & seg : segs) {
+    size_t  cmdSize = segSize + seg.size() * sectSize;
+    b.Put<uint32_t>(cmdOff, is64 ? 0x19 : 0x1);
+    b.Put<uint32_t>(cmdOff + 4, cmdSize);
+    b.PutBytes(cmdOff + 8, seg[0].seg);
+    b.Put<uint32_t>(cmdOff + (is64 ? 64 : 48), seg.size());
+    size_t  sectOff = cmdOff + segSize;
+    for (const auto & sect : seg) {
+      size_t  len, off = b.AddHit(tag + " in " + sect.seg + ","
+                                  + sect.sect, len);
+      b.PutBytes(sectOff, sect.sect);
+      b.PutBytes(sectOff + 16, sect.seg);
+      if (is64) {
+        b.Put<uint64_t>(sectOff + 40, len);
+        b.Put<uint32_t>(sectOff + 48, off);
+        b.Put<uint32_t>(sectOff + 64, sect.flags);
+      }
+      else {
+        b.Put<uint32_t>(sectOff + 36, len);
+        b.Put<uint32_t>(sectOff + 40, off);
+        b.Put<uint32_t>(sectOff + 56, sect.flags);
+      }
+      sectOff += sectSize;
+    }
+    cmdOff += cmdSize;
+  }
+  return b._data;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static std::set<std::string> MachOWant(const std::string & tag)
+{
+  return { tag + " in __TEXT,__cstring", tag + " in __TEXT,__const",
+           tag + " in __DATA_CONST,__const", tag + " in __DATA,__data" };
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestMachO()
+{
+  std::string  macho = MakeMachO(true, false, "arm64");
+  std::vector<Dwm::Pkg::ImageRange>  ranges;
+  assert(Dwm::Pkg::FindDataRanges(macho.data(), macho.size(), ranges)
+         == Dwm::Pkg::ImageFormat::k_machO);
+  assert(ranges.size() == 4);
+  assert(ScanHits(macho) == MachOWant("arm64"));
+  assert(ScanHits(macho, true).size() == 7);
+
+  macho = MakeMachO(false, true, "ppc");
+  assert(ScanHits(macho) == MachOWant("ppc"));
+  
+  //  Fat, with a 64-bit little-endian slice and a 32-bit big-endian one.
+  std::string  slice0 = MakeMachO(true, false, "x86_64");
+  std::string  slice1 = MakeMachO(false, true, "ppc");
+  ImageBuilder  fat(true);
+  fat.Put<uint32_t>(0, 0xcafebabe);
+  fat.Put<uint32_t>(4, 2);
+  fat.Put<uint32_t>(8, 0x01000007);
+  fat.Put<uint32_t>(16, 4096);
+  fat.Put<uint32_t>(20, slice0.size());
+  fat.Put<uint32_t>(28, 18);
+  fat.Put<uint32_t>(36, 8192);
+  fat.Put<uint32_t>(40, slice1.size());
+  fat.PutBytes(4096, slice0);
+  fat.PutBytes(8192, slice1);
+  assert(Dwm::Pkg::FindDataRanges(fat._data.data(), fat._data.size(), ranges)
+         == Dwm::Pkg::ImageFormat::k_machOFat);
+  assert(ranges.size() == 8);
+  assert((ranges[0].slice == 0) && (ranges[7].slice == 1));
+  std::set<std::string>  want = MachOWant("x86_64");
+  want.merge(MachOWant("ppc"));
+  assert(ScanHits(fat._data) == want);
+
+  //  A Java class file has the same magic.
+  std::string  java("\xca\xfe\xba\xbe\x00\x00\x00\x34", 8);
+  java += "@(#) in java";
+  java += '\0';
+  assert(Dwm::Pkg::FindDataRanges(java.data(), java.size(), ranges)
+         == Dwm::Pkg::ImageFormat::k_unknown);
+  assert(ScanHits(java).size() == 1);
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestPe()
+{
+  ImageBuilder  b(false);
+  b.PutBytes(0, "MZ");
+  b.Put<uint32_t>(0x3c, 0x80);
+  b.PutBytes(0x80, std::string("PE\0\0", 4));
+  b.Put<uint16_t>(0x84, 0x8664);
+  std::vector<std::string>  names = { ".text", ".rdata", ".data", ".rsrc" };
+  b.Put<uint16_t>(0x86, names.size());
+  b.Put<uint16_t>(0x94, 0xf0);
+  size_t  sectOff = 0x80 + 24 + 0xf0;
+  b._data.resize(sectOff + names.size() * 40);
+  for (const auto & name : names) {
+    size_t  len, off = b.AddHit("in " + name, len);
+    b.PutBytes(sectOff, name);
+    b.Put<uint32_t>(sectOff + 16, len);
+    b.Put<uint32_t>(sectOff + 20, off);
+    sectOff += 40;
+  }
+  std::vector<Dwm::Pkg::ImageRange>  ranges;
+  assert(Dwm::Pkg::FindDataRanges(b._data.data(), b._data.size(), ranges)
+         == Dwm::Pkg::ImageFormat::k_pe);
+  assert(ScanHits(b._data) == std::set<std::string>({"in .rdata",
+                                                     "in .data",
+                                                     "in .rsrc"}));
+  assert(ScanHits(b._data, true).size() == 4);
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  An ELF header and one PT_NOTE program header whose segment holds an
+//!  NT_GNU_ABI_TAG note followed by an NT_GNU_BUILD_ID note with the
+//!  given @c buildId.
+//----------------------------------------------------------------------------
+static std::string MakeElfWithBuildId(bool is64, bool bigEndian,
+                                      const std::string & buildId)
+{
+  ImageBuilder  b(bigEndian);
+  b.PutBytes(0, "\x7f" "ELF");
+  b.Put<uint8_t>(4, is64 ? 2 : 1);
+  b.Put<uint8_t>(5, bigEndian ? 2 : 1);
+  b.Put<uint8_t>(6, 1);
+  size_t  phoff = is64 ? 64 : 52;
+  size_t  phentsize = is64 ? 56 : 32;
+  size_t  noteOff = phoff + phentsize;
+  
+  size_t  off = noteOff;
+  auto  addNote = [&] (uint32_t type, const std::string & desc) {
+    b.Put<uint32_t>(off, 4);
+    b.Put<uint32_t>(off + 4, desc.size());
+    b.Put<uint32_t>(off + 8, type);
+    b.PutBytes(off + 12, std::string("GNU", 4));
+    b.PutBytes(off + 16, desc);
+    off = (off + 16 + desc.size() + 3) & ~(size_t)3;
+  };
+  addNote(1, std::string(16, '\1'));   // NT_GNU_ABI_TAG
+  addNote(3, buildId);                 // NT_GNU_BUILD_ID
+  b._data.resize(off + 100, '\0');
+  
+  if (is64) {
+    b.Put<uint64_t>(0x20, phoff);
+    b.Put<uint16_t>(0x36, phentsize);
+    b.Put<uint16_t>(0x38, 1);
+    b.Put<uint32_t>(phoff, 4);                 // PT_NOTE
+    b.Put<uint64_t>(phoff + 8, noteOff);
+    b.Put<uint64_t>(phoff + 0x20, off - noteOff);
+    b.Put<uint64_t>(phoff + 0x30, 4);
+  }
+  else {
+    b.Put<uint32_t>(0x1c, phoff);
+    b.Put<uint16_t>(0x2a, phentsize);
+    b.Put<uint16_t>(0x2c, 1);
+    b.Put<uint32_t>(phoff, 4);                 // PT_NOTE
+    b.Put<uint32_t>(phoff + 4, noteOff);
+    b.Put<uint32_t>(phoff + 16, off - noteOff);
+    b.Put<uint32_t>(phoff + 28, 4);
+  }
+  return b._data;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestBuildId()
+{
+  std::string  buildId("\x12\x34\x56\x78\x9a\xbc\xde\xf0\x01\x23"
+                       "\x45\x67\x89\xab\xcd\xef\x00\x11\x22\x33", 20);
+  for (bool is64 : { true, false }) {
+    for (bool bigEndian : { false, true }) {
+      std::string  image = MakeElfWithBuildId(is64, bigEndian, buildId);
+      assert(Dwm::Pkg::FindBuildId(image.data(), image.size()) == buildId);
+      //  Only the start of the file is needed.
+      size_t  headLen = image.size() - 100;
+      assert(Dwm::Pkg::FindBuildId(image.data(), headLen) == buildId);
+      //  ... but all of the note.
+      assert(Dwm::Pkg::FindBuildId(image.data(), headLen - 1).empty());
+      //  No build ID in an image without program headers.
+      std::string  noPhdrs = MakeElf(is64, bigEndian);
+      assert(Dwm::Pkg::FindBuildId(noPhdrs.data(), noPhdrs.size()).empty());
+    }
+  }
+  std::string  notElf(200, 'x');
+  assert(Dwm::Pkg::FindBuildId(notElf.data(), notElf.size()).empty());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  TestElf();
+  TestMachO();
+  TestPe();
+  TestBuildId();
+  return 0;
+}
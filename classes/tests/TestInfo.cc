@@ -42,8 +42,11 @@
 #include <cassert>
 #include <iostream>
 #include <regex>
+#include <type_traits>
+#include <unordered_set>
 
 #include "DwmPkgInfo.hh"
+#include "DwmPkgInfoView.hh"
 
 //----------------------------------------------------------------------------
 //!  
@@ -92,5 +95,75 @@ int main(int argc, char *argv[])
   assert(maininfo1 != g_info1);
   assert(g_info1 < maininfo1);
 
+  //  Field boundaries come from the string alone, so the copyright and
+  //  'other' fields may hold spaces and dates.
+  static constexpr const Dwm::Pkg::Info
+    tricky(DWM_PKG_TYPE_LIB, DWM_PKG_STATUS_REL, "tricky", "2.0.0-rc.1",
+           "Jan  1 2020 Someone", "built Feb 29 2024  " __DATE__);
+  static_assert(tricky.copyright() == "Jan  1 2020 Someone");
+  static_assert(tricky.date() == __DATE__);
+  static_assert(tricky.other() == "built Feb 29 2024  " __DATE__);
+  static_assert(tricky.fields().version == "2.0.0-rc.1");
+
+  //  The type depends only on the total size, not on the field lengths.
+  static constexpr const Dwm::Pkg::Info
+    ab(DWM_PKG_TYPE_LIB, DWM_PKG_STATUS_REL, "ab", "1.0", "", "");
+  static constexpr const Dwm::Pkg::Info
+    abc(DWM_PKG_TYPE_LIB, DWM_PKG_STATUS_REL, "abc", "1.", "", "");
+  static_assert(std::is_same_v<decltype(ab),decltype(abc)>);
+  static_assert(ab.name() == "ab");
+  static_assert(abc.name() == "abc");
+
+  Dwm::Pkg::InfoFields  fields;
+  assert(Dwm::Pkg::SplitInfoString(maininfo1.view(), fields));
+  assert(fields.name == "maininfo1");
+  assert(! Dwm::Pkg::SplitInfoString("@(#) not an info", fields));
+  assert(! Dwm::Pkg::SplitInfoString("", fields));
+  Dwm::Pkg::InfoFields  dataFields;
+  assert(Dwm::Pkg::SplitInfoData(maininfo1.data_view(), dataFields));
+  assert((dataFields.name == "maininfo1")
+         && (dataFields.other == maininfo1.other()));
+  assert(! Dwm::Pkg::SplitInfoData(maininfo1.view(), dataFields));
+
+  //  InfoHash() is XXH64 with seed 0.
+  static_assert(Dwm::Pkg::InfoHash("") == 0xEF46DB3751D8E999ULL);
+  static_assert(Dwm::Pkg::InfoHash("a") == 0xD24EC4F1A98C6E5BULL);
+  static_assert(Dwm::Pkg::InfoHash("abc") == 0x44BC2CF5AD770999ULL);
+  static_assert(Dwm::Pkg::InfoHash("Nobody inspects the spammish repetition")
+                == 0xFBCEA83C8A378BF1ULL);
+
+  //  The compile-time hash of an Info matches the runtime hash of its
+  //  string and of an InfoView parsed from it.
+  constexpr uint64_t  trickyHash = tricky.hash();
+  std::string  trickyStr(tricky.view());
+  assert(Dwm::Pkg::InfoHash(trickyStr) == trickyHash);
+  Dwm::Pkg::InfoView  iv;
+  assert(iv.Parse(trickyStr));
+  assert(iv.id == trickyStr);
+  assert(iv.hash() == trickyHash);
+  assert(std::hash<Dwm::Pkg::InfoView>()(iv)
+         == std::hash<std::remove_cvref_t<decltype(tricky)>>()(tricky));
+  static_assert(ab.hash() != abc.hash());
+  static_assert(ab != abc);
+  static_assert(ab != tricky);
+  static_assert(maininfo1 == maininfo1);
+
+  std::unordered_set<std::string_view,Dwm::Pkg::InfoHasher>  seen;
+  for (int i = 0; i < 3; ++i) {
+    seen.insert(g_info1.view());
+    seen.insert(trickyStr);
+    seen.insert(tricky.view());
+  }
+  assert(seen.size() == 2);
+  
+  std::unordered_set<Dwm::Pkg::InfoView>  views;
+  Dwm::Pkg::InfoView  iv2;
+  assert(iv2.Parse(maininfo1.view()));
+  views.insert(iv);
+  views.insert(iv2);
+  assert(iv.Parse(tricky.view()));
+  views.insert(iv);
+  assert(views.size() == 2);
+  
   return 0;
 }
@@ -0,0 +1,140 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+
+//---------------------------------------------------------------------------
+//!  \file TestInfoLayout.cc
+//!  \author Daniel W. McRobb
+//!  \brief Checks the size of Dwm::Pkg::Info objects, at compile time and
+//!    as emitted in this executable
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <elf.h>
+}
+
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+
+#include "DwmPkgInfo.hh"
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+inline constexpr const Dwm::Pkg::Info __attribute__((used))
+g_layout1(DWM_PKG_TYPE_LIB, DWM_PKG_STATUS_REL, "g_layout1", "1.2.3",
+          "Daniel McRobb " DWM_PKG_SYM_GHOST, "mcplex.net");
+
+inline constexpr const Dwm::Pkg::Info __attribute__((used))
+g_layout2(DWM_PKG_TYPE_EXE, DWM_PKG_STATUS_DEV, "g_layout2", "10.20.30",
+          "Daniel McRobb", "");
+
+inline constexpr const Dwm::Pkg::Info __attribute__((used))
+g_layout3(DWM_PKG_TYPE_HDR, DWM_PKG_STATUS_RC, "x", "0", "", "");
+
+//  An Info is its characters and nothing else.
+static_assert(sizeof(g_layout1) == g_layout1.view().size() + 1);
+static_assert(sizeof(g_layout2) == g_layout2.view().size() + 1);
+static_assert(sizeof(g_layout3) == g_layout3.view().size() + 1);
+static_assert(alignof(decltype(g_layout1)) == 1);
+static_assert(sizeof(Dwm::Pkg::info) == Dwm::Pkg::info.view().size() + 1);
+
+//----------------------------------------------------------------------------
+//!  Returns the sizes of the g_layout* symbols in the ELF symbol table of
+//!  this executable, or an empty map if we can't read it.
+//----------------------------------------------------------------------------
+static std::map<std::string,size_t> EmittedSizes()
+{
+  std::map<std::string,size_t>  rc;
+#if defined(__linux__) && defined(__LP64__)
+  std::ifstream  is("/proc/self/exe", std::ios::binary);
+  std::string    image((std::istreambuf_iterator<char>(is)),
+                       std::istreambuf_iterator<char>());
+  if (image.size() < sizeof(Elf64_Ehdr)) {
+    return rc;
+  }
+  const char  *data = image.data();
+  Elf64_Ehdr   ehdr;
+  memcpy(&ehdr, data, sizeof(ehdr));
+  for (int i = 0; i < ehdr.e_shnum; ++i) {
+    Elf64_Shdr  symtab, strtab;
+    memcpy(&symtab, data + ehdr.e_shoff + i * ehdr.e_shentsize,
+           sizeof(symtab));
+    if (symtab.sh_type != SHT_SYMTAB) {
+      continue;
+    }
+    memcpy(&strtab, data + ehdr.e_shoff + symtab.sh_link * ehdr.e_shentsize,
+           sizeof(strtab));
+    for (size_t off = 0; off < symtab.sh_size; off += sizeof(Elf64_Sym)) {
+      Elf64_Sym  sym;
+      memcpy(&sym, data + symtab.sh_offset + off, sizeof(sym));
+      std::string  name(data + strtab.sh_offset + sym.st_name);
+      if (name.starts_with("g_layout")) {
+        rc[name] = sym.st_size;
+      }
+    }
+  }
+#endif
+  return rc;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  assert(g_layout1.name() == "g_layout1");
+  assert(g_layout2.version() == "10.20.30");
+  assert(g_layout3.other() == "");
+  
+  auto  sizes = EmittedSizes();
+  if (sizes.empty()) {
+    std::cerr << "No symbol table, skipping emitted size checks\n";
+    return 0;
+  }
+  assert(sizes.size() == 3);
+  assert(sizes["g_layout1"] == sizeof(g_layout1));
+  assert(sizes["g_layout2"] == sizeof(g_layout2));
+  assert(sizes["g_layout3"] == sizeof(g_layout3));
+  for (const auto & sz : sizes) {
+    std::cout << sz.first << ": " << sz.second << " bytes\n";
+  }
+  return 0;
+}
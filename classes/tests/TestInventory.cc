@@ -0,0 +1,176 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  \file TestInventory.cc
+//!  \author Daniel W. McRobb
+//!  \brief Unit tests for the dwmwhat DwmWhat::StringTable and
+//!    DwmWhat::Inventory
+//---------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../apps/dwmwhat/DwmWhatInventory.hh"
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestStringTable()
+{
+  DwmWhat::StringTable  table(2);
+  assert(table.Size() == 0);
+  assert(table.ArenaBytes() == 0);
+
+  //  An empty string in a fresh table needs no arena.
+  uint32_t  empty = table.Intern("");
+  assert(table.Get(empty).empty());
+  assert(table.Intern("") == empty);
+  assert(table.Size() == 1);
+
+  uint32_t  a = table.Intern("@(#) a");
+  uint32_t  b = table.Intern("@(#) b");
+  assert(a != b);
+  assert(table.Intern(std::string("@(#) a")) == a);
+  assert(table.Get(a) == "@(#) a");
+  assert(table.Get(b) == "@(#) b");
+  assert(table.Size() == 3);
+
+  //  Ids are stable and views stay valid as shards grow, including
+  //  strings too big to share a block.
+  std::string_view  aView = table.Get(a);
+  std::vector<uint32_t>  ids;
+  for (int i = 0; i < 5000; ++i) {
+    ids.push_back(table.Intern("@(#) string " + std::to_string(i)));
+  }
+  std::string  big(40000, 'x');
+  uint32_t     bigId = table.Intern(big);
+  assert(table.Get(bigId) == big);
+  assert(table.Get(a).data() == aView.data());
+  for (int i = 0; i < 5000; ++i) {
+    assert(table.Get(ids[i]) == "@(#) string " + std::to_string(i));
+  }
+  assert(table.Size() == 5004);
+  assert(table.ArenaBytes() >= big.size());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  Threads interning the same strings get the same ids, and each
+//!  string is stored once no matter how many shards are involved.
+//----------------------------------------------------------------------------
+static void TestConcurrentIntern()
+{
+  DwmWhat::StringTable  table;
+  const int  numThreads = 4, numStrings = 2000;
+  std::vector<std::vector<uint32_t>>  ids(numThreads);
+  std::vector<std::thread>  threads;
+  for (int t = 0; t < numThreads; ++t) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < numStrings; ++i) {
+        int  n = (t & 1) ? (numStrings - 1 - i) : i;
+        ids[t].push_back(table.Intern("@(#) s" + std::to_string(n)));
+      }
+      if (t & 1) {
+        std::reverse(ids[t].begin(), ids[t].end());
+      }
+    });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  for (int t = 1; t < numThreads; ++t) {
+    assert(ids[t] == ids[0]);
+  }
+  assert(table.Size() == numStrings);
+  std::set<uint32_t>  unique(ids[0].begin(), ids[0].end());
+  assert(unique.size() == numStrings);
+  std::set<uint32_t>  shards;
+  for (auto id : ids[0]) {
+    shards.insert(id & 63);
+  }
+  assert(shards.size() > 1);
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestInventory()
+{
+  DwmWhat::Inventory  inventory(4);
+  assert(inventory.NumFiles() == 4);
+  inventory.Add(0, "@(#) one");
+  inventory.Add(0, "@(#) two");
+  inventory.Add(0, "@(#) one");
+  inventory.FinishFile(0);
+  inventory.Add(1, "@(#) two");
+  inventory.FinishFile(1);
+  inventory.FinishFile(2);
+  inventory.CopyFile(0, 3);
+
+  assert(inventory.FileHits(0).size() == 2);
+  assert(inventory.FileHits(1).size() == 1);
+  assert(inventory.FileHits(2).empty());
+  assert(inventory.FileHits(3) == inventory.FileHits(0));
+  assert(inventory.Strings().Size() == 2);
+
+  std::map<std::string,std::vector<uint32_t>>  unique;
+  inventory.ForEachUnique([&] (std::string_view s,
+                               const std::vector<uint32_t> & files) {
+    assert(unique.find(std::string(s)) == unique.end());
+    unique[std::string(s)] = files;
+  });
+  assert(unique.size() == 2);
+  assert((unique["@(#) one"] == std::vector<uint32_t>{0, 3}));
+  assert((unique["@(#) two"] == std::vector<uint32_t>{0, 1, 3}));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  TestStringTable();
+  TestConcurrentIntern();
+  TestInventory();
+  return 0;
+}
@@ -0,0 +1,354 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  \file TestJournal.cc
+//!  \author Daniel W. McRobb
+//!  \brief Unit tests for DwmWhat::Journal, and for dwmwhat's --deadline
+//!    and --resume
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <sys/stat.h>
+  #include <sys/wait.h>
+  #include <stdlib.h>
+  #include <unistd.h>
+}
+
+#include <cassert>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "../../apps/dwmwhat/DwmWhatJournal.hh"
+
+static const uint64_t  k_key = 0x1234567890abcdefULL;
+static const size_t    k_numFiles = 10;
+
+//----------------------------------------------------------------------------
+//!  Returns the hit we give the file at @c fileIdx.
+//----------------------------------------------------------------------------
+static std::string Hit(size_t fileIdx)
+{
+  return "@(#) file " + std::to_string(fileIdx);
+}
+
+//----------------------------------------------------------------------------
+//!  Finishes the files in @c fileIdxs, each with its Hit().
+//----------------------------------------------------------------------------
+static void Finish(DwmWhat::Inventory & inventory, DwmWhat::Journal & journal,
+                   const std::vector<uint32_t> & fileIdxs)
+{
+  for (auto fileIdx : fileIdxs) {
+    inventory.Add(fileIdx, Hit(fileIdx));
+    inventory.FinishFile(fileIdx);
+    journal.FinishFile(fileIdx);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  Resumes the journal at @c path and checks that exactly the files in
+//!  @c fileIdxs were read from it, with their hits.
+//----------------------------------------------------------------------------
+static void CheckResume(const std::string & path,
+                        const std::set<uint32_t> & fileIdxs)
+{
+  DwmWhat::Inventory  inventory(k_numFiles);
+  DwmWhat::Journal    journal(inventory, k_key);
+  assert(journal.Open(path, true));
+  assert(journal.NumResumed() == fileIdxs.size());
+  assert(journal.NumFinished() == fileIdxs.size());
+  uint32_t  cursor = 0;
+  while (fileIdxs.count(cursor)) {
+    ++cursor;
+  }
+  assert(journal.Cursor() == cursor);
+  for (uint32_t fileIdx = 0; fileIdx < k_numFiles; ++fileIdx) {
+    assert(journal.IsFinished(fileIdx) == (fileIdxs.count(fileIdx) == 1));
+    const auto  & hits = inventory.FileHits(fileIdx);
+    if (fileIdxs.count(fileIdx)) {
+      assert(hits.size() == 1);
+      assert(inventory.Strings().Get(hits[0]) == Hit(fileIdx));
+    }
+    else {
+      assert(hits.empty());
+    }
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  Returns the size of the file at @c path.
+//----------------------------------------------------------------------------
+static off_t FileSize(const std::string & path)
+{
+  struct stat  statbuf;
+  assert(stat(path.c_str(), &statbuf) == 0);
+  return statbuf.st_size;
+}
+
+//----------------------------------------------------------------------------
+//!  Resuming needs a journal, from a scan of the same number of files
+//!  with the same key.
+//----------------------------------------------------------------------------
+static void TestMissing(const std::string & dir)
+{
+  std::string  path(dir + "/missing");
+  {
+    DwmWhat::Inventory  inventory(k_numFiles);
+    DwmWhat::Journal    journal(inventory, k_key);
+    assert(! journal.Open(path, true));
+    assert(access(path.c_str(), F_OK) != 0);
+    assert(journal.Open(path, false));
+    Finish(inventory, journal, {0});
+  }
+  {
+    DwmWhat::Inventory  inventory(k_numFiles);
+    DwmWhat::Journal    journal(inventory, k_key + 1);
+    assert(! journal.Open(path, true));
+  }
+  {
+    DwmWhat::Inventory  inventory(k_numFiles + 1);
+    DwmWhat::Journal    journal(inventory, k_key);
+    assert(! journal.Open(path, true));
+  }
+  CheckResume(path, {0});
+  unlink(path.c_str());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  A partial run is resumed and finished, and a finished journal
+//!  resumes with everything.
+//----------------------------------------------------------------------------
+static void TestResume(const std::string & dir)
+{
+  std::string  path(dir + "/resume");
+  {
+    DwmWhat::Inventory  inventory(k_numFiles);
+    DwmWhat::Journal    journal(inventory, k_key);
+    assert(journal.Open(path, false));
+    Finish(inventory, journal, {0, 1, 3});
+    assert(journal.Flush());
+    Finish(inventory, journal, {7});
+    //  Destruction flushes.
+  }
+  CheckResume(path, {0, 1, 3, 7});
+  {
+    DwmWhat::Inventory  inventory(k_numFiles);
+    DwmWhat::Journal    journal(inventory, k_key);
+    assert(journal.Open(path, true));
+    std::vector<uint32_t>  rest;
+    for (uint32_t fileIdx = journal.Cursor(); fileIdx < k_numFiles;
+         ++fileIdx) {
+      if (! journal.IsFinished(fileIdx)) {
+        rest.push_back(fileIdx);
+      }
+    }
+    assert(rest == std::vector<uint32_t>({2, 4, 5, 6, 8, 9}));
+    Finish(inventory, journal, rest);
+    assert(journal.Flush());
+    assert(journal.Cursor() == k_numFiles);
+  }
+  CheckResume(path, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+
+  //  Starting over (not resuming) throws away what was there.
+  {
+    DwmWhat::Inventory  inventory(k_numFiles);
+    DwmWhat::Journal    journal(inventory, k_key);
+    assert(journal.Open(path, false));
+  }
+  CheckResume(path, {});
+  unlink(path.c_str());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  A torn or corrupt last chunk (from a crash mid-write) is dropped and
+//!  cut off, and new chunks go where it was.
+//----------------------------------------------------------------------------
+static void TestTruncated(const std::string & dir)
+{
+  std::string  path(dir + "/truncated");
+  off_t        goodSize, fullSize;
+  {
+    DwmWhat::Inventory  inventory(k_numFiles);
+    DwmWhat::Journal    journal(inventory, k_key);
+    assert(journal.Open(path, false));
+    Finish(inventory, journal, {0, 1});
+    assert(journal.Flush());
+    goodSize = FileSize(path);
+    Finish(inventory, journal, {2, 3});
+    assert(journal.Flush());
+    fullSize = FileSize(path);
+  }
+  assert(fullSize > goodSize);
+
+  //  Torn: the last chunk is missing its last few bytes.
+  assert(truncate(path.c_str(), fullSize - 3) == 0);
+  CheckResume(path, {0, 1});
+  assert(FileSize(path) == goodSize);
+
+  //  Resume and finish file 2 again.
+  {
+    DwmWhat::Inventory  inventory(k_numFiles);
+    DwmWhat::Journal    journal(inventory, k_key);
+    assert(journal.Open(path, true));
+    Finish(inventory, journal, {2});
+  }
+  CheckResume(path, {0, 1, 2});
+  fullSize = FileSize(path);
+  
+  //  Corrupt: the last chunk is all there, but a byte of it is wrong.
+  {
+    std::fstream  fs(path, std::ios::in|std::ios::out|std::ios::binary);
+    fs.seekp(fullSize - 1);
+    fs.put('?');
+  }
+  CheckResume(path, {0, 1});
+  assert(FileSize(path) == goodSize);
+
+  //  Only the header survived.
+  assert(truncate(path.c_str(), sizeof(DwmWhat::JournalHeader) + 5) == 0);
+  CheckResume(path, {});
+  assert(FileSize(path) == sizeof(DwmWhat::JournalHeader));
+
+  //  Not even that.
+  assert(truncate(path.c_str(), sizeof(DwmWhat::JournalHeader) - 1) == 0);
+  {
+    DwmWhat::Inventory  inventory(k_numFiles);
+    DwmWhat::Journal    journal(inventory, k_key);
+    assert(! journal.Open(path, true));
+  }
+  unlink(path.c_str());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  Returns the path of @c relPath, relative to the top of this source
+//!  tree.
+//----------------------------------------------------------------------------
+static std::string TreePath(const std::string & relPath)
+{
+  std::string  path(__FILE__);
+  auto  slash = path.find_last_of('/');
+  path = ((slash == std::string::npos)
+          ? std::string(".") : path.substr(0, slash));
+  return path + "/../../" + relPath;
+}
+
+//----------------------------------------------------------------------------
+//!  Runs the shell command @c cmd and returns its exit status.
+//----------------------------------------------------------------------------
+static int Run(const std::string & cmd)
+{
+  int  status = system(cmd.c_str());
+  assert(WIFEXITED(status));
+  return WEXITSTATUS(status);
+}
+
+//----------------------------------------------------------------------------
+//!  dwmwhat with a deadline that's already passed stops starting files
+//!  after the first one finishes, exits 3 and leaves a journal that
+//!  --resume finishes from.
+//----------------------------------------------------------------------------
+static void TestDeadline(const std::string & dir)
+{
+  std::string  dwmwhat(TreePath("apps/dwmwhat/dwmwhat"));
+  if (access(dwmwhat.c_str(), X_OK) != 0) {
+    std::cout << "skipped deadline (no dwmwhat)\n";
+    return;
+  }
+  const size_t   numFiles = 200;
+  std::string    listPath(dir + "/list");
+  std::ofstream  list(listPath);
+  for (size_t i = 0; i < numFiles; ++i) {
+    std::string    path(dir + "/f" + std::to_string(i));
+    std::ofstream  os(path, std::ios::binary);
+    std::string    hit(Hit(i));
+    os.write(hit.c_str(), hit.size() + 1);
+    list << path << '\n';
+  }
+  list.close();
+
+  std::string  cmd(dwmwhat + " -a -t 1 --checkpoint " + dir + "/journal"
+                   + " --files-from " + listPath);
+  std::string  outPath(dir + "/out");
+  assert(Run(cmd + " --deadline 0 > " + outPath + " 2>/dev/null") == 3);
+  assert(Run(cmd + " --resume > " + outPath + " 2>/dev/null") == 0);
+
+  //  Every string was found, once.
+  std::ifstream  is(outPath);
+  std::string    line;
+  std::set<std::string>  found;
+  while (std::getline(is, line)) {
+    if ((! line.empty()) && (line[0] != ' ')) {
+      assert(found.insert(line).second);
+    }
+  }
+  assert(found.size() == numFiles);
+  assert(found.count("file 0 (1)") && found.count("file 199 (1)"));
+
+  //  Resuming a journal that isn't there fails.
+  assert(Run(dwmwhat + " -a --checkpoint " + dir + "/nojournal --resume "
+             + listPath + " > /dev/null 2>&1") == 1);
+  
+  for (size_t i = 0; i < numFiles; ++i) {
+    unlink((dir + "/f" + std::to_string(i)).c_str());
+  }
+  unlink(listPath.c_str());
+  unlink(outPath.c_str());
+  unlink((dir + "/journal").c_str());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  char  dirTemplate[] = "/tmp/TestJournal.XXXXXX";
+  assert(mkdtemp(dirTemplate));
+  std::string  dir(dirTemplate);
+  TestMissing(dir);
+  TestResume(dir);
+  TestTruncated(dir);
+  TestDeadline(dir);
+  rmdir(dir.c_str());
+  return 0;
+}
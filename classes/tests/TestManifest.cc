@@ -0,0 +1,210 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  \file TestManifest.cc
+//!  \author Daniel W. McRobb
+//!  \brief Unit tests for published package manifests
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <sys/wait.h>
+  #include <stdlib.h>
+  #include <unistd.h>
+}
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "DwmPkgInfo.hh"
+#include "DwmPkgManifest.hh"
+
+namespace TestManifest {
+  inline constexpr const Dwm::Pkg::Info __attribute__((used))
+  info(DWM_PKG_TYPE_EXE, DWM_PKG_STATUS_DEV, "TestManifest", "1.2.3",
+       "Daniel McRobb", "test");
+}
+
+//----------------------------------------------------------------------------
+//!  Returns the manifests in @c dir, keyed by pid.
+//----------------------------------------------------------------------------
+static std::vector<std::pair<pid_t,std::vector<std::string>>>
+Collect(const std::string & dir)
+{
+  std::vector<std::pair<pid_t,std::vector<std::string>>>  rc;
+  Dwm::Pkg::CollectManifests(dir, [&] (const Dwm::Pkg::Manifest & m) {
+    assert(m.Program() == "TestManifest");
+    assert(m.Published() > 0);
+    std::vector<std::string>  pkgs(m.Packages().begin(),
+                                   m.Packages().end());
+    rc.push_back({m.Pid(), pkgs});
+    return true;
+  });
+  return rc;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static bool Contains(const std::vector<std::string> & pkgs,
+                     std::string_view pkg)
+{
+  return (std::find(pkgs.begin(), pkgs.end(), pkg) != pkgs.end());
+}
+
+//----------------------------------------------------------------------------
+//!  A child publishes and then dies without cleaning up.  Its manifest
+//!  is collected while it's alive and skipped after it's gone.
+//----------------------------------------------------------------------------
+static void TestChild(const std::string & dir)
+{
+  int  toParent[2], toChild[2];
+  assert(pipe(toParent) == 0);
+  assert(pipe(toChild) == 0);
+  pid_t  pid = fork();
+  assert(pid >= 0);
+  if (0 == pid) {
+    close(toChild[1]);   // so we see EOF if the parent dies
+    char  c = Dwm::Pkg::PublishManifest(dir) ? 'y' : 'n';
+    (void)! write(toParent[1], &c, 1);
+    (void)! read(toChild[0], &c, 1);
+    _exit(0);
+  }
+  char  c;
+  assert(read(toParent[0], &c, 1) == 1);
+  assert(c == 'y');
+  
+  auto  manifests = Collect(dir);
+  assert(manifests.size() == 1);
+  assert(manifests[0].first == pid);
+  assert(Contains(manifests[0].second, TestManifest::info.view()));
+  assert(Contains(manifests[0].second, Dwm::Pkg::info.view()));
+  assert(std::is_sorted(manifests[0].second.begin(),
+                        manifests[0].second.end()));
+
+  assert(write(toChild[1], &c, 1) == 1);
+  int  status;
+  assert(waitpid(pid, &status, 0) == pid);
+  std::string  path(dir + "/dwmpkg." + std::to_string(pid));
+  assert(access(path.c_str(), F_OK) == 0);
+  assert(Collect(dir).empty());
+  unlink(path.c_str());
+  for (int fd : { toParent[0], toParent[1], toChild[0], toChild[1] }) {
+    close(fd);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestSelf(const std::string & dir)
+{
+  std::string  path(dir + "/dwmpkg." + std::to_string(getpid()));
+  {
+    Dwm::Pkg::ManifestPublisher  publisher(dir);
+    assert(publisher.Published());
+    assert(access(path.c_str(), F_OK) == 0);
+    //  Republishing replaces the manifest.
+    assert(Dwm::Pkg::PublishManifest(dir));
+#if defined(F_OFD_SETLK)
+    //  Collecting our own manifest doesn't drop our lock on it.
+    assert(Collect(dir).size() == 1);
+    assert(Collect(dir).size() == 1);
+#endif
+  }
+  assert(access(path.c_str(), F_OK) != 0);
+  assert(Collect(dir).empty());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestParse()
+{
+  Dwm::Pkg::ManifestHeader  hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  memcpy(hdr.magic, Dwm::Pkg::k_manifestMagic, sizeof(hdr.magic));
+  hdr.version = Dwm::Pkg::k_manifestVersion;
+  hdr.headerSize = sizeof(hdr);
+  hdr.pid = 42;
+  hdr.numStrings = 3;
+  std::string  s((const char *)&hdr, sizeof(hdr));
+  s.append("prog\0@(#) a\0@(#) b\0", 19);
+  hdr.totalSize = s.size();
+  memcpy(s.data(), &hdr, sizeof(hdr));
+
+  Dwm::Pkg::Manifest  m;
+  assert(m.Parse(s.data(), s.size()));
+  assert(m.Pid() == 42);
+  assert(m.Program() == "prog");
+  assert(m.Packages().size() == 2);
+  assert(m.Packages()[1] == "@(#) b");
+
+  //  Truncated, unterminated, wrong count, bad magic.
+  assert(! m.Parse(s.data(), s.size() - 1));
+  assert(! m.Parse(s.data(), sizeof(hdr) - 1));
+  std::string  bad(s);
+  bad.back() = 'x';
+  assert(! m.Parse(bad.data(), bad.size()));
+  bad = s;
+  bad[offsetof(Dwm::Pkg::ManifestHeader, numStrings)] = 4;
+  assert(! m.Parse(bad.data(), bad.size()));
+  bad = s;
+  bad[0] = 'X';
+  assert(! m.Parse(bad.data(), bad.size()));
+  assert(m.Packages().empty());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  TestParse();
+  
+  char  dirTemplate[] = "/tmp/TestManifest.XXXXXX";
+  assert(mkdtemp(dirTemplate));
+  std::string  dir(dirTemplate);
+  TestChild(dir);
+  TestSelf(dir);
+  rmdir(dirTemplate);
+  return 0;
+}
@@ -0,0 +1,140 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  \file TestPackageIndex.cc
+//!  \author Daniel W. McRobb
+//!  \brief Unit tests for Dwm::Pkg::PackageIndex and Dwm::Pkg::find()
+//---------------------------------------------------------------------------
+
+#include <cassert>
+#include <string>
+
+#include "DwmPkgInfo.hh"
+
+namespace TestPkgs {
+  inline constexpr const Dwm::Pkg::Info
+  alpha(DWM_PKG_TYPE_LIB, DWM_PKG_STATUS_REL, "alpha", "1.2.3", "me", "");
+  inline constexpr const Dwm::Pkg::Info
+  alphaOld(DWM_PKG_TYPE_LIB, DWM_PKG_STATUS_REL, "alpha", "1.2.10-rc.1",
+           "me", "");
+  inline constexpr const Dwm::Pkg::Info
+  beta(DWM_PKG_TYPE_EXE, DWM_PKG_STATUS_DEV, "beta", "0.0.1", "you", "b");
+}
+
+#define DWM_PKG_FIND_LIST \
+  ::Dwm::Pkg::info, ::TestPkgs::alpha, ::TestPkgs::alphaOld, ::TestPkgs::beta
+
+#include "DwmPkg.hh"
+
+#define MK_INFO(n)                                                       \
+  inline constexpr const Dwm::Pkg::Info                                  \
+  pkg##n(DWM_PKG_TYPE_HDR, DWM_PKG_STATUS_RC, "pkg" #n, "1." #n, "", "");
+#define MK_INFO10(n)                                                     \
+  MK_INFO(n##0) MK_INFO(n##1) MK_INFO(n##2) MK_INFO(n##3) MK_INFO(n##4)  \
+  MK_INFO(n##5) MK_INFO(n##6) MK_INFO(n##7) MK_INFO(n##8) MK_INFO(n##9)
+
+namespace ManyPkgs {
+  MK_INFO10(1) MK_INFO10(2) MK_INFO10(3) MK_INFO10(4) MK_INFO10(5)
+  MK_INFO10(6)
+}
+
+#define LIST_INFO10(n)                                                    \
+  ManyPkgs::pkg##n##0, ManyPkgs::pkg##n##1, ManyPkgs::pkg##n##2,          \
+  ManyPkgs::pkg##n##3, ManyPkgs::pkg##n##4, ManyPkgs::pkg##n##5,          \
+  ManyPkgs::pkg##n##6, ManyPkgs::pkg##n##7, ManyPkgs::pkg##n##8,          \
+  ManyPkgs::pkg##n##9
+
+//  find() is usable at compile time.
+static_assert(Dwm::Pkg::find("libDwmPkg")->name == "libDwmPkg");
+static_assert(Dwm::Pkg::find("beta")->other == "b");
+static_assert(Dwm::Pkg::find("gamma") == nullptr);
+static_assert(Dwm::Pkg::g_packageIndex.size() == 3);
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestFind()
+{
+  const Dwm::Pkg::InfoFields  *pkg = Dwm::Pkg::find("libDwmPkg");
+  assert(pkg);
+  assert(pkg->version == Dwm::Pkg::info.version());
+  //  Of two packages with the same name, the greater version wins.
+  pkg = Dwm::Pkg::find("alpha");
+  assert(pkg && (pkg->version == "1.2.10-rc.1"));
+  pkg = Dwm::Pkg::find("beta");
+  assert(pkg && (pkg->type == DWM_PKG_TYPE_EXE));
+  assert(! Dwm::Pkg::find(""));
+  assert(! Dwm::Pkg::find("alph"));
+  assert(! Dwm::Pkg::find("alphaa"));
+  assert(! Dwm::Pkg::find(std::string("libDwmPkg\0", 10)));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestMany()
+{
+  static constexpr auto  idx =
+    Dwm::Pkg::make_package_index(LIST_INFO10(1), LIST_INFO10(2),
+                                 LIST_INFO10(3), LIST_INFO10(4),
+                                 LIST_INFO10(5), LIST_INFO10(6));
+  static_assert(idx.size() == 60);
+  for (const auto & entry : idx.entries()) {
+    const Dwm::Pkg::InfoFields  *pkg = idx.find(entry.name);
+    assert(pkg == &entry);
+    std::string  missing(entry.name);
+    missing += 'x';
+    assert(! idx.find(missing));
+  }
+  assert(idx.find("pkg42")->version == "1.42");
+  assert(! idx.find("pkg70"));
+  
+  static constexpr auto  empty = Dwm::Pkg::make_package_index();
+  assert(empty.size() == 0);
+  assert(! empty.find("pkg10"));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  TestFind();
+  TestMany();
+  return 0;
+}
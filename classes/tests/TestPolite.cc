@@ -0,0 +1,165 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  \file TestPolite.cc
+//!  \author Daniel W. McRobb
+//!  \brief Unit tests for Dwm::Pkg::Polite and Dwm::Pkg::PageCacheGuard
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <sys/mman.h>
+  #include <fcntl.h>
+  #include <stdlib.h>
+  #include <unistd.h>
+}
+
+#include <cassert>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "DwmPkgScanner.hh"
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestTokenBucket()
+{
+  //  No limit: never sleeps.
+  Dwm::Pkg::Polite  unlimited(0, false);
+  unlimited.Take(1ULL << 40);
+  assert(unlimited.BytesTaken() == (1ULL << 40));
+  assert(unlimited.NumThrottled() == 0);
+
+  //  10 MiB/s with a 1 MiB bucket: 4 MiB from 2 threads takes at least
+  //  0.3 seconds (the first 1 MiB is free).
+  Dwm::Pkg::Polite  polite(10 * 1024 * 1024, false, 1024 * 1024);
+  auto  start = std::chrono::steady_clock::now();
+  auto  take = [&] () {
+    for (int i = 0; i < 8; ++i) {
+      polite.Take(256 * 1024);
+    }
+  };
+  std::thread  t(take);
+  take();
+  t.join();
+  auto  elapsed = std::chrono::steady_clock::now() - start;
+  assert(elapsed >= std::chrono::milliseconds(290));
+  assert(elapsed < std::chrono::seconds(2));
+  assert(polite.BytesTaken() == (4 * 1024 * 1024));
+  assert(polite.NumThrottled() > 0);
+  assert(polite.ThrottledNsecs() >= 290000000);
+  return;
+}
+
+#if defined(__linux__)
+//----------------------------------------------------------------------------
+//!  Returns the number of pages of the @c len bytes of @c fd that are in
+//!  the page cache.
+//----------------------------------------------------------------------------
+static size_t NumResident(int fd, size_t len)
+{
+  size_t  pageSize = sysconf(_SC_PAGESIZE);
+  void  *p = mmap(nullptr, len, PROT_READ, MAP_SHARED, fd, 0);
+  assert(p != MAP_FAILED);
+  std::vector<unsigned char>  vec((len + pageSize - 1) / pageSize);
+  assert(mincore(p, len, vec.data()) == 0);
+  munmap(p, len);
+  size_t  rc = 0;
+  for (auto v : vec) {
+    rc += (v & 1);
+  }
+  return rc;
+}
+
+//----------------------------------------------------------------------------
+//!  Scans a file politely with and without its first half cached.
+//----------------------------------------------------------------------------
+static void TestPageCacheGuard()
+{
+  char  pathTemplate[] = "/tmp/TestPolite.XXXXXX";
+  int   fd = mkstemp(pathTemplate);
+  assert(fd >= 0);
+  size_t       pageSize = sysconf(_SC_PAGESIZE);
+  size_t       len = 64 * pageSize;
+  std::string  data(len, 'x');
+  data.replace(len / 2, 13, std::string("@(#) found it", 13));
+  assert(write(fd, data.data(), len) == (ssize_t)len);
+  fsync(fd);
+
+  Dwm::Pkg::Polite   polite(0, true);
+  Dwm::Pkg::Scanner  scanner;
+  scanner.SetPolite(&polite);
+  size_t  numHits = 0;
+  auto    cb = [&] (const Dwm::Pkg::ScanHit &) { ++numHits; return true; };
+
+  //  Nothing cached: nothing left cached.
+  posix_fadvise(fd, 0, len, POSIX_FADV_DONTNEED);
+  assert(NumResident(fd, len) == 0);
+  assert(scanner.ScanFd(fd, cb));
+  assert(numHits == 1);
+  assert(NumResident(fd, len) == 0);
+  assert(polite.PagesDropped() == 64);
+  assert(polite.PagesKept() == 0);
+  
+  //  First half cached: it stays cached, the rest doesn't.
+  std::vector<char>  buf(len / 2);
+  assert(pread(fd, buf.data(), len / 2, 0) == (ssize_t)(len / 2));
+  size_t  resident = NumResident(fd, len);
+  assert(resident >= 32);
+  assert(scanner.ScanFd(fd, cb));
+  assert(numHits == 2);
+  assert(NumResident(fd, len) == resident);
+  assert(polite.PagesKept() == resident);
+  
+  close(fd);
+  unlink(pathTemplate);
+  return;
+}
+#endif
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  TestTokenBucket();
+#if defined(__linux__)
+  TestPageCacheGuard();
+#endif
+  return 0;
+}
@@ -0,0 +1,398 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+
+//---------------------------------------------------------------------------
+//!  \file TestScanner.cc
+//!  \author Daniel W. McRobb
+//!  \brief Unit tests for Dwm::Pkg::Scanner
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <unistd.h>
+}
+
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "DwmPkgInfo.hh"
+#include "DwmPkgScanner.hh"
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+inline constexpr const Dwm::Pkg::Info __attribute__((used))
+g_info1(DWM_PKG_TYPE_LIB, DWM_PKG_STATUS_REL, "g_info1", "1.2.10",
+        "Daniel McRobb " DWM_PKG_SYM_GHOST, "mcplex.net");
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static std::string TestData()
+{
+  std::string  s("junk@(#) not a package\n");
+  s += "more junk";
+  s += g_info1.view();
+  s += '\0';
+  s += Dwm::Pkg::info.view();
+  s += '\0';
+  s += "trailing junk";
+  return s;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static std::vector<std::string> Scan(const Dwm::Pkg::Scanner & scanner,
+                                     const std::string & data)
+{
+  std::vector<std::string>  rc;
+  scanner.ScanMemory(data.data(), data.size(),
+                     [&] (const Dwm::Pkg::ScanHit & hit) {
+                       if (hit.encoding == Dwm::Pkg::TextEncoding::k_utf8) {
+                         assert(data.substr(hit.offset, hit.raw.size())
+                                == hit.raw);
+                       }
+                       rc.push_back(std::string(hit.raw));
+                       return true;
+                     });
+  return rc;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestUnfiltered()
+{
+  std::string  data = TestData();
+  Dwm::Pkg::Scanner  scanner;
+  std::vector<std::string>  hits = Scan(scanner, data);
+  assert(hits.size() == 3);
+  assert(hits[0] == "@(#) not a package");
+  assert(hits[1] == g_info1.view());
+  assert(hits[2] == Dwm::Pkg::info.view());
+
+  size_t  numInfos = 0;
+  scanner.ScanMemory(data.data(), data.size(),
+                     [&] (const Dwm::Pkg::ScanHit & hit) {
+                       if (hit.info) {
+                         ++numInfos;
+                         if (hit.info->name == "g_info1") {
+                           assert(hit.info->type == g_info1.type());
+                           assert(hit.info->status == g_info1.status());
+                           assert(hit.info->version == g_info1.version());
+                           assert(hit.info->copyright
+                                  == g_info1.copyright());
+                           assert(hit.info->date == g_info1.date());
+                           assert(hit.info->other == g_info1.other());
+                         }
+                       }
+                       return true;
+                     });
+  assert(numInfos == 2);
+
+  //  Stop after the first hit.
+  size_t  numHits = 0;
+  scanner.ScanMemory(data.data(), data.size(),
+                     [&] (const Dwm::Pkg::ScanHit &)
+                     { ++numHits; return false; });
+  assert(numHits == 1);
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestFiltered()
+{
+  std::string  data = TestData();
+  Dwm::Pkg::ScanFilter  filter;
+  filter.status = DWM_PKG_STATUS_REL;
+  std::vector<std::string>  hits = Scan(Dwm::Pkg::Scanner(filter), data);
+  assert(hits.size() == 1);
+  assert(hits[0] == g_info1.view());
+
+  filter = Dwm::Pkg::ScanFilter();
+  filter.name = "libDwmPkg";
+  hits = Scan(Dwm::Pkg::Scanner(filter), data);
+  assert(hits.size() == 1);
+  assert(hits[0] == Dwm::Pkg::info.view());
+
+  filter = Dwm::Pkg::ScanFilter();
+  assert(filter.SetVersionRange(">=1.2,<1.4"));
+  hits = Scan(Dwm::Pkg::Scanner(filter), data);
+  assert(hits.size() == 1);
+  assert(hits[0] == g_info1.view());
+  assert(filter.SetVersionRange(">1.2.9"));
+  assert(Scan(Dwm::Pkg::Scanner(filter), data).size() == 1);
+  assert(filter.SetVersionRange(">1.2.10"));
+  assert(Scan(Dwm::Pkg::Scanner(filter), data).empty());
+  assert(! filter.SetVersionRange("=>1.2"));
+  
+  filter = Dwm::Pkg::ScanFilter();
+  filter.limit = 2;
+  assert(Scan(Dwm::Pkg::Scanner(filter), data).size() == 2);
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestPipe()
+{
+  std::string  data = TestData();
+  int  fds[2];
+  assert(pipe(fds) == 0);
+  assert(write(fds[1], data.data(), data.size()) == (ssize_t)data.size());
+  close(fds[1]);
+  size_t  numHits = 0;
+  assert(Dwm::Pkg::Scanner().ScanFd(fds[0], [&] (const Dwm::Pkg::ScanHit &)
+                                    { ++numHits; return true; }));
+  close(fds[0]);
+  assert(numHits == 3);
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestBounds()
+{
+  Dwm::Pkg::Scanner  scanner;
+  
+  //  Tiny and unterminated inputs.  Copy to the heap so a sanitizer can
+  //  see any read past the end.
+  using namespace std::string_literals;
+  for (std::string s : { ""s, "@"s, "@(#"s, "@(#)"s, "@(#)x"s, "@(#)\0"s,
+                         "@(#)x\n"s, "xx@(#)ab"s }) {
+    std::unique_ptr<char[]>  buf(new char[s.size() + 1]);
+    memcpy(buf.get(), s.data(), s.size());
+    size_t  numHits = scanner.ScanMemory(buf.get(), s.size(),
+                                         [] (const Dwm::Pkg::ScanHit &)
+                                         { return true; });
+    assert(numHits == ((s == "@(#)\0"s || s == "@(#)x\n"s) ? 1 : 0));
+  }
+
+  //  A terminator right at the end.
+  std::string  s("junk@(#) hit");
+  s += '\0';
+  assert(Scan(scanner, s) == std::vector<std::string>{"@(#) hit"});
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestMaxLength()
+{
+  Dwm::Pkg::ScanFilter  filter;
+  filter.maxLength = 16;
+  Dwm::Pkg::Scanner  scanner(filter);
+  
+  //  Exactly maxLength is not truncated.
+  std::string  s("@(#) 34567890123");
+  s += '\0';
+  std::vector<bool>  truncated;
+  auto  cb = [&] (const Dwm::Pkg::ScanHit & hit) {
+    truncated.push_back(hit.truncated);
+    return true;
+  };
+  assert(scanner.ScanMemory(s.data(), s.size(), cb) == 1);
+  assert(! truncated[0]);
+
+  //  A long run with a hit in it.  The long one is truncated, and we
+  //  find the one inside it.
+  s = "@(#) " + std::string(100, 'x') + "@(#) inner" + std::string(3, 'y');
+  s += '\0';
+  truncated.clear();
+  std::vector<std::string>  hits = Scan(scanner, s);
+  assert(hits.size() == 2);
+  assert(hits[0] == s.substr(0, 16));
+  assert(hits[1] == "@(#) inneryyy");
+  assert(scanner.ScanMemory(s.data(), s.size(), cb) == 2);
+  assert(truncated[0] && (! truncated[1]));
+
+  //  Truncated strings aren't parsed.
+  filter.maxLength = 20;
+  std::string  info(g_info1.view());
+  info += '\0';
+  size_t  numInfos = 0;
+  Dwm::Pkg::Scanner(filter).ScanMemory(info.data(), info.size(),
+                                       [&] (const Dwm::Pkg::ScanHit & hit) {
+                                         numInfos += (hit.info != nullptr);
+                                         return true;
+                                       });
+  assert(numInfos == 0);
+
+  //  No limit.
+  filter.maxLength = 0;
+  s = "@(#) " + std::string(100000, 'x');
+  s += '\n';
+  hits = Scan(Dwm::Pkg::Scanner(filter), s);
+  assert((hits.size() == 1) && (hits[0].size() == 100005));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  Returns the UTF-16 (little endian unless @c bigEndian) encoding of
+//!  the valid UTF-8 string @c s.
+//----------------------------------------------------------------------------
+static std::string ToUtf16(std::string_view s, bool bigEndian = false)
+{
+  std::string  rc;
+  auto  put = [&] (uint16_t u) {
+    char  hi = (char)(u >> 8), lo = (char)(u & 0xFF);
+    rc += (bigEndian ? hi : lo);
+    rc += (bigEndian ? lo : hi);
+  };
+  for (size_t i = 0; i < s.size(); ) {
+    unsigned char  c = s[i];
+    size_t    n = (c < 0x80) ? 1 : ((c < 0xE0) ? 2 : ((c < 0xF0) ? 3 : 4));
+    uint32_t  cp = (n == 1) ? c : (c & (0x7F >> n));
+    for (size_t k = 1; k < n; ++k) {
+      cp = (cp << 6) | (s[i + k] & 0x3F);
+    }
+    if (cp >= 0x10000) {
+      cp -= 0x10000;
+      put(0xD800 | (cp >> 10));
+      put(0xDC00 | (cp & 0x3FF));
+    }
+    else {
+      put(cp);
+    }
+    i += n;
+  }
+  return rc;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestUtf16()
+{
+  using Dwm::Pkg::TextEncoding;
+  using namespace std::string_literals;
+  
+  //  UTF-8, UTF-16LE (at an odd offset) and UTF-16BE in one buffer.
+  //  The heap is aligned, so offsets have the parity of addresses.
+  std::string  le = ToUtf16(g_info1.view());
+  std::string  be = ToUtf16("@(#) h\xC3\xA9llo \xF0\x9F\x98\x80", true);
+  std::string  data("x@(#) plain\0"s + "y" + le + "\0\0"s + "z" + be
+                    + "\0\0"s);
+  Dwm::Pkg::Scanner  scanner;
+  std::vector<Dwm::Pkg::ScanHit>  hits;
+  std::vector<std::string>        raws;
+  size_t  numInfos = 0;
+  scanner.ScanMemory(data.data(), data.size(),
+                     [&] (const Dwm::Pkg::ScanHit & hit) {
+                       hits.push_back(hit);
+                       raws.push_back(std::string(hit.raw));
+                       numInfos += (hit.info != nullptr);
+                       return true;
+                     });
+  assert(hits.size() == 3);
+  assert((raws[0] == "@(#) plain") && (hits[0].offset == 1)
+         && (hits[0].encoding == TextEncoding::k_utf8));
+  assert((raws[1] == g_info1.view()) && (hits[1].offset == 13)
+         && (hits[1].encoding == TextEncoding::k_utf16le));
+  assert(data.substr(hits[1].offset, le.size()) == le);
+  assert(raws[2] == "@(#) h\xC3\xA9llo \xF0\x9F\x98\x80");
+  assert(hits[2].encoding == TextEncoding::k_utf16be);
+  assert(data.substr(hits[2].offset, be.size()) == be);
+  assert(numInfos == 1);
+  assert(std::string(Dwm::Pkg::TextEncodingName(hits[1].encoding))
+         == "utf-16le");
+
+  //  "\0@\0(\0#\0)\0" could be either; alignment decides.
+  std::string  both = ToUtf16("@(#) \xF0\x9F\x98\x80", true) + "\0\0"s;
+  raws = Scan(scanner, both);
+  assert((raws.size() == 1) && (raws[0] == "@(#) \xF0\x9F\x98\x80"));
+  both = "\0\0\0\0"s + ToUtf16("@(#) \xF0\x9F\x98\x80") + "\0\0"s;
+  raws = Scan(scanner, both);
+  assert((raws.size() == 1) && (raws[0] == "@(#) \xF0\x9F\x98\x80"));
+
+  //  A big endian marker right at the start, and an unpaired surrogate.
+  data = ToUtf16("@(#) a", true) + "\xD8\x00"s + ToUtf16("b\n", true);
+  assert(Scan(scanner, data)
+         == std::vector<std::string>{"@(#) a\xEF\xBF\xBD" "b"});
+
+  //  Unterminated, and too short to be a marker.  Copy to the heap so a
+  //  sanitizer can see any read past the end.
+  for (std::string s : { ToUtf16("@(#) never ends"), ToUtf16("@(#)"),
+                         "@\0(\0#\0)"s, ToUtf16("@(#)", true),
+                         "\0@\0(\0#\0"s }) {
+    std::unique_ptr<char[]>  buf(new char[s.size()]);
+    memcpy(buf.get(), s.data(), s.size());
+    assert(scanner.ScanMemory(buf.get(), s.size(),
+                              [] (const Dwm::Pkg::ScanHit &)
+                              { return true; }) == 0);
+  }
+
+  //  An unterminated UTF-16 string doesn't hide what follows.
+  data = ToUtf16("@(#) x") + "@(#) plain\n";
+  assert(Scan(scanner, data) == std::vector<std::string>{"@(#) plain"});
+  
+  //  maxLength applies to the UTF-8, and we find the hit inside a
+  //  truncated one.
+  Dwm::Pkg::ScanFilter  filter;
+  filter.maxLength = 16;
+  data = ToUtf16("@(#) " + std::string(40, 'x') + "@(#) inner") + "\0\0"s;
+  raws = Scan(Dwm::Pkg::Scanner(filter), data);
+  assert(raws.size() == 2);
+  assert(raws[0] == "@(#) " + std::string(11, 'x'));
+  assert(raws[1] == "@(#) inner");
+  //  ...without splitting a character.
+  data = ToUtf16("@(#) 123456789\xE2\x9C\x93") + "\0\0"s;
+  raws = Scan(Dwm::Pkg::Scanner(filter), data);
+  assert((raws.size() == 1) && (raws[0] == "@(#) 123456789"));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  TestUnfiltered();
+  TestFiltered();
+  TestPipe();
+  TestBounds();
+  TestMaxLength();
+  TestUtf16();
+  return 0;
+}
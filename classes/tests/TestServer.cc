@@ -0,0 +1,176 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  \file TestServer.cc
+//!  \author Daniel W. McRobb
+//!  \brief Unit tests for the dwmwhat DwmWhat::Server and DwmWhat::Client
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <sys/socket.h>
+  #include <sys/un.h>
+  #include <fcntl.h>
+  #include <limits.h>
+  #include <stdlib.h>
+  #include <unistd.h>
+}
+
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../apps/dwmwhat/DwmWhatServer.hh"
+
+//----------------------------------------------------------------------------
+//!  Connects a raw socket to the server at @c path.
+//----------------------------------------------------------------------------
+static int ConnectRaw(const std::string & path)
+{
+  struct sockaddr_un  sun;
+  memset(&sun, 0, sizeof(sun));
+  sun.sun_family = AF_UNIX;
+  strncpy(sun.sun_path, path.c_str(), sizeof(sun.sun_path) - 1);
+  int  fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  assert(fd >= 0);
+  assert(connect(fd, (struct sockaddr *)&sun, sizeof(sun)) == 0);
+  return fd;
+}
+
+//----------------------------------------------------------------------------
+//!  Queries @c path through @c client, failing if the reply takes more
+//!  than 5 seconds.
+//----------------------------------------------------------------------------
+static bool Query(DwmWhat::Client & client, const std::string & path,
+                  std::vector<std::string> & hits, std::string & error)
+{
+  auto  fut = std::async(std::launch::async, [&] {
+    return client.Query(path, hits, error);
+  });
+  assert(fut.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+  return fut.get();
+}
+
+//----------------------------------------------------------------------------
+//!  With a single worker, one idle client must not keep another from
+//!  getting answers, and an overlong line gets an error.
+//----------------------------------------------------------------------------
+static void TestIdleClient()
+{
+  char  dirTemplate[] = "/tmp/TestServer.XXXXXX";
+  assert(mkdtemp(dirTemplate));
+  std::string  dir(dirTemplate);
+  std::string  sockPath = dir + "/sock";
+  std::string  filePath = dir + "/file";
+  int  fd = open(filePath.c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0644);
+  assert(fd >= 0);
+  std::string  data("xx@(#) found it\nyy", 18);
+  assert(write(fd, data.data(), data.size()) == (ssize_t)data.size());
+  close(fd);
+
+  DwmWhat::Server  server(sockPath, 1);
+  std::thread      serverThread([&] { assert(server.Run()); });
+  DwmWhat::Client  idle;
+  for (int i = 0; (i < 500) && (! idle.Connect(sockPath)); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  //  A second idle client that sent part of a line.
+  int  partial = ConnectRaw(sockPath);
+  assert(write(partial, "/tmp", 4) == 4);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  DwmWhat::Client  active;
+  assert(active.Connect(sockPath));
+  std::vector<std::string>  hits;
+  std::string               error;
+  for (int i = 0; i < 3; ++i) {
+    assert(Query(active, filePath, hits, error));
+    assert(hits.size() == 1);
+    assert(hits[0] == "@(#) found it");
+  }
+  assert(! Query(active, dir + "/nonexistent", hits, error));
+  assert(! error.empty());
+
+  //  The idle client still works.
+  assert(Query(idle, filePath, hits, error));
+  assert(hits.size() == 1);
+
+  //  A line longer than PATH_MAX gets an error and is disconnected.
+  int  longFd = ConnectRaw(sockPath);
+  std::string  longLine(PATH_MAX + 16, 'x');
+  assert(write(longFd, longLine.data(), longLine.size())
+         == (ssize_t)longLine.size());
+  std::string  reply;
+  char  buf[64];
+  ssize_t  rc;
+  while ((rc = read(longFd, buf, sizeof(buf))) > 0) {
+    reply.append(buf, rc);
+  }
+  assert(reply == "ERR line too long\n");
+  close(longFd);
+
+  //  Pipelined requests are answered in order.
+  int  pipeFd = ConnectRaw(sockPath);
+  std::string  reqs = filePath + '\n' + dir + "/nonexistent\n";
+  assert(write(pipeFd, reqs.data(), reqs.size()) == (ssize_t)reqs.size());
+  shutdown(pipeFd, SHUT_WR);
+  reply.clear();
+  while ((rc = read(pipeFd, buf, sizeof(buf))) > 0) {
+    reply.append(buf, rc);
+  }
+  assert(reply.compare(0, 19, "OK 1\n@(#) found it\n") == 0);
+  assert(reply.compare(19, 4, "ERR ") == 0);
+  close(pipeFd);
+
+  close(partial);
+  server.Stop();
+  serverThread.join();
+  unlink(filePath.c_str());
+  rmdir(dir.c_str());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  TestIdleClient();
+  return 0;
+}
@@ -0,0 +1,334 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  \file TestSnapshot.cc
+//!  \author Daniel W. McRobb
+//!  \brief Unit tests for the dwmwhat DwmWhat::SnapshotWriter,
+//!    DwmWhat::Snapshot and DwmWhat::DiffSnapshots()
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <stdlib.h>
+  #include <unistd.h>
+}
+
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "../../apps/dwmwhat/DwmWhatSnapshot.hh"
+
+using DwmWhat::Snapshot;
+using DwmWhat::SnapshotWriter;
+
+static std::string  g_dir;
+
+//----------------------------------------------------------------------------
+//!  A package found in a file: name, version and date.
+//----------------------------------------------------------------------------
+struct TestPkg {
+  std::string  name;
+  std::string  version;
+  std::string  date;
+};
+
+//----------------------------------------------------------------------------
+//!  A file and the packages found in it.
+//----------------------------------------------------------------------------
+struct TestFile {
+  std::string           path;
+  std::vector<TestPkg>  pkgs;
+};
+
+//----------------------------------------------------------------------------
+//!  Writes a snapshot of @c files named @c name in our temporary
+//!  directory and returns its path.
+//----------------------------------------------------------------------------
+static std::string Write(const std::string & name,
+                         const std::vector<TestFile> & files)
+{
+  SnapshotWriter  writer;
+  std::vector<std::string>  raws;
+  for (const auto & file : files) {
+    uint32_t  fileIdx = writer.AddFile(file.path);
+    for (const auto & pkg : file.pkgs) {
+      std::string  raw("@(#) " + pkg.name + " " + pkg.version + " "
+                       + pkg.date);
+      Dwm::Pkg::InfoView  iv;
+      iv.type = "lib";
+      iv.status = "rel";
+      iv.name = pkg.name;
+      iv.version = pkg.version;
+      iv.copyright = "me";
+      iv.date = pkg.date;
+      iv.other = "";
+      writer.AddPkg(fileIdx, iv, raw);
+    }
+    writer.AddOther(fileIdx, "@(#) other in " + file.path);
+  }
+  std::string  path = g_dir + "/" + name;
+  assert(writer.Write(path));
+  return path;
+}
+
+//----------------------------------------------------------------------------
+//!  Returns the contents of the file at @c path.
+//----------------------------------------------------------------------------
+static std::string ReadFile(const std::string & path)
+{
+  std::ifstream  is(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(is),
+                     std::istreambuf_iterator<char>());
+}
+
+//----------------------------------------------------------------------------
+//!  Writes @c data to @c name in our temporary directory and returns
+//!  true if a Snapshot can open it.
+//----------------------------------------------------------------------------
+static bool Opens(const std::string & name, const std::string & data)
+{
+  std::string  path = g_dir + "/" + name;
+  std::ofstream  os(path, std::ios::binary|std::ios::trunc);
+  os.write(data.data(), data.size());
+  os.close();
+  Snapshot  snap;
+  return snap.Open(path);
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestRoundTrip()
+{
+  //  Files and packages are added out of order.
+  std::string  path = Write("roundtrip.snap", {
+      { "/usr/lib/b.so", { { "foo", "1.10", "2024" },
+                           { "bar", "2.0", "2024" },
+                           { "foo", "1.9", "2024" } } },
+      { "/usr/lib/a.so", { { "foo", "1.2", "2024" } } },
+      { "/usr/lib/c.so", { } } });
+  Snapshot  snap;
+  assert(snap.Open(path));
+  assert(snap.NumFiles() == 3);
+  assert(snap.String(snap.File(0).path) == "/usr/lib/a.so");
+  assert(snap.String(snap.File(1).path) == "/usr/lib/b.so");
+  assert(snap.String(snap.File(2).path) == "/usr/lib/c.so");
+
+  auto  pkgs = snap.Pkgs(snap.File(1));
+  assert(pkgs.size() == 3);
+  assert(snap.String(pkgs[0].name) == "bar");
+  assert(snap.String(pkgs[1].name) == "foo");
+  assert(snap.String(pkgs[1].version) == "1.10");   // string order
+  assert(snap.String(pkgs[2].version) == "1.9");
+  assert(snap.String(pkgs[0].raw) == "@(#) bar 2.0 2024");
+  assert(snap.String(pkgs[0].type) == "lib");
+  assert(snap.String(pkgs[0].copyright) == "me");
+  assert(snap.Pkgs(snap.File(2)).empty());
+  auto  others = snap.Others(snap.File(2));
+  assert(others.size() == 1);
+  assert(snap.String(others[0]) == "@(#) other in /usr/lib/c.so");
+
+  //  The index is sorted by name, then by version order.
+  auto  index = snap.PkgIndex();
+  assert(index.size() == 4);
+  std::vector<std::string>  versions;
+  for (const auto & ref : index) {
+    versions.push_back(std::string(snap.String(snap.Pkg(ref).version)));
+  }
+  assert((versions == std::vector<std::string>{"2.0", "1.2", "1.9",
+                                                "1.10"}));
+  auto  found = snap.FindPkgs("foo", {{">", "1.2"}, {"<=", "1.10"}});
+  assert(found.size() == 2);
+  assert(snap.String(snap.Pkg(found[0]).version) == "1.9");
+  assert(snap.String(snap.File(found[0].file).path) == "/usr/lib/b.so");
+  assert(snap.FindPkgs("nothere", {}).empty());
+  assert(snap.FindPkgs("", {}).size() == 4);
+
+  //  Reopening replaces the old mapping.
+  std::string  other = Write("other.snap", { { "/x", { } } });
+  assert(snap.Open(other));
+  assert(snap.NumFiles() == 1);
+  assert(snap.PkgIndex().empty());
+  assert(! snap.Open(g_dir + "/nonexistent.snap"));
+  assert(snap.NumFiles() == 0);
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  Corrupt, truncated and unsorted snapshots are rejected.
+//----------------------------------------------------------------------------
+static void TestValidate()
+{
+  std::string  path = Write("valid.snap", {
+      { "/a", { { "foo", "1.0", "2024" }, { "bar", "1.0", "2024" } } },
+      { "/b", { { "foo", "1.0", "2024" } } } });
+  std::string  good = ReadFile(path);
+  assert(Opens("copy.snap", good));
+
+  DwmWhat::SnapshotHeader  hdr;
+  memcpy(&hdr, good.data(), sizeof(hdr));
+  size_t  stringsOff = sizeof(hdr);
+  size_t  filesOff = stringsOff
+    + (hdr.numStrings * sizeof(DwmWhat::SnapshotString));
+  size_t  pkgsOff = filesOff + (hdr.numFiles * sizeof(DwmWhat::SnapshotFile));
+  
+  std::string  bad(good);
+  bad[0] = 'X';
+  assert(! Opens("magic.snap", bad));
+
+  bad = good;
+  DwmWhat::SnapshotHeader  badHdr(hdr);
+  badHdr.version = 99;
+  memcpy(bad.data(), &badHdr, sizeof(badHdr));
+  assert(! Opens("version.snap", bad));
+  
+  bad = good;
+  badHdr = hdr;
+  badHdr.numFiles += 1;
+  memcpy(bad.data(), &badHdr, sizeof(badHdr));
+  assert(! Opens("count.snap", bad));
+
+  assert(! Opens("truncated.snap", good.substr(0, good.size() - 1)));
+  assert(! Opens("short.snap", good.substr(0, sizeof(hdr) - 1)));
+  assert(! Opens("empty.snap", ""));
+
+  //  A string id out of range.
+  bad = good;
+  uint32_t  badId = hdr.numStrings;
+  memcpy(&bad[filesOff], &badId, sizeof(badId));
+  assert(! Opens("badid.snap", bad));
+
+  //  A string running past the blob.
+  bad = good;
+  DwmWhat::SnapshotString  str;
+  memcpy(&str, &bad[stringsOff], sizeof(str));
+  str.length = hdr.blobSize + 1;
+  memcpy(&bad[stringsOff], &str, sizeof(str));
+  assert(! Opens("badstring.snap", bad));
+
+  //  Files out of path order.
+  bad = good;
+  DwmWhat::SnapshotFile  f0, f1;
+  memcpy(&f0, &bad[filesOff], sizeof(f0));
+  memcpy(&f1, &bad[filesOff + sizeof(f0)], sizeof(f1));
+  std::swap(f0.path, f1.path);
+  memcpy(&bad[filesOff], &f0, sizeof(f0));
+  memcpy(&bad[filesOff + sizeof(f0)], &f1, sizeof(f1));
+  assert(! Opens("unsortedfiles.snap", bad));
+
+  //  Packages out of name order within a file.
+  bad = good;
+  DwmWhat::SnapshotPkg  p0, p1;
+  memcpy(&p0, &bad[pkgsOff], sizeof(p0));
+  memcpy(&p1, &bad[pkgsOff + sizeof(p0)], sizeof(p1));
+  memcpy(&bad[pkgsOff], &p1, sizeof(p1));
+  memcpy(&bad[pkgsOff + sizeof(p1)], &p0, sizeof(p0));
+  assert(! Opens("unsortedpkgs.snap", bad));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestDiff()
+{
+  std::string  oldPath = Write("old.snap", {
+      { "/a", { { "foo", "1.0", "2024" } } },
+      { "/b", { { "bar", "2.0", "2024" }, { "baz", "1.0", "2024" },
+                { "foo", "1.0", "2024" }, { "foo", "1.0", "2025" } } },
+      { "/gone", { { "qux", "1", "2024" } } },
+      { "/same", { { "foo", "1.0", "2024" } } } });
+  std::string  newPath = Write("new.snap", {
+      { "/a", { { "foo", "1.1", "2024" } } },
+      { "/b", { { "bar", "2.0", "2025" }, { "foo", "1.0", "2026" },
+                { "new", "3", "2024" } } },
+      { "/new", { { "zed", "1", "2024" }, { "zed", "1", "2025" } } },
+      { "/same", { { "foo", "1.0", "2024" } } } });
+  Snapshot  oldSnap, newSnap;
+  assert(oldSnap.Open(oldPath));
+  assert(newSnap.Open(newPath));
+
+  using Diff = std::tuple<std::string,std::string,std::string,std::string>;
+  std::vector<Diff>  diffs;
+  DwmWhat::DiffSnapshots(oldSnap, newSnap,
+                         [&] (const DwmWhat::SnapshotDiff & d) {
+    assert(d.oldStatus == (d.oldVersion.empty() ? "" : "rel"));
+    assert(d.newStatus == (d.newVersion.empty() ? "" : "rel"));
+    diffs.push_back({std::string(d.path), std::string(d.name),
+                     std::string(d.oldVersion), std::string(d.newVersion)});
+  });
+  //  Dates don't matter, and two copies of one version are one package.
+  std::vector<Diff>  expected = {
+    { "/a", "foo", "1.0", "1.1" },
+    { "/b", "baz", "1.0", "" },
+    { "/b", "new", "", "3" },
+    { "/gone", "qux", "1", "" },
+    { "/new", "zed", "", "1" }
+  };
+  assert(diffs == expected);
+
+  //  No differences with itself.
+  diffs.clear();
+  DwmWhat::DiffSnapshots(newSnap, newSnap,
+                         [&] (const DwmWhat::SnapshotDiff &) {
+    diffs.push_back({});
+  });
+  assert(diffs.empty());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  char  dirTemplate[] = "/tmp/TestSnapshot.XXXXXX";
+  assert(mkdtemp(dirTemplate));
+  g_dir = dirTemplate;
+  
+  TestRoundTrip();
+  TestValidate();
+  TestDiff();
+
+  std::string  cmd("rm -rf " + g_dir);
+  assert(system(cmd.c_str()) == 0);
+  return 0;
+}
@@ -0,0 +1,255 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  \file TestSymbolIndex.cc
+//!  \author Daniel W. McRobb
+//!  \brief Unit tests for Dwm::Pkg::SymbolIndex
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+}
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "DwmPkgInfo.hh"
+#include "DwmPkgSymbolIndex.hh"
+
+namespace TestSymbolIndex {
+  inline constexpr const Dwm::Pkg::Info __attribute__((used))
+  info(DWM_PKG_TYPE_EXE, DWM_PKG_STATUS_DEV, "TestSymbolIndex", "1.0.0",
+       "Daniel McRobb", "test");
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+template <typename T>
+static void Put(std::string & s, size_t off, T value)
+{
+  if (s.size() < off + sizeof(T)) {
+    s.resize(off + sizeof(T), '\0');
+  }
+  memcpy(&s[off], &value, sizeof(T));   // little-endian hosts only
+}
+
+struct Sym
+{
+  std::string  name;
+  uint64_t     value;
+  uint64_t     size;
+  uint8_t      info;     // (binding << 4) | type
+  uint16_t     shndx;
+};
+
+//----------------------------------------------------------------------------
+//!  A 64-bit ET_DYN image with no program headers and sections null,
+//!  .symtab, .strtab and .shstrtab.  Without segments, addresses are
+//!  file offsets.
+//----------------------------------------------------------------------------
+static std::string MakeElf(const std::vector<Sym> & syms)
+{
+  std::string  strtab(1, '\0');
+  std::string  symtab(24, '\0');
+  for (const auto & sym : syms) {
+    size_t  off = symtab.size();
+    Put<uint32_t>(symtab, off, strtab.size());
+    Put<uint8_t>(symtab, off + 4, sym.info);
+    Put<uint16_t>(symtab, off + 6, sym.shndx);
+    Put<uint64_t>(symtab, off + 8, sym.value);
+    Put<uint64_t>(symtab, off + 16, sym.size);
+    strtab.append(sym.name.c_str(), sym.name.size() + 1);
+  }
+  std::string  shstrtab("\0.symtab\0.strtab\0.shstrtab\0", 27);
+  
+  std::string  elf;
+  elf.append("\x7f" "ELF", 4);
+  Put<uint8_t>(elf, 4, 2);
+  Put<uint8_t>(elf, 5, 1);
+  Put<uint8_t>(elf, 6, 1);
+  Put<uint16_t>(elf, 16, 3);     // ET_DYN
+  elf.resize(64);
+  size_t  symOff = elf.size();
+  elf += symtab;
+  size_t  strOff = elf.size();
+  elf += strtab;
+  size_t  shstrOff = elf.size();
+  elf += shstrtab;
+  elf.resize((elf.size() + 7) & ~7);
+  size_t  shoff = elf.size();
+  Put<uint64_t>(elf, 0x28, shoff);
+  Put<uint16_t>(elf, 0x3a, 64);
+  Put<uint16_t>(elf, 0x3c, 4);
+  Put<uint16_t>(elf, 0x3e, 3);
+  elf.resize(shoff + 4 * 64);
+  auto  putShdr = [&] (int i, uint32_t name, uint32_t type, size_t off,
+                       size_t size, uint32_t link, uint64_t entsize) {
+    size_t  sh = shoff + i * 64;
+    Put<uint32_t>(elf, sh, name);
+    Put<uint32_t>(elf, sh + 4, type);
+    Put<uint64_t>(elf, sh + 24, off);
+    Put<uint64_t>(elf, sh + 32, size);
+    Put<uint32_t>(elf, sh + 40, link);
+    Put<uint64_t>(elf, sh + 56, entsize);
+  };
+  putShdr(1, 1, 2, symOff, symtab.size(), 2, 24);    // .symtab
+  putShdr(2, 9, 3, strOff, strtab.size(), 0, 0);     // .strtab
+  putShdr(3, 17, 3, shstrOff, shstrtab.size(), 0, 0); // .shstrtab
+  return elf;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestNesting()
+{
+  const uint8_t  globalObj = (1 << 4) | 1, localObj = 1;
+  std::vector<Sym>  syms = {
+    { "outer",   0x1000, 0x100, globalObj, 1 },
+    { "inner",   0x1010, 0x10,  localObj,  1 },
+    { "sticks",  0x1080, 0x180, globalObj, 1 },
+    { "loc",     0x2000, 0x10,  localObj,  1 },
+    { "glob",    0x2000, 0x10,  globalObj, 1 },
+    { "empty",   0x2800, 0,     globalObj, 1 },
+    { "undef",   0x2900, 0x10,  globalObj, 0 },
+    { "section", 0x2a00, 0x10,  (1 << 4) | 3, 1 },
+    { "_ZN3Foo3Bar4infoE", 0x3000, 0x40, globalObj, 1 }
+  };
+  std::string  elf = MakeElf(syms);
+  Dwm::Pkg::SymbolIndex  index;
+  assert(index.Build(elf.data(), elf.size()));
+  uint64_t  addr;
+  assert(index.OffsetToAddr(0x1234, addr) && (addr == 0x1234));
+  
+  assert(index.Find(0xfff).empty());
+  assert(index.Find(0x1000) == "outer");
+  assert(index.Find(0x1010) == "inner");
+  assert(index.Find(0x101f) == "inner");
+  assert(index.Find(0x1020) == "outer");
+  assert(index.Find(0x1080) == "sticks");
+  assert(index.Find(0x10ff) == "sticks");
+  assert(index.Find(0x1100).empty());     // cut at the end of outer
+  assert(index.Find(0x2000) == "glob");   // global alias wins
+  assert(index.Find(0x2010).empty());
+  assert(index.Find(0x2800).empty());
+  assert(index.Find(0x2900).empty());
+  assert(index.Find(0x2a00).empty());
+  assert(index.Find(0x3020) == "_ZN3Foo3Bar4infoE");
+  assert(Dwm::Pkg::Demangle(index.Find(0x3020)) == "Foo::Bar::info");
+  assert(Dwm::Pkg::Demangle("main") == "main");
+
+  assert(! index.Build("not an image", 12));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  A million symbols, shuffled.
+//----------------------------------------------------------------------------
+static void TestMany()
+{
+  const uint32_t    numSyms = 1000000;
+  std::vector<Sym>  syms;
+  syms.reserve(numSyms);
+  for (uint32_t i = 0; i < numSyms; ++i) {
+    syms.push_back({"s" + std::to_string(i), 0x100000 + 32ULL * i, 24,
+                    (1 << 4) | 2, 1});
+  }
+  std::mt19937  rng(42);
+  std::shuffle(syms.begin(), syms.end(), rng);
+  std::string  elf = MakeElf(syms);
+  Dwm::Pkg::SymbolIndex  index;
+  assert(index.Build(elf.data(), elf.size()));
+  assert(index.Size() == numSyms);
+  for (int n = 0; n < 10000; ++n) {
+    uint32_t  i = rng() % numSyms;
+    uint64_t  addr = 0x100000 + 32ULL * i;
+    std::string  name("s" + std::to_string(i));
+    assert(index.Find(addr) == name);
+    assert(index.Find(addr + 23) == name);
+    assert(index.Find(addr + 24).empty());
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  Finds our own Info in our own executable.
+//----------------------------------------------------------------------------
+static void TestSelf()
+{
+#if defined(__linux__)
+  int  fd = open("/proc/self/exe", O_RDONLY);
+  assert(fd >= 0);
+  struct stat  statbuf;
+  assert(fstat(fd, &statbuf) == 0);
+  size_t  len = statbuf.st_size;
+  void  *p = mmap(0, len, PROT_READ, MAP_SHARED, fd, 0);
+  assert(p != MAP_FAILED);
+  std::string_view  image((const char *)p, len);
+  Dwm::Pkg::SymbolIndex  index;
+  assert(index.Build(image.data(), len));
+  size_t  off = image.find(TestSymbolIndex::info.view());
+  assert(off != std::string_view::npos);
+  uint64_t  addr;
+  assert(index.OffsetToAddr(off, addr));
+  assert(Dwm::Pkg::Demangle(index.Find(addr)) == "TestSymbolIndex::info");
+  off = image.find(Dwm::Pkg::info.view());
+  assert(off != std::string_view::npos);
+  assert(index.OffsetToAddr(off, addr));
+  assert(Dwm::Pkg::Demangle(index.Find(addr)) == "Dwm::Pkg::info");
+  munmap(p, len);
+  close(fd);
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  TestNesting();
+  TestMany();
+  TestSelf();
+  return 0;
+}
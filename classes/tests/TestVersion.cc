@@ -0,0 +1,141 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  \file TestVersion.cc
+//!  \author Daniel W. McRobb
+//!  \brief Unit tests for Dwm::Pkg::Version
+//---------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cassert>
+#include <string_view>
+#include <vector>
+
+#include "DwmPkgVersion.hh"
+
+using Dwm::Pkg::Version;
+
+//----------------------------------------------------------------------------
+//!  Everything is constexpr, so these are checked at compile time.
+//----------------------------------------------------------------------------
+static_assert(Version("0.0.9") < Version("0.0.10"));
+static_assert(Version("1.2") == Version("1.2.0"));
+static_assert(Version("1.0.0-rc.1") < Version("1.0.0"));
+static_assert(Version("1.0.0+build.5") == Version("1.0.0"));
+static_assert(Version("1.0.0-rc.1+abc").pre_release() == "rc.1");
+static_assert(Version("1.0.0-rc.1+abc").build() == "abc");
+static_assert(Version("1.0.0-rc.1+abc").core() == "1.0.0");
+static_assert(Version("1.2.3").Valid());
+static_assert(! Version("1.2").Valid());
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestCore()
+{
+  assert(Version("0.0.10") > Version("0.0.9"));
+  assert(Version("10.0.0") > Version("9.99.99"));
+  assert(Version("1.2.0") == Version("1.2"));
+  assert(Version("1") == Version("1.0.0"));
+  assert(Version("") == Version("0"));
+  assert(Version() == Version("0.0.0"));
+  assert(Version("01.2") == Version("1.2"));
+  //  No overflow, however long the component.
+  assert(Version("1.123456789012345678901234567890")
+         > Version("1.123456789012345678901234567889"));
+  assert(Version("1.99999999999999999999") > Version("1.18446744073709551615"));
+  //  Non-numeric tails are compared lexically after the number.
+  assert(Version("1.2.3a") > Version("1.2.3"));
+  assert(Version("1.2.3b") > Version("1.2.3a"));
+  assert(Version("1.2.4") > Version("1.2.3b"));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  The precedence example from semver.org.
+//----------------------------------------------------------------------------
+static void TestPreRelease()
+{
+  std::vector<std::string_view>  ordered = {
+    "1.0.0-alpha", "1.0.0-alpha.1", "1.0.0-alpha.beta", "1.0.0-beta",
+    "1.0.0-beta.2", "1.0.0-beta.11", "1.0.0-rc.1", "1.0.0"
+  };
+  for (size_t i = 0; i < ordered.size(); ++i) {
+    for (size_t j = 0; j < ordered.size(); ++j) {
+      int  cmp = Version(ordered[i]).Compare(Version(ordered[j]));
+      assert((i < j) ? (cmp < 0) : ((i > j) ? (cmp > 0) : (cmp == 0)));
+    }
+  }
+  std::vector<std::string_view>  shuffled(ordered.rbegin(), ordered.rend());
+  std::sort(shuffled.begin(), shuffled.end(),
+            [] (std::string_view a, std::string_view b)
+            { return Version(a) < Version(b); });
+  assert(shuffled == ordered);
+  assert(Version("1.0.0-rc.1+x") == Version("1.0.0-rc.1+y"));
+  assert(Version("1.0.1-rc.1") > Version("1.0.0"));
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+static void TestValid()
+{
+  assert(Version("0.0.0").Valid());
+  assert(Version("1.2.3-rc.1").Valid());
+  assert(Version("1.2.3-rc.1+build.007").Valid());
+  assert(Version("1.2.3-x-y").Valid());
+  assert(! Version("1.2.3.4").Valid());
+  assert(! Version("01.2.3").Valid());
+  assert(! Version("1.2.3a").Valid());
+  assert(! Version("1.2.3-").Valid());
+  assert(! Version("1.2.3-rc..1").Valid());
+  assert(! Version("1.2.3-rc.01").Valid());
+  assert(! Version("1.2.3+").Valid());
+  assert(! Version("1.2.3+a_b").Valid());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  TestCore();
+  TestPreRelease();
+  TestValid();
+  return 0;
+}
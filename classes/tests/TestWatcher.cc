@@ -0,0 +1,193 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  \file TestWatcher.cc
+//!  \author Daniel W. McRobb
+//!  \brief Unit tests for the dwmwhat DwmWhat::Watcher, run against a
+//!    temporary directory
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <sys/stat.h>
+  #include <stdio.h>
+  #include <stdlib.h>
+  #include <unistd.h>
+}
+
+#include <cassert>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <tuple>
+
+#include "../../apps/dwmwhat/DwmWhatWatcher.hh"
+
+using Delta = std::tuple<char,std::string,std::string>;
+
+static std::mutex       g_mtx;
+static std::set<Delta>  g_deltas;
+static size_t           g_numDeltas = 0;
+
+//----------------------------------------------------------------------------
+//!  Writes @c s to the file at @c path, followed by a NUL.
+//----------------------------------------------------------------------------
+static void WriteFile(const std::string & path, const std::string & s)
+{
+  std::ofstream  os(path, std::ios::binary|std::ios::trunc);
+  os.write(s.c_str(), s.size() + 1);
+}
+
+//----------------------------------------------------------------------------
+//!  Waits up to 5 seconds for @c pred to hold for the deltas seen so far.
+//----------------------------------------------------------------------------
+static bool WaitFor(const std::function<bool()> & pred)
+{
+  auto  deadline = std::chrono::steady_clock::now()
+    + std::chrono::seconds(5);
+  while (std::chrono::steady_clock::now() < deadline) {
+    {
+      std::lock_guard<std::mutex>  lck(g_mtx);
+      if (pred()) {
+        return true;
+      }
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+//!  Returns true if we've seen @c delta, and forgets it.
+//----------------------------------------------------------------------------
+static bool Saw(const Delta & delta)
+{
+  return (g_deltas.erase(delta) == 1);
+}
+
+//----------------------------------------------------------------------------
+//!  Exercises the debounce and file, directory rename and delete handling.
+//----------------------------------------------------------------------------
+static void TestWatcher()
+{
+  char  dirTemplate[] = "/tmp/TestWatcher.XXXXXX";
+  assert(mkdtemp(dirTemplate));
+  std::string  dir(dirTemplate);
+  WriteFile(dir + "/a", "@(#) one");
+  
+  Dwm::Pkg::Scanner  scanner;
+  DwmWhat::Watcher   watcher(scanner, std::chrono::milliseconds(300),
+                             [&] (const DwmWhat::WatchDelta & d) {
+    std::lock_guard<std::mutex>  lck(g_mtx);
+    g_deltas.insert({d.op, std::string(d.path), std::string(d.hit)});
+    ++g_numDeltas;
+  });
+  std::thread  thread([&] { assert(watcher.Run({dir})); });
+
+  //  The baseline scan reports what's already there.
+  assert(WaitFor([&] { return Saw({'+', dir + "/a", "@(#) one"}); }));
+
+  //  A burst of writes inside the debounce window is one rescan, so we
+  //  never see the intermediate contents.
+  for (int i = 0; i < 5; ++i) {
+    WriteFile(dir + "/b", "@(#) draft " + std::to_string(i));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  WriteFile(dir + "/b", "@(#) two");
+  assert(WaitFor([&] { return Saw({'+', dir + "/b", "@(#) two"}); }));
+  {
+    std::lock_guard<std::mutex>  lck(g_mtx);
+    assert(g_deltas.empty());
+  }
+  
+  //  Rewriting a file reports what went away and what appeared.
+  WriteFile(dir + "/b", "@(#) three");
+  assert(WaitFor([&] {
+    return (g_deltas.size() == 2)
+      && Saw({'-', dir + "/b", "@(#) two"})
+      && Saw({'+', dir + "/b", "@(#) three"});
+  }));
+
+  //  A new directory is watched, and its files scanned.
+  assert(mkdir((dir + "/sub").c_str(), 0755) == 0);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  WriteFile(dir + "/sub/c", "@(#) four");
+  assert(WaitFor([&] { return Saw({'+', dir + "/sub/c", "@(#) four"}); }));
+
+  //  Renaming a directory moves its files.
+  assert(rename((dir + "/sub").c_str(), (dir + "/moved").c_str()) == 0);
+  assert(WaitFor([&] {
+    return (g_deltas.size() == 2)
+      && Saw({'-', dir + "/sub/c", "@(#) four"})
+      && Saw({'+', dir + "/moved/c", "@(#) four"});
+  }));
+  //  ...and the new name is still watched.
+  WriteFile(dir + "/moved/d", "@(#) five");
+  assert(WaitFor([&] { return Saw({'+', dir + "/moved/d", "@(#) five"}); }));
+
+  //  Deleting files and directories reports their strings as gone.
+  assert(unlink((dir + "/a").c_str()) == 0);
+  assert(WaitFor([&] { return Saw({'-', dir + "/a", "@(#) one"}); }));
+  assert(unlink((dir + "/moved/c").c_str()) == 0);
+  assert(unlink((dir + "/moved/d").c_str()) == 0);
+  assert(rmdir((dir + "/moved").c_str()) == 0);
+  assert(WaitFor([&] {
+    return (g_deltas.size() == 2)
+      && Saw({'-', dir + "/moved/c", "@(#) four"})
+      && Saw({'-', dir + "/moved/d", "@(#) five"});
+  }));
+
+  watcher.Stop();
+  thread.join();
+  assert(g_deltas.empty());
+  assert(g_numDeltas == 11);
+  
+  unlink((dir + "/b").c_str());
+  rmdir(dir.c_str());
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  TestWatcher();
+  return 0;
+}
@@ -0,0 +1,115 @@
+//===========================================================================
+// @(#) $DwmPath$
+//===========================================================================
+//  Copyright (c) Daniel W. McRobb 2026
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright
+//     notice, this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//  3. The names of the authors and copyright holders may not be used to
+//     endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+//  IN NO EVENT SHALL DANIEL W. MCROBB BE LIABLE TO ANY PARTY FOR
+//  DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES,
+//  INCLUDING LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE,
+//  EVEN IF DANIEL W. MCROBB HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+//  DAMAGE.
+//
+//  THE SOFTWARE PROVIDED HEREIN IS ON AN "AS IS" BASIS, AND
+//  DANIEL W. MCROBB HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+//  UPDATES, ENHANCEMENTS, OR MODIFICATIONS. DANIEL W. MCROBB MAKES NO
+//  REPRESENTATIONS AND EXTENDS NO WARRANTIES OF ANY KIND, EITHER
+//  IMPLIED OR EXPRESS, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//  WARRANTIES OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE,
+//  OR THAT THE USE OF THIS SOFTWARE WILL NOT INFRINGE ANY PATENT,
+//  TRADEMARK OR OTHER RIGHTS.
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//!  \file TestWhatStrings.cc
+//!  \author Daniel W. McRobb
+//!  \brief Checks the what(1) strings in the dwmwhat binary.  Every
+//!    extra copy of an Info string (or of its "@(#)" prefix) that the
+//!    library or dwmwhat builds is an extra hit for everyone who scans
+//!    a program linked with libDwmPkg.
+//---------------------------------------------------------------------------
+
+extern "C" {
+  #include <unistd.h>
+}
+
+#include <cassert>
+#include <iostream>
+#include <string>
+
+#include "DwmPkgInfo.hh"
+#include "DwmPkgScanner.hh"
+
+//----------------------------------------------------------------------------
+//!  Returns the path of @c relPath, relative to the top of this source
+//!  tree.
+//----------------------------------------------------------------------------
+static std::string TreePath(const std::string & relPath)
+{
+  std::string  path(__FILE__);
+  auto  slash = path.find_last_of('/');
+  path = ((slash == std::string::npos)
+          ? std::string(".") : path.substr(0, slash));
+  return path + "/../../" + relPath;
+}
+
+//----------------------------------------------------------------------------
+//!  Scans the file at @c path.  Every hit must be our package string
+//!  (the library mustn't hold a bare "@(#)" of its own), and we return
+//!  the number of them.
+//----------------------------------------------------------------------------
+static size_t NumPkgs(const std::string & path)
+{
+  Dwm::Pkg::Scanner  scanner;
+  size_t             numPkgs = 0;
+  assert(scanner.ScanFile(path, [&] (const Dwm::Pkg::ScanHit & hit) {
+    assert(hit.info);
+    assert(hit.info->id == Dwm::Pkg::info.view());
+    ++numPkgs;
+    return true;
+  }));
+  return numPkgs;
+}
+
+//----------------------------------------------------------------------------
+//!  dwmwhat must hold exactly one libDwmPkg package string (-v and -V
+//!  print it from pieces, not from a copy) and nothing else.  The shared
+//!  library must hold nothing but its own package string.  Either is
+//!  skipped if it hasn't been built.
+//----------------------------------------------------------------------------
+static void TestBinaries()
+{
+  for (const auto & relPath : { "apps/dwmwhat/dwmwhat",
+                                "classes/lib/.libs/libDwmPkg.so" }) {
+    std::string  path = TreePath(relPath);
+    if (access(path.c_str(), R_OK) == 0) {
+      assert(NumPkgs(path) == 1);
+    }
+    else {
+      std::cout << "skipped " << relPath << '\n';
+    }
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------
+//!  
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  TestBinaries();
+  return 0;
+}
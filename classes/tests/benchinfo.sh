@@ -0,0 +1,90 @@
+#!/bin/sh
+#
+#  Compile-time benchmark for Dwm::Pkg::Info.  Generates TUS translation
+#  units, each defining INFOS Info objects with varied field lengths, and
+#  compiles them.  Reports wall clock compile time, total object size,
+#  the size of the emitted Info data and the number of distinct Info
+#  types.
+#
+#  usage: benchinfo.sh [-t tus] [-i infos] [-j jobs] [-k]
+#
+#  CXX and CXXFLAGS are taken from the environment (default c++ and
+#  -std=c++20 -O2).  -k keeps the generated sources and objects.
+#
+
+TUS=200
+INFOS=20
+JOBS=1
+KEEP=0
+while getopts "t:i:j:k" opt; do
+  case $opt in
+    t) TUS=$OPTARG ;;
+    i) INFOS=$OPTARG ;;
+    j) JOBS=$OPTARG ;;
+    k) KEEP=1 ;;
+    *) echo "usage: $0 [-t tus] [-i infos] [-j jobs] [-k]" 1>&2; exit 1 ;;
+  esac
+done
+
+CXX=${CXX:-c++}
+CXXFLAGS=${CXXFLAGS:--std=c++20 -O2}
+INCDIR=`cd \`dirname $0\`/../include && pwd`
+WORKDIR=`mktemp -d ${TMPDIR:-/tmp}/benchinfo.XXXXXX` || exit 1
+
+#  Use a generated DwmPkgInfo.hh if there is one, else make one from
+#  DwmPkgInfo.hh.in.
+mkdir -p ${WORKDIR}/include
+if [ ! -f ${INCDIR}/DwmPkgInfo.hh ]; then
+  sed -e 's/@DWM_PKG_STATUS@/DWM_PKG_STATUS_DEV/' \
+      -e 's/@DWM_VERSION@/0.0.0/' \
+      ${INCDIR}/DwmPkgInfo.hh.in > ${WORKDIR}/include/DwmPkgInfo.hh
+fi
+
+#  Field lengths vary with the TU and Info numbers, so most Info objects
+#  have a distinct combination of lengths (like a large code base).
+tu=0
+while [ $tu -lt $TUS ]; do
+  src=${WORKDIR}/tu${tu}.cc
+  {
+    echo '#include "DwmPkgInfo.hh"'
+    echo "namespace bench${tu} {"
+    i=0
+    while [ $i -lt $INFOS ]; do
+      n=$(( (tu * INFOS) + i ))
+      name=`printf "pkg%0$(( 1 + (n % 13) ))d" $n`
+      version="$(( n % 7 )).$(( n % 101 )).$(( n % 1009 ))"
+      copyright=`printf "Author %0$(( 1 + (n % 11) ))d" $tu`
+      other=`printf "%0$(( n % 17 ))d" 0 | tr 0 x`
+      echo "  inline constexpr const Dwm::Pkg::Info __attribute__((used))"
+      echo "  info${i}(DWM_PKG_TYPE_LIB, DWM_PKG_STATUS_REL, \"${name}\","
+      echo "           \"${version}\", \"${copyright}\", \"${other}\");"
+      i=$(( i + 1 ))
+    done
+    echo "}"
+  } > $src
+  tu=$(( tu + 1 ))
+done
+
+start=`date +%s.%N`
+ls ${WORKDIR}/tu*.cc | xargs -P ${JOBS} -n 1 sh -c \
+  "${CXX} ${CXXFLAGS} -I${WORKDIR}/include -I${INCDIR} -c \$0 -o \${0%.cc}.o" \
+  || { echo "compile failed, sources in ${WORKDIR}" 1>&2; exit 1; }
+end=`date +%s.%N`
+
+objBytes=`cat ${WORKDIR}/tu*.o | wc -c`
+infoBytes=`nm -S ${WORKDIR}/tu*.o 2>/dev/null \
+             | awk '$4 ~ /info[0-9]/ { sum += ("0x" $2) + 0 } END { print sum + 0 }'`
+
+echo "compiler:     ${CXX} ${CXXFLAGS}"
+echo "TUs:          ${TUS} x ${INFOS} Info objects"
+awk -v s=$start -v e=$end -v t=$TUS 'BEGIN {
+  printf("compile time: %.2f s (%.1f ms per TU)\n", e - s, (e - s) * 1000 / t)
+}'
+echo "object bytes: ${objBytes}"
+echo "Info bytes:   ${infoBytes}"
+
+if [ $KEEP -eq 0 ]; then
+  rm -rf ${WORKDIR}
+else
+  echo "kept:         ${WORKDIR}"
+fi